@@ -0,0 +1,109 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include "Geodesy.hpp"
+#include "RunningStats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct EpochColumns;
+
+/**
+ * @brief Position accuracy of a static receiver.
+ *
+ * Errors are ENU offsets (m) from the reference position: the surveyed
+ * one when given, otherwise the centroid of the fixes (precision only).
+ * Percentiles are nearest-rank: the smallest error with at least q of the
+ * epochs at or below it.
+ */
+struct AccuracyReport {
+    size_t epochs = 0;                  // fixes used
+    double meanEast = 0.0;              // bias against the reference
+    double meanNorth = 0.0;
+    double meanUp = 0.0;
+    double sigmaEast = 0.0;
+    double sigmaNorth = 0.0;
+    double sigmaUp = 0.0;
+    double cep50 = 0.0;                 // horizontal error percentiles
+    double cep95 = 0.0;
+    double drms = 0.0;                  // sqrt(mean(e^2 + n^2))
+    double twoDrms = 0.0;
+    double vertical50 = 0.0;            // |up| error percentiles
+    double vertical95 = 0.0;
+};
+
+/**
+ * @brief Accuracy statistics (CEP, 2DRMS, vertical percentiles) over
+ * epoch columns.
+ *
+ * Rows are converted to ENU with the batch Geodesy kernels and reduced in
+ * parallel; percentiles are exact, from a parallel histogram selection
+ * (see percentiles()).
+ */
+namespace Accuracy {
+
+    /// Reference position of a static receiver.
+    struct Reference {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        double altitude = 0.0;
+    };
+
+    /**
+     * @brief Accuracy of the fixes of @p columns around their centroid.
+     *
+     * @param fixQuality GGA fix quality to keep; 0 keeps every fix.
+     * @param threads Worker threads, 0 for hardware concurrency.
+     */
+    AccuracyReport compute(const EpochColumns &columns, uint8_t fixQuality = 0, unsigned threads = 0);
+
+    /// Accuracy of the fixes of @p columns around a surveyed @p reference.
+    AccuracyReport compute(const EpochColumns &columns, const Reference &reference,
+                           uint8_t fixQuality = 0, unsigned threads = 0);
+
+    /**
+     * @brief Exact nearest-rank percentiles of the finite @p values (NaN
+     * if there are none).
+     *
+     * NaN and infinite values are skipped: ranks count finite values only.
+     *
+     * Parallel selection: one pass builds per-thread histograms over
+     * [min, max], which locate the bin holding each requested rank; a
+     * second pass gathers the few values of those bins and nth_element
+     * finishes on them. O(n) with two parallel passes, values untouched.
+     */
+    std::vector<double> percentiles(const std::vector<double> &values, const std::vector<double> &quantiles,
+                                    unsigned threads = 0);
+};
+
+/**
+ * @brief Online accuracy statistics around a known reference.
+ *
+ * O(1) per fix in constant memory, for live acceptance runs. Moments are
+ * exact; CEP and vertical percentiles are P² estimates.
+ */
+class AccuracyStream {
+public:
+    explicit AccuracyStream(const Accuracy::Reference &reference, uint8_t fixQuality = 0);
+
+    /// Add one fix; epochs without a matching fix are ignored.
+    void add(const GNSSData &data);
+    void add(double latitude, double longitude, double altitude);
+
+    void reset();
+
+    /// Current statistics; percentiles are estimates.
+    AccuracyReport report() const;
+
+private:
+    Geodesy::ENUFrame m_frame;
+    uint8_t m_fixQuality;
+    RunningStats m_east;
+    RunningStats m_north;
+    RunningStats m_up;
+    double m_sumSquares = 0.0;
+    P2Quantile m_cep50{0.5};
+    P2Quantile m_cep95{0.95};
+    P2Quantile m_vertical50{0.5};
+    P2Quantile m_vertical95{0.95};
+};
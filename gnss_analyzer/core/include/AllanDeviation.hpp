@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+struct EpochColumns;
+
+/**
+ * @brief Allan deviation of one averaging time.
+ */
+struct AllanPoint {
+    double tau = 0.0;               // s
+    size_t factor = 0;              // tau / tau0
+    double adev = std::numeric_limits<double>::quiet_NaN();     // non-overlapping
+    double oadev = std::numeric_limits<double>::quiet_NaN();    // overlapping
+    size_t terms = 0;               // overlapping second differences used
+};
+
+/**
+ * @brief Allan and overlapping Allan deviation of a series of position samples.
+ *
+ * Samples are treated as the "frequency" series y: with x the cumulative
+ * sum of y, the mean of y over m samples is (x[i+m] - x[i]) / m, so
+ *
+ *     AVAR(m tau0) = sum (x[i+2m] - 2 x[i+m] + x[i])^2 / (2 m^2 terms)
+ *
+ * costs O(n) per averaging factor m whatever m is. The overlapping form
+ * takes every i; the non-overlapping one steps i by m.
+ *
+ * Series may have gaps. They are given as contiguous segments of
+ * [begin, end) indexes, and no second difference straddles two segments.
+ * Averaging factors are spread across threads; memory is the n + 1
+ * cumulative sums of the series being processed.
+ */
+namespace Allan {
+
+    using Segment = std::pair<size_t, size_t>;
+
+    /// Octave-spaced averaging factors 1, 2, 4, ... (@p perOctave per octave) that fit twice in @p samples.
+    std::vector<size_t> octaveFactors(size_t samples, int perOctave = 1);
+
+    /**
+     * @brief Deviation of @p y, sampled every @p tau0 seconds.
+     *
+     * @param segments Contiguous runs of @p y; empty means one run over all of it.
+     * @param threads Worker threads, 0 for hardware concurrency.
+     */
+    std::vector<AllanPoint> compute(const std::vector<double> &y, double tau0,
+                                    const std::vector<size_t> &factors,
+                                    const std::vector<Segment> &segments = {}, unsigned threads = 0);
+
+    /// Allan deviation of the ENU position of one receiver.
+    struct PositionDeviation {
+        double tau0 = 0.0;          // s, sampling interval
+        size_t epochs = 0;          // fixes used
+        size_t segments = 0;        // runs between gaps
+        std::vector<AllanPoint> east;
+        std::vector<AllanPoint> north;
+        std::vector<AllanPoint> up;
+    };
+
+    /**
+     * @brief Deviation of the ENU position (m) of the fixes of @p columns.
+     *
+     * ENU is taken around the first fix. tau0 is the median epoch interval;
+     * an interval off by more than half of it (gap, duplicate, lost fix)
+     * starts a new segment. Axes are processed one at a time so memory
+     * stays at one cumulative sum whatever the capture length.
+     *
+     * @param factors Averaging factors; empty for octaveFactors() of the longest segment.
+     * @param fixQuality GGA fix quality to keep; 0 keeps every fix.
+     */
+    PositionDeviation compute(const EpochColumns &columns, const std::vector<size_t> &factors = {},
+                              uint8_t fixQuality = 0, unsigned threads = 0);
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include "RollingWindow.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Cross-epoch anomalies flagged by AnomalyDetector.
+ */
+enum class AnomalyType : uint8_t
+{
+    PositionJump = 0,       // displacement beyond the allowed speed
+    AltitudeSpike = 1,
+    TimeGap = 2,
+    TimeDuplicate = 3,      // same GGA UTC time as the previous epoch
+    TimeBackwards = 4,
+    SatelliteCollapse = 5,  // GGA satellite count fell well below its recent level
+    SnrDrop = 6,            // one PRN's SNR fell well below its recent level
+};
+
+constexpr int kAnomalyTypes = 7;
+
+constexpr uint32_t anomalyBit(AnomalyType type)
+{
+    return 1u << static_cast<uint32_t>(type);
+}
+
+/**
+ * @brief Thresholds of AnomalyDetector.
+ *
+ * No check fires before its rolling window holds minSamples values.
+ */
+struct AnomalyDetectorConfig {
+    int minSamples = 5;
+
+    // Position: allowed jump = (speed * speedFactor + speedMargin) * dt + jumpSigmas * uere * hdop.
+    // speed is the one passed to update() (RMC/VTG, filter) or else the
+    // recent mean ground speed plus speedSigmas standard deviations.
+    double speedFactor = 1.5;
+    double speedMargin = 5.0;       // m/s, covers acceleration between epochs
+    double speedSigmas = 3.0;
+    double maxSpeed = 100.0;        // m/s, assumed before the speed window fills
+    double uere = 5.0;              // m per unit of HDOP
+    double jumpSigmas = 4.0;
+
+    // Altitude: deviation from the extrapolated recent vertical rate.
+    double altitudeSigmas = 5.0;
+    double altitudeMinSpike = 15.0; // m
+
+    // Time: interval above gapFactor times the recent mean interval.
+    double gapFactor = 2.5;
+
+    // Satellites: count below collapseRatio * recent mean, by at least collapseMinDrop.
+    double collapseRatio = 0.5;
+    double collapseMinDrop = 4.0;
+
+    // SNR: below the PRN's recent mean by snrDropDb; history is dropped
+    // after the PRN is missing from snrMaxMissing GSV sequences.
+    double snrDropDb = 10.0;
+    int snrMaxMissing = 5;
+
+    // Rejected positions, altitudes or times in a row before the detector
+    // accepts the new level (receiver relocated, clock reset).
+    int restartAfter = 3;
+};
+
+/**
+ * @brief Anomalies of one epoch.
+ *
+ * The detail fields are only meaningful when the matching flag is set.
+ */
+struct AnomalyReport {
+    uint32_t flags = 0;
+    double jumpMeters = 0.0;
+    double allowedJumpMeters = 0.0;
+    double altitudeDeviation = 0.0;     // m, signed
+    int64_t intervalMs = 0;             // time since the previous epoch
+    double satelliteLevel = 0.0;        // recent mean satellite count
+    std::vector<int> snrDrops;          // PRNs (NMEA numbering)
+
+    bool has(AnomalyType type) const { return (flags & anomalyBit(type)) != 0; }
+    bool any() const { return flags != 0; }
+
+    void clear()
+    {
+        flags = 0;
+        snrDrops.clear();
+    }
+};
+
+/**
+ * @brief Streaming cross-epoch consistency checks for one receiver.
+ *
+ * parseGGA range-checks single fields; this stage compares each epoch with
+ * the recent history of the same receiver: position jumps, altitude
+ * spikes, time gaps and duplicates, satellite-count collapses and per-PRN
+ * SNR drops. Histories are fixed-size RollingWindow ring buffers, so each
+ * epoch costs O(1) (O(satellites) for a GSV sequence) and, once every PRN
+ * has been seen, allocates nothing if the caller reuses its report.
+ *
+ * Outliers (jumps, spikes, bad times) are kept out of the history so that
+ * one bad fix is flagged once; restartAfter consecutive rejections are
+ * taken as a genuine change and restart that history. Collapses and SNR
+ * drops are level changes: the history follows them and the flag clears
+ * as the new level fills the window.
+ *
+ * parseGGA stamps the UTC time of day with the current date, so a step
+ * back of more than 12 h is read as a midnight rollover.
+ */
+class AnomalyDetector {
+public:
+    static constexpr size_t kWindow = 16;
+    static constexpr size_t kSnrWindow = 8;
+
+    explicit AnomalyDetector(const AnomalyDetectorConfig &config = AnomalyDetectorConfig());
+
+    /**
+     * @brief Check one parsed epoch (GGA fields and, if present, its GSV satellites).
+     *
+     * The satellites are checked only when satMap holds a new GSV sequence:
+     * the map fed on an earlier epoch (still shared with it) is skipped.
+     *
+     * @param speedMps Ground speed from RMC/VTG or a filter, NaN if unknown.
+     * @return true if any anomaly was flagged in @p report.
+     */
+    bool update(const GNSSData &data, AnomalyReport &report,
+                double speedMps = std::numeric_limits<double>::quiet_NaN());
+
+    /// GGA checks from column values; clears @p report first.
+    bool updateFix(int64_t timeMs, double latitude, double longitude, double altitude,
+                   double hdop, int satellites, uint8_t fixQuality, double speedMps,
+                   AnomalyReport &report);
+
+    /// SNR checks of one completed GSV sequence; adds to @p report.
+    bool updateSatellites(const QMap<int, SATInfo> &satMap, AnomalyReport &report);
+
+    void reset();
+
+    /// Number of epochs flagged with @p type since construction or reset().
+    uint64_t count(AnomalyType type) const { return m_counts[static_cast<size_t>(type)]; }
+
+private:
+    struct PrnHistory {
+        RollingWindow<kSnrWindow> snr;
+        uint64_t lastSequence = 0;
+    };
+
+    void flag(AnomalyReport &report, AnomalyType type);
+    void checkTime(int64_t timeMs, AnomalyReport &report);
+    void checkPosition(int64_t timeMs, double latitude, double longitude, double hdop,
+                       double speedMps, AnomalyReport &report);
+    void checkAltitude(int64_t timeMs, double altitude, AnomalyReport &report);
+    void checkSatellites(int satellites, AnomalyReport &report);
+
+    AnomalyDetectorConfig m_config;
+    std::array<uint64_t, kAnomalyTypes> m_counts{};
+
+    bool m_haveTime = false;
+    int64_t m_lastTimeMs = 0;
+    int m_timeRejects = 0;
+    RollingWindow<kWindow> m_intervals;
+
+    bool m_haveFix = false;
+    int64_t m_fixTimeMs = 0;
+    double m_latitude = 0.0;
+    double m_longitude = 0.0;
+    int m_positionRejects = 0;
+    RollingWindow<kWindow> m_speeds;
+
+    bool m_haveAltitude = false;
+    int64_t m_altitudeTimeMs = 0;
+    double m_altitude = 0.0;
+    int m_altitudeRejects = 0;
+    RollingWindow<kWindow> m_verticalRates;
+
+    RollingWindow<kWindow> m_satellites;
+
+    uint64_t m_sequence = 0;
+    std::unordered_map<int, PrnHistory> m_prns;
+    QMap<int, SATInfo> m_lastSatMap;        // last satMap fed by update(), shared with the caller's
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Error raised on archive/index I/O failures or malformed files.
+ */
+class ArchiveError : public std::runtime_error {
+public:
+    explicit ArchiveError(const std::string &msg) : std::runtime_error("ArchiveError: " + msg) {}
+};
@@ -0,0 +1,258 @@
+#pragma once
+#include "EpochRecord.hpp"
+#include "NMEAEpochContext.hpp"
+#include "NMEAFramer.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief C++20 coroutine ingest: one thread serving many NMEA sources.
+ *
+ * An EventLoop owns an epoll instance. Coroutines suspend on fd
+ * readability (co_await loop.readable(slot)) instead of blocking, so
+ * thousands of receiver sockets, pipes and files are multiplexed on the
+ * thread calling run(). NMEASource puts NMEAFramer and NMEAStreamParser
+ * behind a co_await-able nextEpoch().
+ *
+ * Linux only (epoll); built as the gnsscore_async library when the
+ * compiler supports C++20.
+ *
+ * @code
+ *   Ingest::Task<void> follow(Ingest::NMEASource &source)
+ *   {
+ *       while (const EpochRecord *epoch = co_await source.nextEpoch())
+ *           store(*epoch);
+ *   }
+ *   ...
+ *   loop.spawn(follow(source));
+ *   loop.run();
+ * @endcode
+ */
+namespace Ingest {
+
+    template <typename T>
+    class Task;
+
+    namespace detail {
+
+        struct PromiseBase {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+
+            struct FinalAwaiter {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) const noexcept
+                {
+                    // Symmetric transfer back to the awaiting coroutine
+                    const std::coroutine_handle<> next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase {
+            std::optional<T> value;
+
+            Task<T> get_return_object() noexcept;
+            void return_value(T v) { value.emplace(std::move(v)); }
+
+            T result()
+            {
+                if (error)
+                    std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase {
+            Task<void> get_return_object() noexcept;
+            void return_void() const noexcept {}
+
+            void result() const
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        };
+    };
+
+    /**
+     * @brief Lazy coroutine returning T: starts when awaited (or spawned),
+     * resumes its awaiter when done. Exceptions propagate to the awaiter.
+     */
+    template <typename T>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = detail::Promise<T>;
+
+        Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+        {
+            m_handle.promise().continuation = awaiter;
+            return m_handle;
+        }
+
+        T await_resume() { return m_handle.promise().result(); }
+
+    private:
+        friend promise_type;
+        explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    namespace detail {
+
+        template <typename T>
+        Task<T> Promise<T>::get_return_object() noexcept
+        {
+            return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> Promise<void>::get_return_object() noexcept
+        {
+            return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+    };
+
+    /**
+     * @brief Single-threaded scheduler over epoll.
+     *
+     * File descriptors are registered once (edge-triggered) and get a slot;
+     * readable(slot) suspends until data arrives, or completes at once when
+     * an edge came in since the last wait. Descriptors epoll refuses
+     * (regular files) are always readable. Not thread-safe: every call,
+     * and the coroutines, run on the thread of run().
+     */
+    class EventLoop {
+    public:
+        EventLoop();
+        ~EventLoop();
+        EventLoop(const EventLoop &) = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        /// Register @p fd (made non-blocking); the returned slot is used with readable().
+        size_t add(int fd);
+
+        /// Unregister a slot; a coroutine still waiting on it is never resumed.
+        void remove(size_t slot);
+
+        /// False for descriptors epoll cannot watch (regular files).
+        bool pollable(size_t slot) const { return m_slots[slot].pollable; }
+
+        struct ReadableAwaiter {
+            EventLoop &loop;
+            size_t slot;
+
+            bool await_ready() const noexcept;
+            void await_suspend(std::coroutine_handle<> h) noexcept;
+            void await_resume() const noexcept {}
+        };
+
+        struct YieldAwaiter {
+            EventLoop &loop;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { loop.m_ready.push_back(h); }
+            void await_resume() const noexcept {}
+        };
+
+        ReadableAwaiter readable(size_t slot) { return ReadableAwaiter{*this, slot}; }
+
+        /// Let the other ready coroutines run before continuing.
+        YieldAwaiter yield() { return YieldAwaiter{*this}; }
+
+        /// Start @p task; it runs until its first suspension before spawn() returns.
+        void spawn(Task<void> task);
+
+        /**
+         * @brief Resume coroutines as their descriptors become readable
+         * until every spawned task has finished.
+         * @throws the first exception that escaped a spawned task.
+         */
+        void run();
+
+        size_t activeTasks() const { return m_active; }
+
+    private:
+        struct Slot {
+            int fd = -1;
+            std::coroutine_handle<> waiter;
+            bool ready = false;         // edge received with nobody waiting
+            bool pollable = true;
+            bool used = false;
+        };
+
+        void rethrow();
+
+        int m_epoll = -1;
+        std::vector<Slot> m_slots;
+        std::vector<size_t> m_freeSlots;
+        std::deque<std::coroutine_handle<>> m_ready;
+        size_t m_active = 0;
+        std::exception_ptr m_error;
+    };
+
+    /**
+     * @brief NMEA stream of one receiver on a socket, pipe, serial device
+     * or file descriptor (not owned, registered with the loop).
+     *
+     * Every GGA ends an epoch: nextEpoch() returns the record updated by it,
+     * carrying the satellites of the last complete GSV sequence. Epochs are
+     * assembled in an NMEAEpochContext; lines that fail the parser checks
+     * are counted there and skipped.
+     */
+    class NMEASource {
+    public:
+        NMEASource(EventLoop &loop, int fd, size_t readSize = 16384);
+        ~NMEASource();
+        NMEASource(const NMEASource &) = delete;
+        NMEASource &operator=(const NMEASource &) = delete;
+
+        /// Next epoch, nullptr at end of stream; valid until the next call.
+        Task<const EpochRecord *> nextEpoch();
+
+        NMEAStreamParser &parser() { return m_context.parser(); }
+        const NMEAEpochContext &context() const { return m_context; }
+        const NMEAFramer &framer() const { return m_framer; }
+        uint64_t rejectedLines() const { return m_context.rejectedLines(); }
+        uint64_t bytesRead() const { return m_bytes; }
+
+    private:
+        EventLoop &m_loop;
+        size_t m_slot;
+        int m_fd;
+        size_t m_readSize;
+        NMEAFramer m_framer;
+        NMEAEpochContext m_context;
+        uint64_t m_bytes = 0;
+        uint64_t m_reads = 0;
+        bool m_eof = false;
+    };
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include "NMEAEpochContext.hpp"
+#include "NMEAFramer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+struct BatchLogReaderConfig {
+    unsigned queueDepth = 64;           // reads in flight, one registered buffer each
+    size_t blockSize = 64 * 1024;       // bytes per read
+    size_t maxLineLength = 1024;
+    bool usePread = false;              // skip io_uring even when the kernel has it
+};
+
+/**
+ * @brief Replays many NMEA logs or serial devices at once through io_uring.
+ *
+ * Every source gets one read in flight at a time (a stream must stay in
+ * order for its framer); reads of different sources are submitted and
+ * reaped together, queueDepth at a time, with one io_uring_enter per batch.
+ * Reads go to buffers registered with the kernel (IORING_OP_READ_FIXED), and
+ * each completion is handed to the source's NMEAFramer and NMEAEpochContext.
+ * The handler is called after each GGA with the source whose epoch
+ * completed (context.epoch()), as with NMEAListener.
+ *
+ * Without io_uring (old kernel, seccomp, io_uring_disabled) or with
+ * usePread, sources are read in turn with pread(), or read() for
+ * descriptors that cannot seek; a device with no data then blocks the loop.
+ *
+ * Linux only; part of gnsscore_async. Descriptors are not owned.
+ */
+namespace Ingest {
+
+    class BatchLogReader {
+    public:
+        struct Source {
+            size_t id = 0;
+            int fd = -1;
+            bool seekable = true;
+            bool finished = false;
+            int error = 0;                  // errno of a failed read, which ends the source
+            uint64_t offset = 0;            // next read position of a seekable source
+            NMEAEpochContext context;
+            uint64_t sentences = 0;
+            uint64_t bytes = 0;
+            NMEAFramer framer;
+
+            explicit Source(size_t maxLineLength) : framer(maxLineLength) {}
+        };
+
+        using EpochHandler = std::function<void(Source &source)>;
+
+        explicit BatchLogReader(EpochHandler onEpoch, const BatchLogReaderConfig &config = BatchLogReaderConfig());
+        ~BatchLogReader();
+        BatchLogReader(const BatchLogReader &) = delete;
+        BatchLogReader &operator=(const BatchLogReader &) = delete;
+
+        /// Read @p fd from its current position to its end; returns the source id.
+        size_t add(int fd);
+
+        /// Read every source to its end (or error).
+        void run();
+
+        /// True when reads go through io_uring, false with the pread fallback.
+        bool usingIoUring() const { return m_ring != nullptr; }
+
+        size_t sourceCount() const { return m_sources.size(); }
+        const Source &source(size_t id) const { return *m_sources[id]; }
+
+        /// ParseStats counters of every source; zeros without GNSS_PARSE_STATS.
+        ParseCounters parseCounters() const;
+
+        /// io_uring_enter calls, or pread/read calls with the fallback.
+        uint64_t systemCalls() const { return m_systemCalls; }
+        uint64_t bytesRead() const { return m_bytes; }
+
+    private:
+        struct Ring;
+
+        void parse(Source &source, std::string_view line);
+        void consume(Source &source, const char *data, size_t length);
+        void finish(Source &source);
+        void runPread();
+        void runRing();
+
+        BatchLogReaderConfig m_config;
+        EpochHandler m_onEpoch;
+        std::vector<std::unique_ptr<Source>> m_sources;
+        std::unique_ptr<Ring> m_ring;
+        uint64_t m_systemCalls = 0;
+        uint64_t m_bytes = 0;
+    };
+};
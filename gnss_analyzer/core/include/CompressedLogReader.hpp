@@ -0,0 +1,109 @@
+#pragma once
+#include "ArchiveError.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GNSSData;
+
+/**
+ * @brief Line reader over plain, gzip or zstd compressed NMEA logs.
+ *
+ * A producer thread reads and decompresses the file into a fixed pool of
+ * chunk buffers while the caller consumes lines from filled chunks, so
+ * decompression overlaps parsing and nothing is written to disk. Memory
+ * use is bounded by chunkSize * chunkCount plus the longest line.
+ *
+ * zstd is only available when the library was built with GNSS_HAVE_ZSTD.
+ */
+class CompressedLogReader {
+public:
+    enum class Compression
+    {
+        Auto,
+        None,
+        Gzip,
+        Zstd,
+    };
+
+    explicit CompressedLogReader(const std::string &path, Compression compression = Compression::Auto,
+                                 size_t chunkSize = 256 * 1024, size_t chunkCount = 4);
+    ~CompressedLogReader();
+
+    CompressedLogReader(const CompressedLogReader &) = delete;
+    CompressedLogReader &operator=(const CompressedLogReader &) = delete;
+
+    /**
+     * @brief Next line, without its CR/LF terminator.
+     *
+     * The view stays valid until the next call.
+     *
+     * @return false at end of stream.
+     * @throws ArchiveError on I/O or decompression failure.
+     */
+    bool nextLine(const char *&line, size_t &length);
+
+    Compression compression() const { return m_compression; }
+
+    /// Compression of @p path from its magic bytes.
+    static Compression detect(const std::string &path);
+
+private:
+    struct Chunk {
+        std::vector<char> data;
+        size_t size = 0;
+    };
+
+    void produce();
+    void inflateGzip(std::FILE *file);
+    void inflateZstd(std::FILE *file);
+    void copyPlain(std::FILE *file);
+
+    // Producer side
+    Chunk *acquireFree();
+    void publish(Chunk *chunk);
+
+    // Consumer side
+    bool acquireReady();
+    void releaseCurrent();
+
+    std::string m_path;
+    Compression m_compression;
+    size_t m_chunkSize;
+
+    std::vector<Chunk> m_chunks;
+    std::deque<Chunk *> m_free;
+    std::deque<Chunk *> m_ready;
+    std::mutex m_mutex;
+    std::condition_variable m_freeCond;
+    std::condition_variable m_readyCond;
+    bool m_finished = false;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+    std::thread m_producer;
+
+    Chunk *m_current = nullptr;
+    size_t m_pos = 0;
+    std::string m_carry;
+};
+
+namespace NMEAParser {
+
+    /**
+     * @brief Parse a whole (possibly compressed) log with parseLine().
+     *
+     * @p onEpoch is called after every GGA with the accumulated @p data.
+     * Malformed sentences are skipped.
+     *
+     * @return number of epochs delivered.
+     */
+    size_t parseCompressedLog(const std::string &path, GNSSData &data,
+                              const std::function<void(const GNSSData &)> &onEpoch);
+};
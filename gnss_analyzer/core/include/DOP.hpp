@@ -0,0 +1,75 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+struct EpochColumns;
+
+/**
+ * @brief Dilution of precision of one satellite geometry.
+ *
+ * Values are NaN when the geometry does not support a solution (fewer
+ * than four satellites or a singular normal matrix); valid is false then.
+ */
+struct DOPValues {
+    double gdop = 0.0;
+    double pdop = 0.0;
+    double hdop = 0.0;
+    double vdop = 0.0;
+    double tdop = 0.0;
+    int satellites = 0;     // satellites in the geometry
+    bool valid = false;
+};
+
+/**
+ * @brief DOP from satellite elevation/azimuth (GSV geometry).
+ *
+ * Each satellite contributes a row [e, n, u, 1] of line-of-sight unit
+ * vectors in the local ENU frame, and DOP is read from the diagonal of
+ * (H^T H)^-1. The 4x4 inversion is a straight-line cofactor expansion of
+ * the symmetric normal matrix, with no pivoting and no branches, so the
+ * batch path inverts whole columns of epochs in vectorized loops.
+ *
+ * A single receiver clock is assumed: multi-constellation epochs are
+ * treated as one system, as receivers that report a single HDOP do.
+ * Satellites without a valid elevation/azimuth (-inf in SATInfo) or below
+ * the elevation mask are ignored.
+ */
+namespace DOP {
+
+    /// DOP of @p satMap, leaving out the satellites listed in @p excluded.
+    DOPValues compute(const QMap<int, SATInfo> &satMap, double elevationMaskDeg = 0.0,
+                      const std::vector<int> &excluded = {});
+
+    /// DOP of every epoch of @p columns; @p out is resized to columns.size().
+    void compute(const EpochColumns &columns, std::vector<DOPValues> &out, double elevationMaskDeg = 0.0);
+
+    /**
+     * @brief What-if: DOP with each satellite of the geometry removed in turn.
+     *
+     * The normal matrix is built once; each entry only subtracts one
+     * satellite's contribution and re-inverts. Pairs are (satellite ID,
+     * DOP without it), in ascending ID order.
+     */
+    std::vector<std::pair<int, DOPValues>> leaveOneOut(const QMap<int, SATInfo> &satMap,
+                                                       double elevationMaskDeg = 0.0);
+
+    /// Compute the DOP of @p data's satellites and store the VDOP in data.vdop.
+    DOPValues apply(GNSSData &data, double elevationMaskDeg = 0.0);
+
+    /// Fill the vdop column of @p columns from each epoch's geometry.
+    void apply(EpochColumns &columns, double elevationMaskDeg = 0.0);
+
+    /**
+     * @brief Cross-check a receiver-reported HDOP against the geometry.
+     *
+     * Receivers compute HDOP over the satellites used in the fix (a subset
+     * of those in view), so the reported value should not be noticeably
+     * below the all-in-view HDOP. Returns true when @p reportedHdop is more
+     * than @p tolerance (relative) below @p computed, or when it is more
+     * than @p maxRatio times larger.
+     */
+    bool hdopMismatch(double reportedHdop, const DOPValues &computed,
+                      double tolerance = 0.1, double maxRatio = 3.0);
+};
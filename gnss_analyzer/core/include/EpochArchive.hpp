@@ -0,0 +1,165 @@
+#pragma once
+#include "ArchiveError.hpp"
+#include "EpochColumns.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct GNSSData;
+
+/**
+ * @brief Columnar on-disk epoch archive (.gea).
+ *
+ * Layout (native little-endian):
+ *
+ *   FileHeader                         64 bytes
+ *   block 0 .. block N-1               columns, each 8-byte aligned
+ *   BlockIndexEntry[N]                 time index, at header.indexOffset
+ *
+ * A block of n epochs and m satellite rows stores, in order:
+ *   int64 timeMs[n], double latitude[n], longitude[n], altitude[n],
+ *   hdop[n], vdop[n], snrAvg[n], uint8 satellites[n], uint8 fixQuality[n],
+ *   uint32 satOffset[n + 1] (block-relative), int32 satId[m],
+ *   float elevation[m], azimuth[m], snr[m]
+ *
+ * Every column has a fixed width, so a reader maps the file and points
+ * straight into it without decoding.
+ */
+namespace EpochArchive {
+
+    constexpr char kMagic[8] = {'G', 'N', 'S', 'S', 'E', 'P', 'A', '1'};
+    constexpr uint32_t kVersion = 1;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t blockCapacity;
+        uint64_t epochCount;
+        uint64_t blockCount;
+        uint64_t indexOffset;
+        uint8_t reserved[24];
+    };
+    static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+
+    struct BlockIndexEntry {
+        int64_t firstTimeMs;
+        int64_t lastTimeMs;
+        uint64_t offset;
+        uint64_t firstEpoch;
+        uint32_t epochCount;
+        uint32_t satCount;
+    };
+    static_assert(sizeof(BlockIndexEntry) == 40, "BlockIndexEntry layout");
+
+    /// Size in bytes of a block holding @p epochs epochs and @p sats satellite rows.
+    size_t blockSize(size_t epochs, size_t sats);
+};
+
+/**
+ * @brief Zero-copy view of one archive block.
+ *
+ * Pointers reference the mapped file and stay valid while the reader is open.
+ */
+struct EpochBlockView {
+    size_t count = 0;
+    size_t satCount = 0;
+    uint64_t firstEpoch = 0;
+
+    const int64_t *timeMs = nullptr;
+    const double *latitude = nullptr;
+    const double *longitude = nullptr;
+    const double *altitude = nullptr;
+    const double *hdop = nullptr;
+    const double *vdop = nullptr;
+    const double *snrAvg = nullptr;
+    const uint8_t *satellites = nullptr;
+    const uint8_t *fixQuality = nullptr;
+
+    const uint32_t *satOffset = nullptr;
+    const int32_t *satId = nullptr;
+    const float *elevation = nullptr;
+    const float *azimuth = nullptr;
+    const float *snr = nullptr;
+};
+
+/**
+ * @brief Streams epochs into a columnar archive, one block at a time.
+ *
+ * Epochs must be appended in non-decreasing time order: the block index
+ * relies on it. close() (or the destructor) writes the index and header.
+ */
+class EpochArchiveWriter {
+public:
+    explicit EpochArchiveWriter(const std::string &path, uint32_t blockCapacity = 4096);
+    ~EpochArchiveWriter();
+
+    EpochArchiveWriter(const EpochArchiveWriter &) = delete;
+    EpochArchiveWriter &operator=(const EpochArchiveWriter &) = delete;
+
+    void append(const GNSSData &data);
+    void append(const EpochColumns &columns);
+    void close();
+
+    uint64_t epochCount() const { return m_epochCount; }
+
+private:
+    void checkOrder(int64_t timeMs);
+    void flushBlock();
+
+    std::ofstream m_out;
+    uint32_t m_blockCapacity;
+    EpochColumns m_pending;
+    std::vector<EpochArchive::BlockIndexEntry> m_index;
+    std::vector<char> m_scratch;
+    uint64_t m_offset = 0;
+    uint64_t m_epochCount = 0;
+    int64_t m_lastTimeMs = INT64_MIN;
+    bool m_open = false;
+};
+
+/**
+ * @brief Memory-mapped reader over an archive written by EpochArchiveWriter.
+ *
+ * Opening validates the header and index only; columns are paged in by the
+ * OS when first touched.
+ */
+class EpochArchiveReader {
+public:
+    EpochArchiveReader() = default;
+    explicit EpochArchiveReader(const std::string &path) { open(path); }
+    ~EpochArchiveReader();
+
+    EpochArchiveReader(const EpochArchiveReader &) = delete;
+    EpochArchiveReader &operator=(const EpochArchiveReader &) = delete;
+
+    void open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    uint64_t epochCount() const { return m_header ? m_header->epochCount : 0; }
+    size_t blockCount() const { return m_blockCount; }
+    const EpochArchive::BlockIndexEntry &indexEntry(size_t block) const { return m_index[block]; }
+
+    EpochBlockView block(size_t i) const;
+
+    /// First block whose last epoch is at or after @p timeMs (blockCount() if none).
+    size_t findBlock(int64_t timeMs) const;
+
+    /// Global index of the first epoch at or after @p timeMs (epochCount() if none).
+    uint64_t lowerBound(int64_t timeMs) const;
+
+    /// Copy epochs [first, last) into columns.
+    void read(uint64_t first, uint64_t last, EpochColumns &out) const;
+
+    /// Rebuild the GNSSData of global epoch @p i.
+    void get(uint64_t i, GNSSData &data) const;
+
+private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+    const EpochArchive::FileHeader *m_header = nullptr;
+    const EpochArchive::BlockIndexEntry *m_index = nullptr;
+    size_t m_blockCount = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @brief Monotonic memory resource for the data of one epoch.
+ *
+ * Allocation bumps a pointer; deallocation does nothing. reset() rewinds
+ * to the start without returning memory, so once the arena has grown to
+ * the size of a typical epoch, later epochs do not call malloc at all.
+ * When an epoch needed more than one block, reset() replaces them by a
+ * single block of their total size.
+ *
+ * Not thread-safe; one arena per parser context.
+ */
+class EpochArena : public std::pmr::memory_resource {
+public:
+    explicit EpochArena(size_t initialSize = 16 * 1024);
+    EpochArena(const EpochArena &) = delete;
+    EpochArena &operator=(const EpochArena &) = delete;
+
+    /// Free everything allocated since the last reset; memory is kept.
+    void reset();
+
+    size_t used() const { return m_used; }
+    size_t capacity() const { return m_capacity; }
+
+    /// Blocks obtained from the global allocator since construction.
+    uint64_t blockAllocations() const { return m_blockAllocations; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    void addBlock(size_t size);
+
+    std::vector<Block> m_blocks;
+    size_t m_current = 0;       // block being filled
+    size_t m_offset = 0;        // first free byte of the current block
+    size_t m_used = 0;
+    size_t m_capacity = 0;
+    uint64_t m_blockAllocations = 0;
+};
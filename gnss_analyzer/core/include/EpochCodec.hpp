@@ -0,0 +1,44 @@
+#pragma once
+#include "EpochColumns.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compact codec for epoch time series, in the spirit of Gorilla.
+ *
+ * Epochs are cut into blocks of kBlockSize. Within a block every column is
+ * stored as its first value (zigzag varint) followed by zigzag residuals
+ * bit-packed at a single width chosen for that block:
+ *
+ *   timeMs                         delta-of-delta (a steady rate costs 0 bits)
+ *   latitude, longitude            delta of 1e-7 degree fixed point
+ *   altitude                       delta of millimeters
+ *   hdop, vdop, snrAvg             delta of hundredths
+ *   satellites, fixQuality         delta
+ *
+ * Fixed-width residuals make decoding a branch-free unpack followed by a
+ * prefix sum, which compilers vectorize. The coordinate quantization is
+ * lossy (about 1 cm); satellite rows are not encoded.
+ */
+namespace EpochCodec {
+
+    constexpr size_t kBlockSize = 128;
+    constexpr double kDegreeScale = 1e7;
+    constexpr double kAltitudeScale = 1e3;
+    constexpr double kRatioScale = 1e2;
+
+    /// Append the encoding of @p columns to @p out.
+    void encode(const EpochColumns &columns, std::vector<uint8_t> &out);
+
+    std::vector<uint8_t> encode(const EpochColumns &columns);
+
+    /**
+     * @brief Decode a stream produced by encode(), appending to @p out.
+     *
+     * Decoded epochs have no satellite rows.
+     *
+     * @throws ArchiveError if the stream is truncated or malformed.
+     */
+    void decode(const uint8_t *data, size_t size, EpochColumns &out);
+};
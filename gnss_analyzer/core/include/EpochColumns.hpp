@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct EpochRecord;
+
+/**
+ * @brief Column-oriented (structure of arrays) storage of parsed epochs.
+ *
+ * Epoch i is timeMs[i], latitude[i], ... The satellites of epoch i are the
+ * rows [satOffset[i], satOffset[i + 1]) of the satellite columns, in
+ * ascending satellite ID like EpochRecord::satellitesInView. Timestamps
+ * are UTC milliseconds since the Unix epoch and fixQuality is the GGA code.
+ *
+ * Part of gnsscore_std; QtAdapter appends and rebuilds GNSSData epochs.
+ */
+struct EpochColumns {
+    std::vector<int64_t> timeMs;
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<double> altitude;
+    std::vector<double> hdop;
+    std::vector<double> vdop;
+    std::vector<double> snrAvg;
+    std::vector<uint8_t> satellites;
+    std::vector<uint8_t> fixQuality;
+
+    std::vector<uint64_t> satOffset = {0};
+    std::vector<int32_t> satId;
+    std::vector<float> elevation;
+    std::vector<float> azimuth;
+    std::vector<float> snr;
+
+    size_t size() const { return timeMs.size(); }
+    size_t satelliteCount() const { return satId.size(); }
+
+    void clear();
+    void reserve(size_t epochs, size_t satellitesPerEpoch = 0);
+
+    /// Append one parsed epoch.
+    void append(const EpochRecord &record);
+
+    /// Append epoch @p i of @p other.
+    void append(const EpochColumns &other, size_t i);
+
+    /// Rebuild an EpochRecord from epoch @p i.
+    void get(size_t i, EpochRecord &record) const;
+};
@@ -0,0 +1,178 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Recycling pool for epochs (GNSSData, EpochRecord) published by a
+ * parser to consumers on other threads.
+ *
+ * The producing thread acquire()s an epoch, copies its working record into
+ * it and passes the Handle on. The copy reuses the pooled epoch's
+ * containers, so in steady state it does not allocate; moving the Handle
+ * afterwards is a pointer move. When the consumer drops the Handle, on any
+ * thread, the epoch goes back on a lock-free list for the producer to take
+ * again. NMEAListener::publish() is this path for the listener's receivers.
+ *
+ * Returned epochs are pushed on an atomic stack (one CAS per release). The
+ * producer takes the whole stack at once with an exchange, when its
+ * private free list is empty. There is no pop on the shared stack, so it
+ * has no ABA problem.
+ *
+ * The epochs and the stack live in a block shared by the pool and its
+ * outstanding handles (one atomic count per acquire and per release). A
+ * pool may therefore be destroyed before its handles: the last handle
+ * released frees the epochs.
+ *
+ * acquire() is for the owning thread only. A Handle may be released on any
+ * thread.
+ *
+ * @code
+ *   EpochPool<EpochRecord> pool;
+ *   ...
+ *   if (context.parse(line))
+ *   {
+ *       EpochPool<EpochRecord>::Handle epoch = pool.acquire();
+ *       *epoch = context.epoch();           // reuses the satellite capacity
+ *       queue.push(std::move(epoch));
+ *   }
+ * @endcode
+ */
+template <typename T>
+class EpochPool {
+    struct Shared;
+
+    struct Node {
+        T value;
+        Node *next = nullptr;
+        Shared *shared = nullptr;
+    };
+
+    struct Shared {
+        std::atomic<Node *> returned{nullptr};      // pushed by any thread
+        std::atomic<size_t> references{1};         // the pool and each outstanding handle
+        std::vector<std::unique_ptr<Node>> nodes;   // grown by the owner thread only
+
+        void release(Node *node) noexcept
+        {
+            Node *head = returned.load(std::memory_order_relaxed);
+            do
+            {
+                node->next = head;
+            } while (!returned.compare_exchange_weak(head, node, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+            unreference();
+        }
+
+        void unreference() noexcept
+        {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+    };
+
+public:
+    /// Owner of one pooled epoch; returns it to the pool when destroyed or reset.
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(Handle &&other) noexcept : m_node(std::exchange(other.m_node, nullptr)) {}
+        Handle &operator=(Handle &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                m_node = std::exchange(other.m_node, nullptr);
+            }
+            return *this;
+        }
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+        ~Handle() { reset(); }
+
+        void reset() noexcept
+        {
+            if (m_node)
+                m_node->shared->release(std::exchange(m_node, nullptr));
+        }
+
+        T *get() const { return m_node ? &m_node->value : nullptr; }
+        T &operator*() const { return m_node->value; }
+        T *operator->() const { return &m_node->value; }
+        explicit operator bool() const { return m_node != nullptr; }
+
+    private:
+        friend class EpochPool;
+        explicit Handle(Node *node) : m_node(node) {}
+
+        Node *m_node = nullptr;
+    };
+
+    explicit EpochPool(size_t preallocate = 0)
+        : m_shared(new Shared)
+    {
+        for (size_t i = 0; i < preallocate; ++i)
+        {
+            Node *node = newNode();
+            node->next = m_free;
+            m_free = node;
+        }
+    }
+
+    EpochPool(const EpochPool &) = delete;
+    EpochPool &operator=(const EpochPool &) = delete;
+
+    ~EpochPool() { m_shared->unreference(); }
+
+    /// A recycled epoch (previous contents kept), or a new one when none was returned.
+    Handle acquire()
+    {
+        if (!m_free)
+            m_free = m_shared->returned.exchange(nullptr, std::memory_order_acquire);
+        Node *node = m_free;
+        if (node)
+        {
+            m_free = node->next;
+            ++m_reused;
+        }
+        else
+        {
+            node = newNode();
+        }
+        m_shared->references.fetch_add(1, std::memory_order_relaxed);
+        return Handle(node);
+    }
+
+    /// Epochs created so far; stays flat in steady state.
+    size_t allocated() const { return m_shared->nodes.size(); }
+
+    /// acquire() calls served from returned epochs.
+    uint64_t reused() const { return m_reused; }
+
+    /// Epochs not held by a Handle (owner thread; returns in flight may be missed).
+    size_t available() const
+    {
+        size_t count = 0;
+        for (const Node *node = m_free; node; node = node->next)
+            ++count;
+        for (const Node *node = m_shared->returned.load(std::memory_order_acquire); node; node = node->next)
+            ++count;
+        return count;
+    }
+
+private:
+    Node *newNode()
+    {
+        m_shared->nodes.push_back(std::make_unique<Node>());
+        Node *node = m_shared->nodes.back().get();
+        node->shared = m_shared;
+        return node;
+    }
+
+    Shared *m_shared;
+    Node *m_free = nullptr;                      // owner thread only
+    uint64_t m_reused = 0;
+};
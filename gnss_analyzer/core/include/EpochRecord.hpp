@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+enum class DATAType : short
+{
+    Unknown = 0,
+    GGA = 1,
+    GSV = 2,
+};
+
+/**
+ * @brief Standard C++ counterparts of GNSSData and SATInfo, used by the
+ * Qt-free gnsscore_std library (NMEAStreamParser, EpochColumns).
+ *
+ * Satellites are a flat array sorted by ID instead of a QMap, the fix is
+ * the GGA quality code instead of a label and the time is a system_clock
+ * time point (UTC, millisecond resolution) instead of a QDateTime.
+ * QtAdapter converts to and from GNSSData.
+ *
+ * EpochRecord is allocator-aware: the satellite list can live in an
+ * EpochArena (see NMEAEpochContext). Copies use the default resource
+ * unless an allocator is given; a moved record keeps its resource.
+ */
+using EpochTime = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>;
+
+struct SatelliteRecord {
+    int32_t id = 0;
+    double elevation = 0.0;         // deg, -inf when the field is empty
+    double azimuth = 0.0;           // deg, -inf when the field is empty
+    double snr = 0.0;               // dB-Hz, -inf when not tracked
+};
+
+using SatelliteList = std::pmr::vector<SatelliteRecord>;
+
+struct EpochRecord {
+    using allocator_type = std::pmr::polymorphic_allocator<SatelliteRecord>;
+
+    EpochRecord() = default;
+    explicit EpochRecord(const allocator_type &allocator) : satellitesInView(allocator) {}
+    EpochRecord(const EpochRecord &other, const allocator_type &allocator);
+    EpochRecord(const EpochRecord &) = default;
+    EpochRecord(EpochRecord &&) = default;
+    EpochRecord &operator=(const EpochRecord &) = default;
+    EpochRecord &operator=(EpochRecord &&) = default;
+
+    EpochTime time{};
+    bool hasTime = false;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double altitude = 0.0;
+    double hdop = 0.0;
+    double vdop = 0.0;
+    double snrAvg = 0.0;
+    uint8_t satellites = 0;
+    uint8_t fixQuality = 0;         // GGA code: 0 none, 1 GPS, 2 DGPS, 4 RTK
+    SatelliteList satellitesInView;     // ascending ID
+
+    /// UTC milliseconds since the Unix epoch, 0 without a time.
+    int64_t timeMs() const { return hasTime ? time.time_since_epoch().count() : 0; }
+};
+
+/**
+ * @brief Label of a GGA fix quality code, same text as fixTypeLabel().
+ */
+const char *fixQualityName(uint8_t fixQuality);
+
+/**
+ * @brief Mean SNR (dB-Hz) of the tracked satellites (SNR > 0), 0 if none.
+ */
+double averageSnr(const SatelliteList &satellites);
+
+/**
+ * @brief averageSnr() over any range of satellites with an @c snr member
+ * (SatelliteList, QMap<int, SATInfo>).
+ */
+template <typename Satellites>
+double averageTrackedSnr(const Satellites &satellites)
+{
+    double sum = 0.0;
+    int tracked = 0;
+    for (const auto &satellite : satellites)
+    {
+        // Untracked satellites have an empty SNR field (-inf) or 0
+        if (satellite.snr > 0.0)
+        {
+            sum += satellite.snr;
+            ++tracked;
+        }
+    }
+    return tracked > 0 ? sum / tracked : 0.0;
+}
@@ -2,13 +2,8 @@
 #include <QDateTime>
 #include <QString>
 #include <QMap>
-
-enum class DATAType : short
-{
-    Unknown = 0,
-    GGA = 1,
-    GSV = 2,
-};
+#include <cstdint>
+#include "EpochRecord.hpp"
 
 struct SATInfo{
     double elevation;
@@ -27,4 +22,19 @@ struct GNSSData {
     QMap <int, SATInfo> satMap;
     QString fixType = "No fix";
     QDateTime timestamp;   
-};
\ No newline at end of file
+};
+
+/**
+ * @brief GGA fix quality code (field 6) for a fixType label, 0 if unknown.
+ */
+uint8_t fixQualityCode(const QString &fixType);
+
+/**
+ * @brief fixType label produced by parseGGA for a fix quality code.
+ */
+QString fixTypeLabel(uint8_t fixQuality);
+
+/**
+ * @brief Mean SNR (dB-Hz) of the tracked satellites (SNR > 0), 0 if none.
+ */
+double averageSnr(const QMap<int, SATInfo> &satMap);
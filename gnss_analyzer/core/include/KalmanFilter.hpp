@@ -0,0 +1,63 @@
+#pragma once
+#include "Matrix.hpp"
+
+/**
+ * @brief Linear Kalman filter with @p N states and @p M measurements.
+ *
+ * All matrices are fixed-size, so predict() and update() never allocate.
+ * The model matrices are passed per step because they usually depend on
+ * the time step (F, Q) or on the measurement quality (R).
+ */
+template <int N, int M>
+class KalmanFilter {
+public:
+    using State = Matrix<N, 1>;
+    using Covariance = Matrix<N, N>;
+    using Measurement = Matrix<M, 1>;
+    using MeasurementModel = Matrix<M, N>;
+    using MeasurementNoise = Matrix<M, M>;
+
+    void init(const State &x, const Covariance &p)
+    {
+        m_x = x;
+        m_p = p;
+    }
+
+    /// x = F x, P = F P F^T + Q
+    void predict(const Covariance &f, const Covariance &q)
+    {
+        m_x = f * m_x;
+        m_p = f * m_p * f.transposed() + q;
+    }
+
+    /**
+     * @brief Measurement update with z = H x + v, v ~ N(0, R).
+     *
+     * @return false if the innovation covariance is not positive definite
+     * (the state is left unchanged).
+     */
+    bool update(const Measurement &z, const MeasurementModel &h, const MeasurementNoise &r)
+    {
+        const Matrix<N, M> pht = m_p * h.transposed();
+        const MeasurementNoise s = h * pht + r;
+        MeasurementNoise sInv;
+        if (!invertSPD(s, sInv))
+            return false;
+
+        const Matrix<N, M> k = pht * sInv;
+        m_x += k * (z - h * m_x);
+
+        // Joseph form keeps P positive semi-definite under rounding
+        const Covariance ikh = Covariance::identity() - k * h;
+        m_p = ikh * m_p * ikh.transposed() + k * r * k.transposed();
+        m_p.symmetrize();
+        return true;
+    }
+
+    const State &state() const { return m_x; }
+    const Covariance &covariance() const { return m_p; }
+
+private:
+    State m_x;
+    Covariance m_p;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Log-linear (HDR style) histogram of latencies in nanoseconds.
+ *
+ * Values below 2^kSubBucketBits are counted exactly. Above, each power of
+ * two is split into 2^(kSubBucketBits - 1) equal buckets, so a bucket is
+ * at most 1/64 of its values wide (about 1.6 % relative error) from 1 ns
+ * to 2^kMaxValueBits ns (about 68 s); larger values go in the last bucket.
+ * min(), max() and mean() are exact.
+ *
+ * The counts are a fixed array: record() does not allocate and costs a
+ * bit scan, a shift and a few adds. Not thread-safe; one histogram per
+ * receiver, merge() for totals.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr int kMaxValueBits = 36;
+    static constexpr size_t kBuckets = size_t(kMaxValueBits - kSubBucketBits + 2) << (kSubBucketBits - 1);
+
+    /// Monotonic clock in nanoseconds, the time base of the recorded latencies.
+    static int64_t clockNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(uint64_t ns)
+    {
+        m_counts[bucketIndex(ns)] += 1;
+        m_count += 1;
+        m_sum += ns;
+        if (ns < m_min)
+            m_min = ns;
+        if (ns > m_max)
+            m_max = ns;
+    }
+
+    /// Record the time from @p startNs (clockNs()) to @p endNs; negative spans count as 0.
+    void recordSpan(int64_t startNs, int64_t endNs) { record(endNs > startNs ? uint64_t(endNs - startNs) : 0); }
+
+    uint64_t count() const { return m_count; }
+    uint64_t min() const { return m_count ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_count ? double(m_sum) / double(m_count) : 0.0; }
+
+    /**
+     * @brief Value at or below which @p percentile % of the recordings fall,
+     * as the upper bound of its bucket (capped by max()); 0 when empty.
+     */
+    uint64_t percentile(double percentile) const;
+
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    static size_t bucketIndex(uint64_t ns)
+    {
+        constexpr int kHalf = kSubBucketBits - 1;
+        if (ns >> kMaxValueBits)
+            return kBuckets - 1;
+        if (ns < (uint64_t(1) << kSubBucketBits))
+            return size_t(ns);
+        // v >> shift falls in [2^kHalf, 2^kSubBucketBits)
+        const int shift = (63 - __builtin_clzll(ns)) - kHalf;
+        return (size_t(shift) << kHalf) + size_t(ns >> shift);
+    }
+
+    /// Largest value counted in bucket @p index.
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::array<uint64_t, kBuckets> m_counts{};
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = std::numeric_limits<uint64_t>::max();
+    uint64_t m_max = 0;
+};
@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * @brief Dense row-major matrix with compile-time dimensions.
+ *
+ * Storage is an inline std::array, so matrices live on the stack and no
+ * operation allocates. Loops have constant trip counts and are fully
+ * unrolled by the compiler at the sizes used by the filters (<= 6).
+ */
+template <int Rows, int Cols>
+class Matrix {
+public:
+    static_assert(Rows > 0 && Cols > 0, "Matrix dimensions must be positive");
+
+    Matrix() { m_data.fill(0.0); }
+
+    static Matrix zero() { return Matrix(); }
+
+    static Matrix identity()
+    {
+        static_assert(Rows == Cols, "identity() needs a square matrix");
+        Matrix m;
+        for (int i = 0; i < Rows; ++i)
+            m(i, i) = 1.0;
+        return m;
+    }
+
+    static constexpr int rows() { return Rows; }
+    static constexpr int cols() { return Cols; }
+
+    double &operator()(int r, int c) { return m_data[r * Cols + c]; }
+    double operator()(int r, int c) const { return m_data[r * Cols + c]; }
+
+    /// Element access for column vectors.
+    double &operator[](int i) { return m_data[i]; }
+    double operator[](int i) const { return m_data[i]; }
+
+    double *data() { return m_data.data(); }
+    const double *data() const { return m_data.data(); }
+
+    Matrix &operator+=(const Matrix &o)
+    {
+        for (int i = 0; i < Rows * Cols; ++i)
+            m_data[i] += o.m_data[i];
+        return *this;
+    }
+
+    Matrix &operator-=(const Matrix &o)
+    {
+        for (int i = 0; i < Rows * Cols; ++i)
+            m_data[i] -= o.m_data[i];
+        return *this;
+    }
+
+    Matrix &operator*=(double s)
+    {
+        for (double &v : m_data)
+            v *= s;
+        return *this;
+    }
+
+    friend Matrix operator+(Matrix a, const Matrix &b) { return a += b; }
+    friend Matrix operator-(Matrix a, const Matrix &b) { return a -= b; }
+    friend Matrix operator*(Matrix a, double s) { return a *= s; }
+
+    Matrix<Cols, Rows> transposed() const
+    {
+        Matrix<Cols, Rows> t;
+        for (int r = 0; r < Rows; ++r)
+            for (int c = 0; c < Cols; ++c)
+                t(c, r) = (*this)(r, c);
+        return t;
+    }
+
+    /// Average with the transpose, to keep covariances symmetric under rounding.
+    void symmetrize()
+    {
+        static_assert(Rows == Cols, "symmetrize() needs a square matrix");
+        for (int r = 0; r < Rows; ++r)
+            for (int c = r + 1; c < Cols; ++c)
+                (*this)(r, c) = (*this)(c, r) = 0.5 * ((*this)(r, c) + (*this)(c, r));
+    }
+
+private:
+    std::array<double, Rows * Cols> m_data;
+};
+
+template <int R, int K, int C>
+Matrix<R, C> operator*(const Matrix<R, K> &a, const Matrix<K, C> &b)
+{
+    Matrix<R, C> m;
+    for (int r = 0; r < R; ++r)
+        for (int k = 0; k < K; ++k)
+        {
+            const double v = a(r, k);
+            for (int c = 0; c < C; ++c)
+                m(r, c) += v * b(k, c);
+        }
+    return m;
+}
+
+/**
+ * @brief Inverse of a symmetric positive definite matrix (Cholesky).
+ *
+ * @return false if @p a is not positive definite; @p out is untouched then.
+ */
+template <int N>
+bool invertSPD(const Matrix<N, N> &a, Matrix<N, N> &out)
+{
+    // a = L L^T, then out = L^-T L^-1
+    Matrix<N, N> l;
+    for (int j = 0; j < N; ++j)
+    {
+        double d = a(j, j);
+        for (int k = 0; k < j; ++k)
+            d -= l(j, k) * l(j, k);
+        if (!(d > 0.0))
+            return false;
+        l(j, j) = std::sqrt(d);
+        const double inv = 1.0 / l(j, j);
+        for (int i = j + 1; i < N; ++i)
+        {
+            double s = a(i, j);
+            for (int k = 0; k < j; ++k)
+                s -= l(i, k) * l(j, k);
+            l(i, j) = s * inv;
+        }
+    }
+
+    Matrix<N, N> li;    // L^-1, lower triangular
+    for (int j = 0; j < N; ++j)
+    {
+        li(j, j) = 1.0 / l(j, j);
+        for (int i = j + 1; i < N; ++i)
+        {
+            double s = 0.0;
+            for (int k = j; k < i; ++k)
+                s -= l(i, k) * li(k, j);
+            li(i, j) = s / l(i, i);
+        }
+    }
+
+    for (int r = 0; r < N; ++r)
+        for (int c = 0; c <= r; ++c)
+        {
+            double s = 0.0;
+            for (int k = r; k < N; ++k)
+                s += li(k, r) * li(k, c);
+            out(r, c) = out(c, r) = s;
+        }
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "EpochArena.hpp"
+#include "EpochRecord.hpp"
+#include "NMEAStreamParser.hpp"
+#include "ParseStats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+ * @brief Parse state of one receiver whose epochs live in arenas.
+ *
+ * Wraps an NMEAStreamParser and the current EpochRecord. The satellite list
+ * of the record is allocated from an EpochArena, so assembling an epoch
+ * does not call malloc once the arenas and the parser's GSV buffer have
+ * reached their working size.
+ *
+ * Two arenas take turns. At each epoch boundary (the first parse() after a
+ * GGA) the record moves into the other arena, after that arena is reset.
+ * The previous epoch's memory is then reused two epochs later. Rejected
+ * lines are counted rather than thrown. Their exceptions keep the message
+ * inline (see NMEAException), so only the exception object is allocated.
+ *
+ * With GNSS_PARSE_STATS, parse() also records sentence, byte, checksum,
+ * error and stage time counters into stats() (see ParseStats).
+ */
+class NMEAEpochContext {
+public:
+    explicit NMEAEpochContext(size_t arenaSize = 16 * 1024);
+    NMEAEpochContext(const NMEAEpochContext &) = delete;
+    NMEAEpochContext &operator=(const NMEAEpochContext &) = delete;
+
+    /// Parse one line; true when a GGA completed an epoch, see epoch().
+    bool parse(std::string_view line);
+
+    /// Current epoch; valid until the parse() after the one that returned true.
+    const EpochRecord &epoch() const { return *m_record; }
+
+    NMEAStreamParser &parser() { return m_parser; }
+    uint64_t epochs() const { return m_epochs; }
+    uint64_t rejectedLines() const { return m_rejected; }
+
+    /// Arena holding the current epoch.
+    const EpochArena &arena() const { return m_arenas[m_active]; }
+
+    /// Hot-path counters; empty unless built with GNSS_PARSE_STATS.
+    const ParseStats &stats() const { return m_stats; }
+
+private:
+    void endEpoch();
+    bool parseSentence(std::string_view line, ParseStats::Shard *stats = nullptr);
+
+    EpochArena m_arenas[2];
+    size_t m_active = 0;
+    NMEAStreamParser m_parser;
+    std::optional<EpochRecord> m_record;
+    bool m_epochDone = false;
+    uint64_t m_epochs = 0;
+    uint64_t m_rejected = 0;
+    ParseStats m_stats;
+};
@@ -1,19 +1,67 @@
 #pragma once
 
-#include <QString>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <string_view>
 
-class NMEAException : public std::runtime_error {
+/**
+ * @brief Base of the NMEA parse errors.
+ *
+ * The message is kept in an inline buffer (truncated past 159 characters)
+ * instead of a heap string, so building a rejection does not allocate.
+ * Messages are std strings, so the classes are the same in gnsscore_std
+ * and gnsscore; QtAdapter::parsingError() and invalidData() take a QString.
+ */
+class NMEAException : public std::exception {
 public:
-    explicit NMEAException(const QString &msg)
-        : std::runtime_error(msg.toStdString()) {}
+    explicit NMEAException(const std::string &msg) noexcept
+        : NMEAException(std::string_view(), msg) {}
+    explicit NMEAException(const char *msg) noexcept
+        : NMEAException(std::string_view(), std::string_view(msg)) {}
+
+    const char *what() const noexcept override { return m_message; }
+
+protected:
+    NMEAException(std::string_view prefix, std::string_view msg) noexcept
+    {
+        append(prefix);
+        append(msg);
+    }
+
+    /// @p prefix, @p msg, then @p value in decimal.
+    NMEAException(std::string_view prefix, std::string_view msg, long long value) noexcept
+        : NMEAException(prefix, msg)
+    {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+
+private:
+    void append(std::string_view text) noexcept
+    {
+        const size_t count = std::min(text.size(), sizeof(m_message) - 1 - m_length);
+        std::memcpy(m_message + m_length, text.data(), count);
+        m_length += count;
+        m_message[m_length] = '\0';
+    }
+
+    char m_message[160] = {};
+    size_t m_length = 0;
 };
 
 class ParsingError : public NMEAException {
 public:
-    explicit ParsingError(const QString &msg) : NMEAException("ParsingError: " + msg) {}
+    explicit ParsingError(const std::string &msg) noexcept : NMEAException("ParsingError: ", msg) {}
+    explicit ParsingError(const char *msg) noexcept : NMEAException("ParsingError: ", msg) {}
 };
 
 class InvalidDataError : public NMEAException {
 public:
-    explicit InvalidDataError(const QString &msg) : NMEAException("InvalidData: " + msg) {}
+    explicit InvalidDataError(const std::string &msg) noexcept : NMEAException("InvalidData: ", msg) {}
+    explicit InvalidDataError(const char *msg) noexcept : NMEAException("InvalidData: ", msg) {}
+    InvalidDataError(const char *msg, long long value) noexcept : NMEAException("InvalidData: ", msg, value) {}
 };
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Incremental NMEA line framer for byte streams (sockets, serial
+ * devices, files read in blocks).
+ *
+ * Bytes are pushed with feed(), or read in place with writeBuffer() and
+ * commit(); next() yields complete lines without CR/LF. A line longer than
+ * maxLineLength is dropped up to its newline and counted, so a stream
+ * without newlines cannot grow the buffer without bound.
+ */
+class NMEAFramer {
+public:
+    explicit NMEAFramer(size_t maxLineLength = 1024);
+
+    void feed(const char *data, size_t length);
+
+    /// Room for at least @p capacity bytes after the buffered data; commit() what was written.
+    char *writeBuffer(size_t capacity);
+    void commit(size_t length);
+
+    /// Next complete line; the view stays valid until the next feed() or writeBuffer().
+    bool next(std::string_view &line);
+
+    /// The unterminated last line at the end of a stream, if any.
+    bool flush(std::string_view &line);
+
+    void clear();
+
+    /// Bytes received but not returned by next() yet (an incomplete line).
+    size_t buffered() const { return m_size - m_head; }
+
+    uint64_t overlongLines() const { return m_overlongLines; }
+
+private:
+    void compact();
+
+    std::string m_buffer;
+    size_t m_head = 0;          // first byte not returned yet
+    size_t m_size = 0;          // bytes of m_buffer holding data
+    size_t m_scan = 0;          // no newline in [m_head, m_scan)
+    size_t m_maxLineLength;
+    bool m_discarding = false;  // inside an overlong line
+    uint64_t m_overlongLines = 0;
+};
@@ -0,0 +1,204 @@
+#pragma once
+#include "EpochPool.hpp"
+#include "LatencyHistogram.hpp"
+#include "NMEAEpochContext.hpp"
+#include "NMEAFramer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unordered_map>
+#include <vector>
+
+struct NMEAListenerConfig {
+    size_t maxLineLength = 1024;        // TCP lines longer than this are dropped
+    unsigned udpBatch = 64;             // datagrams per recvmmsg call
+    size_t datagramSize = 2048;         // larger datagrams are truncated
+    int receiveBuffer = 4 << 20;        // SO_RCVBUF of the UDP sockets, 0 keeps the system default
+    size_t tcpReadSize = 16384;
+    size_t maxReceivers = 1024;         // live receivers, about 24 KB each (see NMEAListener)
+    size_t arenaSize = 4096;            // of each of the two epoch arenas of a receiver
+};
+
+/**
+ * @brief Collector for receivers pushing NMEA over UDP and TCP.
+ *
+ * A non-blocking epoll loop on the thread calling run() or poll(). UDP
+ * sockets are drained with recvmmsg, udpBatch datagrams per system call;
+ * each datagram holds whole sentences. TCP connections are accepted
+ * and read through one NMEAFramer each.
+ *
+ * Every receiver (UDP peer address and port, or TCP connection) has its
+ * own NMEAEpochContext, so interleaved GSV sequences of different
+ * receivers do not mix and epochs are assembled in the receiver's arenas.
+ * The handler is called on the loop thread after each GGA with the
+ * receiver whose epoch completed (context.epoch()). Rejected lines are
+ * counted per receiver by its context. A closed TCP connection keeps its
+ * Receiver, marked disconnected, until it is retired.
+ *
+ * context.epoch() is overwritten by the receiver's next epoch. A handler
+ * that passes epochs to other threads calls publish(), which copies the
+ * epoch into a recycled EpochRecord of the listener's EpochPool.
+ *
+ * At most maxReceivers receivers are live. A new peer beyond that retires
+ * the least recently active UDP or disconnected TCP receiver; when every
+ * receiver is a connected TCP one, the peer is refused (its datagram
+ * dropped or its connection closed) and counted in refusedPeers().
+ * retireIdle() drops idle receivers ahead of that. Ids are never reused,
+ * so a UDP peer that comes back after retirement gets a new receiver.
+ *
+ * Each receiver also has a latency histogram. It records the time from
+ * the arrival of the first byte of an epoch's first sentence (the
+ * recvmmsg or read call that returned it) to the handler call for that
+ * epoch.
+ *
+ * Linux only; part of gnsscore_async. stop() may be called from any thread,
+ * everything else from the loop thread.
+ */
+namespace Ingest {
+
+    class NMEAListener {
+    public:
+        struct Receiver {
+            uint32_t id = 0;
+            bool tcp = false;
+            bool connected = true;
+            std::string peer;               // "address:port"
+            NMEAEpochContext context;
+            uint64_t sentences = 0;
+            uint64_t bytes = 0;
+            LatencyHistogram latency;       // first byte of the epoch to the handler call
+            int64_t epochStartNs = -1;      // LatencyHistogram::clockNs(), -1 before the first sentence
+            int64_t lastActiveNs = 0;       // LatencyHistogram::clockNs() of the last data received
+
+            explicit Receiver(size_t arenaSize) : context(arenaSize) {}
+        };
+
+        using EpochHandler = std::function<void(Receiver &receiver)>;
+        using EpochHandle = EpochPool<EpochRecord>::Handle;
+
+        explicit NMEAListener(EpochHandler onEpoch, const NMEAListenerConfig &config = NMEAListenerConfig());
+        ~NMEAListener();
+        NMEAListener(const NMEAListener &) = delete;
+        NMEAListener &operator=(const NMEAListener &) = delete;
+
+        /**
+         * @brief Bind a UDP or TCP socket on an IPv4/IPv6 literal address.
+         * @return the bound port (useful with port 0).
+         * @throws std::system_error when the socket cannot be bound.
+         */
+        uint16_t listenUdp(const std::string &address, uint16_t port);
+        uint16_t listenTcp(const std::string &address, uint16_t port, int backlog = 128);
+
+        /// Handle the events of one epoll_wait; returns the sentences parsed.
+        size_t poll(int timeoutMs);
+
+        /// Loop on poll() until stop().
+        void run();
+
+        void stop();
+
+        /// Live receivers.
+        size_t receiverCount() const { return m_receivers.size(); }
+
+        /// Receiver @p id; throws std::out_of_range once it has been retired.
+        const Receiver &receiver(size_t id) const { return *m_receivers.at(static_cast<uint32_t>(id)); }
+
+        /**
+         * @brief Retire the disconnected TCP receivers and the UDP receivers
+         * silent for at least @p idleMs milliseconds.
+         * @return the receivers retired.
+         */
+        size_t retireIdle(int64_t idleMs);
+
+        /**
+         * @brief Copy of @p receiver's epoch (context.epoch()) that may be
+         * moved to and dropped on any thread, also after the listener is gone.
+         *
+         * From the handler. Once consumers keep up, the copy reuses returned
+         * epochs and does not allocate.
+         */
+        EpochHandle publish(const Receiver &receiver);
+
+        /// Epochs of publish(); allocated() stays flat in steady state.
+        const EpochPool<EpochRecord> &epochPool() const { return m_epochs; }
+
+        /// ParseStats counters of every receiver so far, retired ones included; zeros without GNSS_PARSE_STATS.
+        ParseCounters parseCounters() const;
+
+        uint64_t retiredReceivers() const { return m_retiredReceivers; }
+        uint64_t refusedPeers() const { return m_refusedPeers; }
+
+        uint64_t sentences() const { return m_sentences; }
+        uint64_t datagrams() const { return m_datagrams; }
+        uint64_t receiveCalls() const { return m_receiveCalls; }
+
+    private:
+        struct PeerKey {
+            uint8_t address[16];
+            uint16_t port;
+            uint16_t family;
+
+            bool operator==(const PeerKey &other) const;
+        };
+
+        struct PeerKeyHash {
+            size_t operator()(const PeerKey &key) const;
+        };
+
+        struct Connection {
+            int fd = -1;
+            Receiver *receiver = nullptr;
+            NMEAFramer framer;
+            int64_t partialSinceNs = 0;     // arrival of the incomplete line in the framer
+
+            explicit Connection(size_t maxLineLength) : framer(maxLineLength) {}
+        };
+
+        enum class Kind : uint8_t { Wakeup, Udp, TcpListen, Tcp };
+
+        struct Handle {
+            Kind kind;
+            int fd;
+            std::unique_ptr<Connection> connection;     // Tcp only
+        };
+
+        uint64_t watch(int fd, Kind kind, std::unique_ptr<Connection> connection = nullptr);
+        void close(uint64_t key);
+        Receiver *newReceiver(bool tcp, const sockaddr_storage &address);
+        void retire(Receiver &receiver);
+        size_t dispatch(Receiver &receiver, std::string_view line, int64_t arrivalNs);
+        size_t readUdp(int fd);
+        void acceptTcp(int fd);
+        size_t readTcp(uint64_t key, Connection &connection);
+
+        NMEAListenerConfig m_config;
+        EpochHandler m_onEpoch;
+        int m_epoll = -1;
+        int m_wakeup = -1;
+        bool m_stopped = false;
+        uint64_t m_nextKey = 0;
+        std::unordered_map<uint64_t, Handle> m_handles;                 // by epoll key
+        std::unordered_map<uint32_t, std::unique_ptr<Receiver>> m_receivers;    // by Receiver::id
+        std::unordered_map<PeerKey, Receiver *, PeerKeyHash> m_udpPeers;
+        uint32_t m_nextReceiverId = 0;
+        EpochPool<EpochRecord> m_epochs;
+
+        // recvmmsg batch: udpBatch datagrams of datagramSize bytes
+        std::vector<char> m_datagramBuffer;
+        std::vector<sockaddr_storage> m_peerAddresses;
+        std::vector<iovec> m_iovecs;
+        std::vector<mmsghdr> m_headers;
+
+        uint64_t m_sentences = 0;
+        uint64_t m_datagrams = 0;
+        uint64_t m_receiveCalls = 0;
+        uint64_t m_retiredReceivers = 0;
+        ParseCounters m_retiredCounters;
+        uint64_t m_refusedPeers = 0;
+    };
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include "ArchiveError.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct GNSSData;
+
+/**
+ * @brief Sparse time index over a raw NMEA log.
+ *
+ * Records the byte offset of a GGA sentence every intervalMs of log time,
+ * so a time window can be parsed without scanning from the start.
+ *
+ * Times are milliseconds from midnight UTC of the first GGA's day. GGA
+ * carries no date: the index moves to the next day when the time of day
+ * steps back by more than 12 hours. A smaller step back (a repeated or
+ * out-of-order GGA) stays on the same day.
+ */
+class NMEALogIndex {
+public:
+    struct Entry {
+        int64_t timeMs;
+        uint64_t offset;
+    };
+
+    /// Scan @p logPath and record a GGA offset every @p intervalMs.
+    static NMEALogIndex build(const std::string &logPath, int64_t intervalMs = 1000);
+
+    /// Load a sidecar written by save().
+    static NMEALogIndex load(const std::string &indexPath);
+
+    /// Load the sidecar of @p logPath if it matches the log, otherwise build and save it.
+    static NMEALogIndex openOrBuild(const std::string &logPath, int64_t intervalMs = 1000);
+
+    static std::string sidecarPath(const std::string &logPath) { return logPath + ".idx"; }
+
+    void save(const std::string &indexPath) const;
+
+    /**
+     * @brief Offset of the last indexed GGA at or before @p timeMs.
+     *
+     * Reading from there reaches the first epoch at or after @p timeMs
+     * after at most intervalMs of log. O(log n).
+     */
+    const Entry &seek(int64_t timeMs) const;
+
+    const std::vector<Entry> &entries() const { return m_entries; }
+    int64_t intervalMs() const { return m_intervalMs; }
+    uint64_t logSize() const { return m_logSize; }
+    bool isEmpty() const { return m_entries.empty(); }
+
+private:
+    std::vector<Entry> m_entries;
+    int64_t m_intervalMs = 0;
+    uint64_t m_logSize = 0;
+};
+
+namespace NMEAParser {
+
+    /**
+     * @brief Parse the GGA epochs of [fromMs, toMs) of a raw log.
+     *
+     * Seeks with @p index, then feeds each line to parseLine(). @p onEpoch is
+     * called after every GGA in the window with the accumulated @p data and
+     * the epoch time in index time. Malformed sentences are skipped.
+     *
+     * @return number of epochs delivered.
+     */
+    size_t parseWindow(const std::string &logPath, const NMEALogIndex &index,
+                       int64_t fromMs, int64_t toMs, GNSSData &data,
+                       const std::function<void(const GNSSData &, int64_t)> &onEpoch);
+};
@@ -0,0 +1,313 @@
+#pragma once
+#include "NMEAException.hpp"
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Compile-time description of NMEA sentence fields.
+ *
+ * A schema is a constexpr Sentence listing, for each field it reads, the
+ * token index, the member of a plain record struct it fills, the
+ * conversion, what to do when the conversion fails and an optional
+ * validity check. parse<Schema>() expands to one straight-line block per
+ * field: the index, member, converter and bounds are template constants,
+ * so no table is walked at run time and fields known to exist from the
+ * minimum field count are read without a bounds check.
+ *
+ * Declaring a sentence (see NMEASentences.hpp):
+ * @code
+ *   struct VTG { double course; double speedKmh; };
+ *   inline constexpr auto kVTG = NMEASchema::sentence(9, "VTG frame too short",
+ *       NMEASchema::field(1, &VTG::course, NMEASchema::toDouble),
+ *       NMEASchema::field(7, &VTG::speedKmh, NMEASchema::toDouble)
+ *           .range(0.0, 2000.0, "Speed out of range"));
+ *   ...
+ *   VTG vtg;
+ *   NMEASchema::parse<kVTG>(tokens, count, vtg);
+ * @endcode
+ */
+namespace NMEASchema {
+
+    // --- Converters: bool (field, next field, value), false when the field does not convert ---
+
+    /// Whole-field integer, like QString::toInt (surrounding blanks allowed).
+    inline bool toInt(std::string_view s, std::string_view, int &value)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '\n'))
+            s.remove_suffix(1);
+        if (!s.empty() && s.front() == '+')
+            s.remove_prefix(1);
+        const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        return !s.empty() && ec == std::errc() && end == s.data() + s.size();
+    }
+
+    /// Whole-field floating point, like QString::toDouble (surrounding blanks allowed).
+    inline bool toDouble(std::string_view s, std::string_view, double &value)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '\n'))
+            s.remove_suffix(1);
+        if (!s.empty() && s.front() == '+')
+            s.remove_prefix(1);
+        const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        return !s.empty() && ec == std::errc() && end == s.data() + s.size();
+    }
+
+    /// Floating point of the last field of a sentence, before the "*hh" checksum.
+    inline bool toDoubleBeforeChecksum(std::string_view s, std::string_view next, double &value)
+    {
+        return toDouble(s.substr(0, s.find('*')), next, value);
+    }
+
+    /**
+     * @brief ddmm.mmmm / dddmm.mmmm with the N/S/E/W direction in the next
+     * field, to signed decimal degrees. Throws InvalidDataError like
+     * NMEAParser::convertToDecimalDegrees.
+     */
+    inline bool toDegrees(std::string_view value, std::string_view direction, double &degrees)
+    {
+        if (value.empty() || direction.empty())
+        {
+            throw InvalidDataError("InvalidData: Empty latitude/longitude or direction");
+        }
+
+        const size_t degDigits = (direction == "N" || direction == "S") ? 2 : 3;
+        if (value.size() < degDigits)
+        {
+            throw InvalidDataError("InvalidData: String too short for degrees");
+        }
+
+        int degreePart = 0;
+        double minutePart = 0.0;
+        if (!toInt(value.substr(0, degDigits), {}, degreePart) || !toDouble(value.substr(degDigits), {}, minutePart))
+        {
+            throw InvalidDataError("InvalidData: Conversion failed");
+        }
+
+        degrees = degreePart + (minutePart / 60.0);
+        if (direction == "S" || direction == "W")
+            degrees = -degrees;
+        return true;
+    }
+
+    /**
+     * @brief hhmmss[.sss] to milliseconds since midnight. Throws
+     * InvalidDataError below six characters; false for an impossible time.
+     */
+    inline bool toTimeOfDay(std::string_view s, std::string_view, int64_t &ms)
+    {
+        if (s.size() < 6)
+        {
+            throw InvalidDataError("Invalid UTC time in GGA frame");
+        }
+        int hour = 0, minute = 0, second = 0;
+        double fraction = 0.0;
+        if (!toInt(s.substr(0, 2), {}, hour) || !toInt(s.substr(2, 2), {}, minute) || !toInt(s.substr(4, 2), {}, second))
+            return false;
+        if (s.size() > 7 && s[6] == '.' && !toDouble(s.substr(6), {}, fraction))
+            return false;
+        if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59)
+            return false;
+        const int64_t millis = fraction * 1000.0 + 0.5 < 999.0 ? static_cast<int64_t>(fraction * 1000.0 + 0.5) : 999;
+        ms = ((hour * 60LL + minute) * 60LL + second) * 1000LL + millis;
+        return true;
+    }
+
+    // --- Field and sentence declarations ---
+
+    enum class OnParseError {
+        Zero,           // value 0, then the check (what QString::toInt/toDouble give)
+        Fallback,       // store the fallback value, no check
+        Skip,           // stop: parse() returns false
+    };
+
+    enum class Check {
+        None,
+        Closed,         // min <= v <= max
+        LowOpen,        // min < v <= max
+        OneOf,          // bit v of the allowed mask set
+    };
+
+    enum class OnCheckError {
+        Throw,          // InvalidDataError(error)
+        Skip,           // stop: parse() returns false
+    };
+
+    /**
+     * @brief One field: token @p index converted to Value and stored in
+     * Record::*member (of type Member). Built with field() and the
+     * constexpr modifiers below.
+     */
+    template <typename Record, typename Value, typename Member>
+    struct Field {
+        size_t index;
+        Member Record::*member;
+        bool (*convert)(std::string_view, std::string_view, Value &);
+        OnParseError onParseError = OnParseError::Zero;
+        Value fallback{};
+        Check check = Check::None;
+        Value min{};
+        Value max{};
+        uint64_t allowed = 0;
+        OnCheckError onCheckError = OnCheckError::Throw;
+        const char *error = nullptr;
+        bool appendValue = false;       // error message followed by the value
+
+        constexpr Field range(Value low, Value high, const char *message) const
+        {
+            Field f = *this;
+            f.check = Check::Closed;
+            f.min = low;
+            f.max = high;
+            f.error = message;
+            return f;
+        }
+
+        constexpr Field rangeLowOpen(Value low, Value high, const char *message) const
+        {
+            Field f = range(low, high, message);
+            f.check = Check::LowOpen;
+            return f;
+        }
+
+        /// Value must be one of the @p mask bits (0..63); the message is followed by the value.
+        constexpr Field oneOf(uint64_t mask, const char *message) const
+        {
+            Field f = *this;
+            f.check = Check::OneOf;
+            f.allowed = mask;
+            f.error = message;
+            f.appendValue = true;
+            return f;
+        }
+
+        constexpr Field orFallback(Value value) const
+        {
+            Field f = *this;
+            f.onParseError = OnParseError::Fallback;
+            f.fallback = value;
+            return f;
+        }
+
+        /// Parse and check failures both make parse() return false.
+        constexpr Field orSkip() const
+        {
+            Field f = *this;
+            f.onParseError = OnParseError::Skip;
+            f.onCheckError = OnCheckError::Skip;
+            return f;
+        }
+    };
+
+    template <typename Record, typename Member, typename Value>
+    constexpr Field<Record, Value, Member> field(size_t index, Member Record::*member,
+                                                 bool (*convert)(std::string_view, std::string_view, Value &))
+    {
+        return Field<Record, Value, Member>{index, member, convert};
+    }
+
+    template <typename... Fields>
+    struct Sentence {
+        size_t minFields;               // fewer tokens: ParsingError(tooShort)
+        const char *tooShort;
+        std::tuple<Fields...> fields;
+    };
+
+    template <typename... Fields>
+    constexpr Sentence<Fields...> sentence(size_t minFields, const char *tooShort, Fields... fields)
+    {
+        return Sentence<Fields...>{minFields, tooShort, std::tuple<Fields...>(fields...)};
+    }
+
+    // --- Generated parsers ---
+
+    namespace detail {
+
+        template <const auto &Schema, size_t I, typename Record>
+        bool parseField(const std::string_view *tokens, size_t count, Record &record)
+        {
+            constexpr const auto &f = std::get<I>(Schema.fields);
+            using Value = std::remove_cv_t<decltype(f.min)>;
+            using Member = std::remove_reference_t<decltype(record.*(f.member))>;
+
+            // Indices below minFields were checked once for the whole sentence
+            std::string_view token, next;
+            if constexpr (f.index < Schema.minFields)
+                token = tokens[f.index];
+            else if (f.index < count)
+                token = tokens[f.index];
+            if constexpr (f.index + 1 < Schema.minFields)
+                next = tokens[f.index + 1];
+            else if (f.index + 1 < count)
+                next = tokens[f.index + 1];
+
+            Value value{};
+            if (!f.convert(token, next, value))
+            {
+                if constexpr (f.onParseError == OnParseError::Skip)
+                    return false;
+                if constexpr (f.onParseError == OnParseError::Fallback)
+                {
+                    record.*(f.member) = static_cast<Member>(f.fallback);
+                    return true;
+                }
+                value = Value{};
+            }
+
+            bool valid = true;
+            if constexpr (f.check == Check::Closed)
+                valid = value >= f.min && value <= f.max;
+            else if constexpr (f.check == Check::LowOpen)
+                valid = value > f.min && value <= f.max;
+            else if constexpr (f.check == Check::OneOf)
+                valid = value >= 0 && value < 64 && ((f.allowed >> static_cast<unsigned>(value)) & 1u);
+
+            if (!valid)
+            {
+                if constexpr (f.onCheckError == OnCheckError::Skip)
+                    return false;
+                if constexpr (f.appendValue)
+                    throw InvalidDataError(f.error, static_cast<long long>(value));
+                else
+                    throw InvalidDataError(f.error);
+            }
+            record.*(f.member) = static_cast<Member>(value);
+            return true;
+        }
+
+        template <const auto &Schema, typename Record, size_t... I>
+        bool parseFields(const std::string_view *tokens, size_t count, Record &record, std::index_sequence<I...>)
+        {
+            return (parseField<Schema, I>(tokens, count, record) && ...);
+        }
+    };
+
+    /**
+     * @brief Fill @p record from the @p count tokens of one sentence (or one
+     * repeated block), fields in declaration order.
+     *
+     * @return false when an orSkip() field failed; fields before it are stored.
+     * @throws ParsingError below minFields tokens, InvalidDataError from a
+     * failed check or converter.
+     */
+    template <const auto &Schema, typename Record>
+    bool parse(const std::string_view *tokens, size_t count, Record &record)
+    {
+        if (count < Schema.minFields)
+        {
+            throw ParsingError(Schema.tooShort);
+        }
+        constexpr size_t fields = std::tuple_size<std::remove_cv_t<decltype(Schema.fields)>>::value;
+        return detail::parseFields<Schema>(tokens, count, record, std::make_index_sequence<fields>());
+    }
+};
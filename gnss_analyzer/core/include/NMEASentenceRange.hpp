@@ -0,0 +1,124 @@
+#pragma once
+#include "NMEASentences.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+/**
+ * @brief One GSV message: its header and up to four satellites, in
+ * sentence order (sequences are not assembled, see NMEAStreamParser).
+ */
+struct GSVMessage {
+    NMEASentences::GSV header;
+    std::array<SatelliteRecord, 4> satellites{};
+    uint8_t count = 0;
+};
+
+/// A GGA, GSV or GSA line that failed its schema checks.
+struct NMEARejected {
+    std::string message;
+};
+
+/// monostate: not a sentence the range reads (never yielded by the range).
+using NMEASentence = std::variant<std::monostate, NMEASentences::GGA, GSVMessage, NMEASentences::GSA, NMEARejected>;
+
+struct NMEAItem {
+    std::string_view line;          // without CR/LF, points into the buffer
+    uint64_t offset = 0;            // of the line in the buffer
+    NMEASentence sentence;
+
+    /// Two-letter talker ID ("GP", "GN", ...).
+    std::string_view talker() const { return line.substr(1, 2); }
+};
+
+/**
+ * @brief Parse one NMEA line (any talker) with the NMEASentences schemas.
+ *
+ * Unknown sentences give std::monostate; check failures give NMEARejected
+ * instead of throwing, so that a bad line does not end an iteration.
+ */
+NMEASentence parseSentence(std::string_view line);
+
+/**
+ * @brief Lazy, pull-style range of the GGA, GSV and GSA sentences of a
+ * byte buffer (a file read or mapped in memory, a socket buffer, ...).
+ *
+ * Iterating splits lines in place and parses each one when the iterator
+ * is advanced: no QString, no line copies, no callback and no container
+ * of results. Lines not starting with '$' and other sentence types are
+ * skipped. The buffer must outlive the range and its items.
+ *
+ * It is an input range with a sentinel; range-for works in C++17 and, in
+ * C++20, it is a std::ranges::view (through enable_view, so the class is
+ * the same in both modes) that composes with std::views:
+ * @code
+ *   for (const NMEAItem &item : NMEASentenceRange(bytes)
+ *            | std::views::filter([](const NMEAItem &i) { return i.talker() == "GN"; }))
+ * @endcode
+ */
+class NMEASentenceRange {
+public:
+    struct sentinel {};
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = NMEAItem;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const NMEAItem *;
+        using reference = const NMEAItem &;
+
+        iterator() = default;
+
+        reference operator*() const { return m_item; }
+        pointer operator->() const { return &m_item; }
+
+        iterator &operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        void operator++(int) { advance(); }
+
+        friend bool operator==(const iterator &it, sentinel) { return it.m_done; }
+        friend bool operator==(sentinel s, const iterator &it) { return it == s; }
+        friend bool operator!=(const iterator &it, sentinel s) { return !(it == s); }
+        friend bool operator!=(sentinel s, const iterator &it) { return !(it == s); }
+
+    private:
+        friend class NMEASentenceRange;
+        iterator(const char *begin, const char *end);
+        void advance();
+
+        const char *m_begin = nullptr;
+        const char *m_next = nullptr;
+        const char *m_end = nullptr;
+        NMEAItem m_item;
+        bool m_done = true;
+    };
+
+    NMEASentenceRange() = default;
+    explicit NMEASentenceRange(std::string_view bytes) : m_bytes(bytes) {}
+    NMEASentenceRange(const char *data, size_t size) : m_bytes(data, size) {}
+
+    iterator begin() const { return iterator(m_bytes.data(), m_bytes.data() + m_bytes.size()); }
+    sentinel end() const { return {}; }
+
+private:
+    std::string_view m_bytes;
+};
+
+#if __cplusplus >= 202002L
+template <>
+inline constexpr bool std::ranges::enable_view<NMEASentenceRange> = true;
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+#include "EpochRecord.hpp"
+#include "NMEASchema.hpp"
+#include <array>
+#include <limits>
+
+/**
+ * @brief Field schemas of the sentences NMEAParser, NMEAStreamParser and
+ * NMEASentenceRange read, so all three apply the same checks and throw
+ * the same messages.
+ */
+namespace NMEASentences {
+
+    /**
+     * @brief GGA fields.
+     *
+     * Ex: $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47
+     *  1 = UTC time (hhmmss.sss)      6 = Fix quality (0, 1 GPS, 2 DGPS, 4 RTK)
+     *  2 = Latitude (ddmm.mmmm)       7 = Number of satellites
+     *  3 = N/S                        8 = HDOP
+     *  4 = Longitude (dddmm.mmmm)     9 = Altitude (meters)
+     *  5 = E/W
+     */
+    struct GGA {
+        int64_t timeOfDayMs = -1;       // -1: impossible time, timestamp left unchanged
+        double latitude = 0.0;
+        double longitude = 0.0;
+        uint8_t fixQuality = 0;
+        uint8_t satellites = 0;
+        double hdop = 0.0;
+        double altitude = 0.0;
+    };
+
+    inline constexpr auto kGGA = NMEASchema::sentence(10, "GGA frame too short: expected >=10 fields",
+        NMEASchema::field(1, &GGA::timeOfDayMs, NMEASchema::toTimeOfDay).orFallback(-1),
+        NMEASchema::field(2, &GGA::latitude, NMEASchema::toDegrees),
+        NMEASchema::field(4, &GGA::longitude, NMEASchema::toDegrees),
+        NMEASchema::field(6, &GGA::fixQuality, NMEASchema::toInt)
+            .oneOf((1u << 0) | (1u << 1) | (1u << 2) | (1u << 4), "Unknown fix quality code: "),
+        NMEASchema::field(7, &GGA::satellites, NMEASchema::toInt)
+            .range(0, 50, "Number of satellites out of range"),
+        NMEASchema::field(8, &GGA::hdop, NMEASchema::toDouble)
+            .rangeLowOpen(0.0, 50.0, "HDOP value out of range"),
+        NMEASchema::field(9, &GGA::altitude, NMEASchema::toDouble)
+            .range(-500.0, 10000.0, "Altitude out of realistic bounds"));
+
+    /**
+     * @brief GSV header, followed by blocks of kGSVSatellite.
+     *
+     * Ex: $GPGSV,3,1,12,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A
+     *  1 = Total number of GSV messages
+     *  2 = Message number (1..N)
+     *  3 = Total satellites in view
+     *  4+ = Blocks of [PRN, elevation (deg), azimuth (deg), SNR (dB-Hz)]
+     */
+    struct GSV {
+        int totalMessages = 0;
+        int messageNumber = 0;
+        int satellitesInView = 0;
+    };
+
+    inline constexpr size_t kGSVFirstBlock = 4;
+    inline constexpr size_t kGSVBlockSize = 4;
+
+    inline constexpr auto kGSV = NMEASchema::sentence(4, "GSV frame too short: expected >=4 fields",
+        NMEASchema::field(1, &GSV::totalMessages, NMEASchema::toInt),
+        NMEASchema::field(2, &GSV::messageNumber, NMEASchema::toInt),
+        NMEASchema::field(3, &GSV::satellitesInView, NMEASchema::toInt));
+
+    /// One satellite block; an invalid PRN skips the block, empty values are -inf.
+    inline constexpr auto kGSVSatellite = NMEASchema::sentence(kGSVBlockSize, "GSV satellite block too short",
+        NMEASchema::field(0, &SatelliteRecord::id, NMEASchema::toInt)
+            .range(1, std::numeric_limits<int>::max(), "Invalid satellite ID").orSkip(),
+        NMEASchema::field(1, &SatelliteRecord::elevation, NMEASchema::toDouble)
+            .orFallback(-std::numeric_limits<double>::infinity()),
+        NMEASchema::field(2, &SatelliteRecord::azimuth, NMEASchema::toDouble)
+            .orFallback(-std::numeric_limits<double>::infinity()),
+        NMEASchema::field(3, &SatelliteRecord::snr, NMEASchema::toDoubleBeforeChecksum)
+            .orFallback(-std::numeric_limits<double>::infinity()));
+
+    /**
+     * @brief GSA fields (DOP and active satellites).
+     *
+     * Ex: $GPGSA,A,3,04,05,09,12,24,25,29,31,,,,,1.8,1.0,1.4*30
+     *  1 = Mode (M manual, A automatic)
+     *  2 = Fix type (1 none, 2 2D, 3 3D)
+     *  3..14 = PRNs of the satellites used, empty when unused
+     *  15 = PDOP, 16 = HDOP, 17 = VDOP
+     */
+    struct GSA {
+        int fixType = 0;
+        double pdop = 0.0;              // NaN when empty
+        double hdop = 0.0;
+        double vdop = 0.0;
+        std::array<int32_t, 12> prns{};
+        uint8_t prnCount = 0;
+    };
+
+    inline constexpr size_t kGSAFirstPrn = 3;
+    inline constexpr size_t kGSAPrnFields = 12;
+
+    inline constexpr auto kGSA = NMEASchema::sentence(18, "GSA frame too short: expected >=18 fields",
+        NMEASchema::field(2, &GSA::fixType, NMEASchema::toInt)
+            .range(1, 3, "Unknown GSA fix type"),
+        NMEASchema::field(15, &GSA::pdop, NMEASchema::toDouble)
+            .orFallback(std::numeric_limits<double>::quiet_NaN()),
+        NMEASchema::field(16, &GSA::hdop, NMEASchema::toDouble)
+            .orFallback(std::numeric_limits<double>::quiet_NaN()),
+        NMEASchema::field(17, &GSA::vdop, NMEASchema::toDoubleBeforeChecksum)
+            .orFallback(std::numeric_limits<double>::quiet_NaN()));
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include "EpochRecord.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief NMEA parser of the Qt-free gnsscore_std library.
+ *
+ * Accepts the same sentences as NMEAParser ($GPGGA and $GPGSV), applies the
+ * same range checks and throws the same ParsingError / InvalidDataError,
+ * but works on std::string_view without copying or splitting the line and
+ * fills an EpochRecord. Unlike NMEAParser, the partial GSV sequence is per
+ * instance, so several receivers can be parsed at once, and fractional
+ * seconds of the GGA time are kept. Field layouts and checks are the
+ * compile-time schemas of NMEASentences.hpp.
+ *
+ * GGA carries no date: the parser starts on the current UTC day (or the
+ * one given to setDate()) and moves to the next day when the time of day
+ * steps back by more than 12 hours.
+ */
+class NMEAStreamParser {
+public:
+    enum class Update {
+        None,           // ignored sentence or part of a GSV sequence
+        Fix,            // GGA fields of the record were updated
+        Satellites,     // a GSV sequence completed: satellitesInView and snrAvg were replaced
+    };
+
+    NMEAStreamParser();
+
+    /// Parse one sentence (trailing CR/LF allowed) into @p record.
+    Update parse(std::string_view line, EpochRecord &record);
+
+    /// UTC day of the following GGA times, given by any time point within it.
+    void setDate(EpochTime day);
+
+    /// Drop a partial GSV sequence.
+    void reset();
+
+    /// GSV sequences dropped because a new part 1 arrived before their last part.
+    uint64_t sequenceResets() const { return m_sequenceResets; }
+
+    static DATAType sentenceType(std::string_view line);
+
+    /// True when the line ends in a "*hh" checksum that does not match its content.
+    static bool checksumMismatch(std::string_view line);
+    static double toDecimalDegrees(std::string_view value, std::string_view direction);
+
+private:
+    void parseGGA(const std::string_view *fields, size_t count, EpochRecord &record);
+    bool parseGSV(const std::string_view *fields, size_t count, EpochRecord &record);
+
+    int64_t m_dayMs = 0;                    // UTC midnight of the current day
+    int64_t m_lastTimeOfDayMs = -1;
+    std::vector<SatelliteRecord> m_pending;     // GSV sequence being assembled, ascending ID
+    int m_expectedParts = 0;
+    uint64_t m_sequenceResets = 0;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Worker threads of the batch modules (Allan deviation, accuracy
+ * statistics, sky histogram, receiver comparison).
+ *
+ * The calling thread is always one of the workers. An exception thrown by
+ * any worker stops the handing out of new work; it is rethrown on the
+ * calling thread once every worker has been joined.
+ */
+namespace Parallel {
+
+    /// Work items per thread below which thread startup costs more than it saves.
+    constexpr size_t kMinItemsPerThread = 1 << 16;
+
+    /// Workers for @p items items: @p threads (0: hardware concurrency), at most one per kMinItemsPerThread.
+    inline unsigned workerCount(size_t items, unsigned threads)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        return static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, items / kMinItemsPerThread)));
+    }
+
+    namespace Detail {
+
+        /// Run work() on @p workers threads, the caller included; rethrow the first exception.
+        template <typename Work>
+        void run(unsigned workers, Work work)
+        {
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            auto guarded = [&](unsigned worker) {
+                try
+                {
+                    work(worker);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(workers > 0 ? workers - 1 : 0);
+            for (unsigned t = 1; t < workers; ++t)
+                threads.emplace_back(guarded, t);
+            guarded(0u);
+            for (std::thread &thread : threads)
+                thread.join();
+            if (error)
+                std::rethrow_exception(error);
+        }
+    };
+
+    /// Run fn(task) for every task in [0, tasks), handed out one at a time to at most @p workers threads.
+    template <typename Fn>
+    void runTasks(size_t tasks, unsigned workers, Fn fn)
+    {
+        workers = static_cast<unsigned>(std::min<size_t>(workers, tasks));
+        if (workers == 0)
+            return;
+
+        std::atomic<size_t> next{0};
+        Detail::run(workers, [&](unsigned) {
+            try
+            {
+                for (size_t task = next++; task < tasks; task = next++)
+                    fn(task);
+            }
+            catch (...)
+            {
+                next = tasks;       // the other workers finish their current task and stop
+                throw;
+            }
+        });
+    }
+
+    /// Run fn(worker, first, last) over [0, rows) split in @p workers equal chunks.
+    template <typename Fn>
+    void forEachChunk(size_t rows, unsigned workers, Fn fn)
+    {
+        workers = std::max(1u, workers);
+        const size_t chunk = (rows + workers - 1) / workers;
+        Detail::run(workers, [&](unsigned worker) {
+            const size_t first = std::min(rows, worker * chunk);
+            fn(worker, first, std::min(rows, first + chunk));
+        });
+    }
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+/// Counters of one parse context, see ParseStats.
+enum class ParseCounter : uint8_t {
+    GGASentences,
+    GSVSentences,
+    OtherSentences,
+    Bytes,
+    ChecksumFailures,       // "*hh" present and wrong; the sentence is still parsed
+    ParsingErrors,
+    InvalidDataErrors,
+    GSVResets,              // a GSV part 1 arrived before the previous sequence completed
+    ChecksumNs,             // stage times, on the sampled sentences only
+    ParseNs,
+    EpochEndNs,
+    TimedSentences,         // sentences sampled for the stage times
+    Count
+};
+
+/// Totals of the counters, indexed by ParseCounter.
+struct ParseCounters {
+    std::array<uint64_t, static_cast<size_t>(ParseCounter::Count)> values{};
+
+    uint64_t operator[](ParseCounter counter) const { return values[static_cast<size_t>(counter)]; }
+    uint64_t &operator[](ParseCounter counter) { return values[static_cast<size_t>(counter)]; }
+
+    ParseCounters &operator+=(const ParseCounters &other)
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] += other.values[i];
+        return *this;
+    }
+
+    uint64_t sentences() const
+    {
+        return (*this)[ParseCounter::GGASentences] + (*this)[ParseCounter::GSVSentences]
+            + (*this)[ParseCounter::OtherSentences];
+    }
+
+    /// Mean time per sentence of a stage counter (ChecksumNs, ParseNs, EpochEndNs).
+    double nsPerSentence(ParseCounter stage) const
+    {
+        const uint64_t timed = (*this)[ParseCounter::TimedSentences];
+        return timed ? double((*this)[stage]) / double(timed) : 0.0;
+    }
+};
+
+/**
+ * @brief Hot-path counters of a parse context, removed entirely unless the
+ * library is built with GNSS_PARSE_STATS.
+ *
+ * Each thread that records into a ParseStats gets its own shard, a cache
+ * line aligned block of counters, so threads never write the same line.
+ * A shard has one writer, so counting is a plain load and store (relaxed
+ * atomics, to let snapshot() read them from any thread). snapshot() sums
+ * the shards.
+ *
+ * Stage times cost two clock reads each, so they are taken on one
+ * sentence in kTimingInterval. Counts are exact.
+ *
+ * Without GNSS_PARSE_STATS the class is empty, kEnabled is false, add()
+ * does nothing and snapshot() returns zeros.
+ */
+class ParseStats {
+public:
+#ifdef GNSS_PARSE_STATS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+    static constexpr uint32_t kTimingInterval = 16;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> values[static_cast<size_t>(ParseCounter::Count)] = {};
+        std::thread::id thread;
+        Shard *next = nullptr;
+        uint32_t tick = 0;
+
+        void add(ParseCounter counter, uint64_t n = 1)
+        {
+            std::atomic<uint64_t> &value = values[static_cast<size_t>(counter)];
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        /// True for one call in kTimingInterval.
+        bool sampleTiming() { return ++tick % kTimingInterval == 0; }
+    };
+
+#ifdef GNSS_PARSE_STATS
+    ParseStats();
+    ~ParseStats();
+    ParseStats(const ParseStats &) = delete;
+    ParseStats &operator=(const ParseStats &) = delete;
+
+    /// Shard of the calling thread, created on first use.
+    Shard &local();
+
+    void add(ParseCounter counter, uint64_t n = 1) { local().add(counter, n); }
+
+    /// Sum of all shards; any thread.
+    ParseCounters snapshot() const;
+
+    /// Threads that have recorded so far.
+    size_t shards() const;
+
+private:
+    Shard &addShard();
+
+    const uint64_t m_id;                    // never reused, unlike the address
+    std::atomic<Shard *> m_shards{nullptr};
+#else
+    void add(ParseCounter, uint64_t = 1) {}
+    ParseCounters snapshot() const { return {}; }
+    size_t shards() const { return 0; }
+#endif
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include "Geodesy.hpp"
+#include "KalmanFilter.hpp"
+#include <cstdint>
+
+/**
+ * @brief Tuning of PositionFilter.
+ *
+ * Measurement sigma is DOP times the user equivalent range error (UERE)
+ * of the fix type: hdop drives east/north, vdop (or vdopFactor * hdop
+ * when the receiver does not report it) drives up.
+ */
+struct PositionFilterConfig {
+    double accelerationNoise = 0.5;     // m/s^2, white-noise acceleration (1 sigma)
+    double uereAutonomous = 2.5;        // m per unit of DOP, GGA fix quality 1
+    double uereDGPS = 0.8;              // fix quality 2
+    double uereRTK = 0.03;              // fix quality 4
+    double vdopFactor = 1.5;
+    double initialVelocitySigma = 10.0; // m/s
+    int64_t maxGapMs = 10000;           // longer gaps restart the track
+};
+
+/**
+ * @brief Filtered position and velocity of one epoch.
+ */
+struct TrackPoint {
+    int64_t timeMs = 0;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double altitude = 0.0;
+    double velocityEast = 0.0;          // m/s
+    double velocityNorth = 0.0;
+    double velocityUp = 0.0;
+    double sigmaHorizontal = 0.0;       // m, 1 sigma
+    double sigmaVertical = 0.0;
+};
+
+/**
+ * @brief Real-time constant-velocity Kalman filter over one receiver's GGA epochs.
+ *
+ * State is [e, n, u, ve, vn, vu] in an ENU frame anchored at the first fix
+ * of the track. ENU here is an exact rotation of ECEF, so the frame stays
+ * valid as the receiver moves; only the horizontal/vertical split of the
+ * noise model degrades hundreds of kilometers away from the anchor.
+ *
+ * With white-noise acceleration and a diagonal R the three axes never
+ * correlate, so the 6-state filter is run as three independent 2-state
+ * [position, velocity] filters: same estimates, a fraction of the work.
+ *
+ * One filter per receiver. Each update is allocation-free; epochs without
+ * a fix are skipped, and time gaps above maxGapMs or going backwards
+ * restart the track at the new fix.
+ */
+class PositionFilter {
+public:
+    explicit PositionFilter(const PositionFilterConfig &config = PositionFilterConfig());
+
+    /// Feed one parsed epoch; false (and @p out untouched) if it has no usable fix.
+    bool update(const GNSSData &data, TrackPoint &out);
+
+    /// Same as above from column values (EpochColumns, archives). vdop <= 0 means unknown.
+    bool update(int64_t timeMs, double latitude, double longitude, double altitude,
+                double hdop, double vdop, uint8_t fixQuality, TrackPoint &out);
+
+    void reset() { m_initialized = false; }
+    bool initialized() const { return m_initialized; }
+
+private:
+    using AxisFilter = KalmanFilter<2, 1>;
+
+    double uere(uint8_t fixQuality) const;
+    void start(const double variance[3]);
+    void output(int64_t timeMs, TrackPoint &out) const;
+
+    PositionFilterConfig m_config;
+    AxisFilter m_axis[3];               // east, north, up
+    AxisFilter::MeasurementModel m_h;
+    Geodesy::ENUFrame m_frame;
+    int64_t m_lastTimeMs = 0;
+    bool m_initialized = false;
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include "EpochColumns.hpp"
+#include "EpochRecord.hpp"
+#include "GNSSDataModel.hpp"
+#include "NMEAException.hpp"
+
+/**
+ * @brief Conversions between the std-only data model of gnsscore_std and
+ * the Qt one (GNSSData, QMap satellites, QDateTime) used by the GUI.
+ */
+namespace QtAdapter {
+
+    /// Fill @p data from @p record; the fix label is fixTypeLabel() of the code.
+    void toGNSSData(const EpochRecord &record, GNSSData &data);
+
+    /// Fill @p record from @p data; the fix code is fixQualityCode() of the label.
+    void toEpochRecord(const GNSSData &data, EpochRecord &record);
+
+    QMap<int, SATInfo> toSatMap(const SatelliteList &satellites);
+
+    /// Append @p data as one epoch of @p columns; the fix code is fixQualityCode() of the label.
+    void append(EpochColumns &columns, const GNSSData &data);
+
+    /// Fill @p data from epoch @p i of @p columns.
+    void toGNSSData(const EpochColumns &columns, size_t i, GNSSData &data);
+
+    /// Parse errors from a QString message (converted to UTF-8).
+    ParsingError parsingError(const QString &message);
+    InvalidDataError invalidData(const QString &message);
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include "RunningStats.hpp"
+#include "SatelliteId.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @brief SNR distribution of one satellite or constellation.
+ */
+struct SNRStats {
+    RunningStats stats;
+    P2Quantile median{0.5};
+    P2Quantile low{0.1};        // weak-signal tail
+
+    void add(double snr)
+    {
+        stats.add(snr);
+        median.add(snr);
+        low.add(snr);
+    }
+};
+
+/**
+ * @brief Incremental quality metrics of one receiver.
+ *
+ * Every update is O(1) per epoch (O(satellites) for a GSV sequence) and
+ * nothing is kept per epoch, so a live view can query the current state
+ * at any time without rescanning history.
+ *
+ * Feed GGA-derived fields with addFix() and completed GSV sequences with
+ * addSatellites(), as they come out of the parser, or whole epochs (from
+ * an archive, say) with update().
+ */
+class QualityStats {
+public:
+    /// Number of GGA fix quality codes (0..8).
+    static constexpr int kFixCodes = 9;
+
+    /// Fix type, satellite count and HDOP of one epoch.
+    void addFix(const GNSSData &data);
+
+    /// Per-satellite SNR of one completed GSV sequence; untracked satellites are skipped.
+    void addSatellites(const QMap<int, SATInfo> &satMap);
+
+    void update(const GNSSData &data)
+    {
+        addFix(data);
+        addSatellites(data.satMap);
+    }
+
+    void reset();
+
+    uint64_t epochCount() const { return m_epochs; }
+    const RunningStats &hdop() const { return m_hdop; }
+    const P2Quantile &hdopP95() const { return m_hdopP95; }
+    const RunningStats &satellites() const { return m_satellites; }
+
+    /// Distribution of the per-sequence average SNR (GNSSData::snrAvg).
+    const RunningStats &snrAvg() const { return m_snrAvg; }
+
+    uint64_t fixCount(uint8_t fixQuality) const;
+
+    /// Share of epochs with GGA fix quality @p fixQuality, 0 if none.
+    double fixRatio(uint8_t fixQuality) const;
+
+    /// SNR of satellite @p id (NMEA numbering), nullptr if never tracked.
+    const SNRStats *satellite(int id) const;
+    const std::unordered_map<int, SNRStats> &satelliteMap() const { return m_perSatellite; }
+
+    const SNRStats &constellation(GNSSSystem system) const { return m_perSystem[static_cast<size_t>(system)]; }
+
+private:
+    uint64_t m_epochs = 0;
+    RunningStats m_hdop;
+    P2Quantile m_hdopP95{0.95};
+    RunningStats m_satellites;
+    RunningStats m_snrAvg;
+    std::array<uint64_t, kFixCodes> m_fixCounts{};
+    std::unordered_map<int, SNRStats> m_perSatellite;
+    std::array<SNRStats, static_cast<size_t>(GNSSSystem::NavIC) + 1> m_perSystem;
+};
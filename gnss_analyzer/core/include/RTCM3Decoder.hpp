@@ -0,0 +1,156 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include "SatelliteId.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RTCM3 {
+
+    /**
+     * @brief MSB-first bit reader over an RTCM3 payload.
+     *
+     * Reads are served from a single big-endian 64-bit load, so a field
+     * costs one load and two shifts. No bounds checks are made per field:
+     * callers validate the total bit length up front (see decodeMSM).
+     */
+    class BitReader {
+    public:
+        BitReader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+        /// Read @p n bits (1..57) as an unsigned value.
+        uint64_t getBits(unsigned n)
+        {
+            const size_t byte = m_pos >> 3;
+            const unsigned shift = m_pos & 7;
+            uint64_t word = 0;
+            if (byte + 8 <= m_size)
+            {
+                for (int i = 0; i < 8; ++i)
+                    word = (word << 8) | m_data[byte + i];
+            }
+            else
+            {
+                for (size_t i = 0; i < 8; ++i)
+                    word = (word << 8) | (byte + i < m_size ? m_data[byte + i] : 0);
+            }
+            m_pos += n;
+            return (word << shift) >> (64 - n);
+        }
+
+        /// Read @p n bits (1..57) as a two's complement value.
+        int64_t getSignedBits(unsigned n)
+        {
+            const uint64_t raw = getBits(n);
+            return static_cast<int64_t>(raw << (64 - n)) >> (64 - n);
+        }
+
+        void skip(unsigned n) { m_pos += n; }
+        size_t position() const { return m_pos; }
+        size_t sizeBits() const { return m_size * 8; }
+
+    private:
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+    };
+
+    /**
+     * @brief CRC-24Q (Qualcomm) as used by the RTCM3 transport layer.
+     *
+     * Slicing-by-4 table implementation; "123456789" yields 0xCDE703.
+     */
+    uint32_t crc24q(const uint8_t *data, size_t length, uint32_t crc = 0);
+
+    /**
+     * @brief One MSM cell: a satellite/signal pair.
+     *
+     * Ranges are in meters, rates in m/s. Fields the message does not carry
+     * or flags as invalid are NaN.
+     */
+    struct MSMObservation {
+        GNSSSystem system = GNSSSystem::Unknown;
+        uint8_t satellite = 0;          // constellation-local number (1..64)
+        int satelliteId = 0;            // NMEA ID, same key as GNSSData::satMap
+        uint8_t signal = 0;             // RTCM signal ID (1..32)
+        double pseudorange = 0.0;
+        double phaseRange = 0.0;
+        double phaseRangeRate = 0.0;    // MSM7 only
+        double cnr = 0.0;               // dB-Hz
+        uint16_t lockTimeIndicator = 0;
+        bool halfCycleAmbiguity = false;
+    };
+
+    /**
+     * @brief Decoded MSM4/MSM7 message.
+     */
+    struct MSMEpoch {
+        uint16_t messageType = 0;
+        uint16_t stationId = 0;
+        GNSSSystem system = GNSSSystem::Unknown;
+        uint32_t epochTimeMs = 0;       // TOW (ms), GLONASS: time of day (ms)
+        uint8_t gloDayOfWeek = 0;
+        bool multipleMessage = false;   // more MSM for the same epoch follow
+        uint8_t iods = 0;
+        std::vector<MSMObservation> observations;
+    };
+
+    /**
+     * @brief Raw frame located by the Framer.
+     *
+     * Pointers reference the framer's buffer and stay valid until the next
+     * call to feed().
+     */
+    struct Frame {
+        const uint8_t *payload = nullptr;
+        size_t length = 0;
+        uint16_t messageType = 0;
+    };
+
+    /**
+     * @brief Incremental RTCM3 transport framer.
+     *
+     * Bytes from a log or a socket are pushed with feed(); next() yields
+     * CRC-checked frames. Non-RTCM bytes and corrupted frames are skipped
+     * and counted, so mixed NMEA/RTCM streams can be fed as is.
+     */
+    class Framer {
+    public:
+        void feed(const uint8_t *data, size_t length);
+        bool next(Frame &frame);
+
+        uint64_t crcErrors() const { return m_crcErrors; }
+        uint64_t skippedBytes() const { return m_skippedBytes; }
+
+    private:
+        std::vector<uint8_t> m_buffer;
+        size_t m_head = 0;
+        uint64_t m_crcErrors = 0;
+        uint64_t m_skippedBytes = 0;
+    };
+
+    /// Message type from the first 12 bits of a payload, 0 if too short.
+    uint16_t messageType(const uint8_t *payload, size_t length);
+
+    /// True for MSM4 (10x4) and MSM7 (10x7) observation messages.
+    bool isSupportedMSM(uint16_t messageType);
+
+    /**
+     * @brief Decode an MSM4/MSM7 payload (without transport header/CRC).
+     *
+     * @p epoch is overwritten; its observation vector is reused so that a
+     * long-lived epoch does not allocate in steady state.
+     *
+     * @return false if the payload is not an MSM4/MSM7 message.
+     * @throws ParsingError if the payload is truncated or inconsistent.
+     */
+    bool decodeMSM(const uint8_t *payload, size_t length, MSMEpoch &epoch);
+
+    /**
+     * @brief Merge observation C/N0 into a GSV-style satellite map.
+     *
+     * The first signal of each satellite is used as its SNR. Satellites not
+     * yet in the map get unknown elevation/azimuth, as parseGSV does.
+     */
+    void applyToSatMap(const MSMEpoch &epoch, QMap<int, SATInfo> &satMap);
+};
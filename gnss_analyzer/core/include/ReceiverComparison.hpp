@@ -0,0 +1,92 @@
+#pragma once
+#include "RunningStats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct EpochColumns;
+
+/**
+ * @brief Epoch-by-epoch differences of one receiver against a reference,
+ * over their common epochs (structure of arrays).
+ *
+ * Position differences are other minus reference, in meters, in the ENU
+ * frame of the reference position of that epoch; NaN unless both
+ * receivers have a fix. snrDelta is the mean SNR difference (dB-Hz) over
+ * the satellites tracked by both, NaN if there are none.
+ */
+struct ComparisonColumns {
+    std::vector<int64_t> timeMs;            // reference epoch time
+    std::vector<uint64_t> referenceRow;
+    std::vector<uint64_t> otherRow;
+    std::vector<double> east;
+    std::vector<double> north;
+    std::vector<double> up;
+    std::vector<float> snrDelta;
+    std::vector<uint8_t> commonSatellites;
+    std::vector<uint8_t> fixAgree;          // 1 if both report the same GGA fix quality
+
+    size_t size() const { return timeMs.size(); }
+};
+
+/**
+ * @brief Aggregates of a ComparisonColumns.
+ */
+struct ComparisonSummary {
+    size_t referenceEpochs = 0;
+    size_t otherEpochs = 0;
+    size_t matched = 0;                     // common epochs
+    RunningStats east;                      // epochs where both have a fix
+    RunningStats north;
+    RunningStats up;
+    RunningStats horizontal;
+    RunningStats snrDelta;                  // one sample per common tracked satellite
+    size_t fixAgreements = 0;
+    std::unordered_map<int, RunningStats> satelliteSnrDelta;
+
+    /// Share of the common epochs with the same fix quality, 0 if none.
+    double fixAgreement() const { return matched ? static_cast<double>(fixAgreements) / matched : 0.0; }
+};
+
+struct ReceiverComparison {
+    size_t receiver = 0;                    // index in the receiver list
+    ComparisonColumns columns;
+    ComparisonSummary summary;
+};
+
+/**
+ * @brief Comparison of co-located receivers.
+ *
+ * Each receiver's epochs are aligned with the reference's by a merge join
+ * on the integer timestamps, then the matched rows are processed in a
+ * columnar pass: batch ECEF conversion of both positions, rotation of the
+ * difference into the reference ENU, a merge of the two ID-sorted
+ * satellite lists for SNR deltas, and fix quality comparison.
+ *
+ * Joins run one per receiver and the columnar pass in fixed-size chunks
+ * of all receivers, both spread over worker threads, so checking one
+ * receiver against dozens is one parallel pass over the data.
+ */
+namespace Comparison {
+
+    /**
+     * @brief Rows of @p a and @p b whose timestamps are within @p toleranceMs.
+     *
+     * Both inputs must be sorted by time (std::invalid_argument otherwise);
+     * each row is matched at most once.
+     */
+    void mergeJoin(const EpochColumns &a, const EpochColumns &b, int64_t toleranceMs,
+                   std::vector<uint64_t> &rowsA, std::vector<uint64_t> &rowsB);
+
+    /**
+     * @brief Compare every receiver of @p receivers with receivers[reference].
+     *
+     * Every receiver must be sorted by time; this is checked, with the
+     * other arguments, before any work starts (std::invalid_argument).
+     *
+     * @return One entry per receiver other than the reference, in order.
+     */
+    std::vector<ReceiverComparison> compare(const std::vector<const EpochColumns *> &receivers, size_t reference,
+                                            int64_t toleranceMs = 0, unsigned threads = 0);
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * @brief Mean and variance of the last N samples, kept in a ring buffer.
+ *
+ * add() is O(1): the running sums are updated with the incoming and the
+ * evicted sample. Sums are taken relative to the first sample after a
+ * reset, and recomputed from the buffer each time it wraps, so rounding
+ * errors cannot accumulate over long streams (amortized O(1)).
+ */
+template <size_t N>
+class RollingWindow {
+public:
+    static_assert(N > 1, "RollingWindow needs room for at least two samples");
+
+    void add(double x)
+    {
+        if (m_count == 0)
+            m_offset = x;
+        const double d = x - m_offset;
+        if (m_count == N)
+        {
+            const double old = m_samples[m_head];
+            m_sum -= old;
+            m_sum2 -= old * old;
+        }
+        else
+        {
+            ++m_count;
+        }
+        m_samples[m_head] = d;
+        m_sum += d;
+        m_sum2 += d * d;
+        if (++m_head == N)
+        {
+            m_head = 0;
+            resum();
+        }
+    }
+
+    void reset() { *this = RollingWindow(); }
+
+    static constexpr size_t capacity() { return N; }
+    size_t count() const { return m_count; }
+    bool full() const { return m_count == N; }
+
+    /// Most recent sample; only valid when count() > 0.
+    double last() const { return m_samples[(m_head + N - 1) % N] + m_offset; }
+
+    double mean() const { return m_count ? m_offset + m_sum / static_cast<double>(m_count) : 0.0; }
+
+    /// Sample variance (n - 1 denominator), 0 below two samples.
+    double variance() const
+    {
+        if (m_count < 2)
+            return 0.0;
+        const double n = static_cast<double>(m_count);
+        const double v = (m_sum2 - m_sum * m_sum / n) / (n - 1.0);
+        return v > 0.0 ? v : 0.0;
+    }
+
+    double stddev() const { return std::sqrt(variance()); }
+
+private:
+    void resum()
+    {
+        m_sum = 0.0;
+        m_sum2 = 0.0;
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            m_sum += m_samples[i];
+            m_sum2 += m_samples[i] * m_samples[i];
+        }
+    }
+
+    std::array<double, N> m_samples{};
+    size_t m_head = 0;
+    size_t m_count = 0;
+    double m_offset = 0.0;
+    double m_sum = 0.0;
+    double m_sum2 = 0.0;
+};
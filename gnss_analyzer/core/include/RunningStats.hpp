@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Streaming mean, variance and extrema (Welford's algorithm).
+ *
+ * add() is O(1) and numerically stable; two accumulators over disjoint
+ * samples can be combined with merge().
+ */
+class RunningStats {
+public:
+    void add(double x)
+    {
+        ++m_count;
+        const double delta = x - m_mean;
+        m_mean += delta / static_cast<double>(m_count);
+        m_m2 += delta * (x - m_mean);
+        if (m_count == 1 || x < m_min)
+            m_min = x;
+        if (m_count == 1 || x > m_max)
+            m_max = x;
+    }
+
+    void merge(const RunningStats &other);
+    void reset() { *this = RunningStats(); }
+
+    uint64_t count() const { return m_count; }
+    double mean() const { return m_mean; }
+    double min() const { return m_min; }
+    double max() const { return m_max; }
+
+    /// Sample variance (n - 1 denominator), 0 below two samples.
+    double variance() const { return m_count > 1 ? m_m2 / static_cast<double>(m_count - 1) : 0.0; }
+    double stddev() const;
+
+private:
+    uint64_t m_count = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+};
+
+/**
+ * @brief Streaming quantile estimate in constant memory (P² algorithm).
+ *
+ * Jain & Chlamtac's five-marker estimator: no samples are stored, each
+ * add() moves the markers with a piecewise-parabolic fit. Exact while
+ * fewer than five samples have been seen.
+ */
+class P2Quantile {
+public:
+    /// @p quantile in (0, 1), e.g. 0.5 for the median.
+    explicit P2Quantile(double quantile = 0.5);
+
+    void add(double x);
+    void reset() { *this = P2Quantile(m_quantile); }
+
+    uint64_t count() const { return m_count; }
+    double quantile() const { return m_quantile; }
+
+    /// Current estimate, 0 if empty.
+    double value() const;
+
+private:
+    double parabolic(int i, double d) const;
+    double linear(int i, int d) const;
+
+    double m_quantile;
+    uint64_t m_count = 0;
+    double m_height[5] = {};
+    double m_position[5] = {};
+    double m_desired[5] = {};
+    double m_increment[5] = {};
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief GNSS constellations known to the analyzer.
+ */
+enum class GNSSSystem : uint8_t
+{
+    Unknown = 0,
+    GPS = 1,
+    SBAS = 2,
+    GLONASS = 3,
+    Galileo = 4,
+    BeiDou = 5,
+    QZSS = 6,
+    NavIC = 7,
+};
+
+/**
+ * @brief Satellite numbering shared by the NMEA and RTCM paths.
+ *
+ * SATInfo maps are keyed by the NMEA satellite ID. Constellations that
+ * legacy NMEA does not number use the extended ranges most receivers emit:
+ *
+ *   GPS      1-32      SBAS    33-64 (PRN 120-151)
+ *   GLONASS  65-96     QZSS    193-202
+ *   Galileo  301-336   BeiDou  401-463
+ *   NavIC    501-514
+ */
+namespace SatelliteId {
+
+    /// Convert a constellation-local satellite number (1-based) to an NMEA ID, 0 if unmappable.
+    constexpr int toNMEA(GNSSSystem system, int prn)
+    {
+        if (prn <= 0)
+            return 0;
+        switch (system)
+        {
+            case GNSSSystem::GPS:     return prn <= 32 ? prn : 0;
+            case GNSSSystem::SBAS:    return prn <= 32 ? prn + 32 : 0;
+            case GNSSSystem::GLONASS: return prn <= 32 ? prn + 64 : 0;
+            case GNSSSystem::QZSS:    return prn <= 10 ? prn + 192 : 0;
+            case GNSSSystem::Galileo: return prn <= 36 ? prn + 300 : 0;
+            case GNSSSystem::BeiDou:  return prn <= 63 ? prn + 400 : 0;
+            case GNSSSystem::NavIC:   return prn <= 14 ? prn + 500 : 0;
+            default:                  return 0;
+        }
+    }
+
+    /// Constellation owning an NMEA satellite ID.
+    constexpr GNSSSystem systemOf(int id)
+    {
+        if (id >= 1 && id <= 32)    return GNSSSystem::GPS;
+        if (id >= 33 && id <= 64)   return GNSSSystem::SBAS;
+        if (id >= 65 && id <= 96)   return GNSSSystem::GLONASS;
+        if (id >= 193 && id <= 202) return GNSSSystem::QZSS;
+        if (id >= 301 && id <= 336) return GNSSSystem::Galileo;
+        if (id >= 401 && id <= 463) return GNSSSystem::BeiDou;
+        if (id >= 501 && id <= 514) return GNSSSystem::NavIC;
+        return GNSSSystem::Unknown;
+    }
+};
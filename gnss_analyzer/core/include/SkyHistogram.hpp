@@ -0,0 +1,105 @@
+#pragma once
+#include "GNSSDataModel.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct EpochColumns;
+
+/**
+ * @brief Elevation x azimuth histogram of satellite observations (skyplot
+ * and SNR heatmap) for one receiver.
+ *
+ * Bins live in flat row-major arrays (elevation rows, azimuth columns).
+ * Each bin counts observations, counts tracked ones (SNR > 0) and sums
+ * their SNR, so histograms over disjoint data merge by addition. build()
+ * uses that for a per-thread reduction over long histories.
+ */
+class SkyHistogram {
+public:
+    /// Bin sizes in degrees; 90 / elevationStepDeg and 360 / azimuthStepDeg are rounded up.
+    explicit SkyHistogram(double elevationStepDeg = 1.0, double azimuthStepDeg = 5.0);
+
+    /// One observation; ignored if the angles are unknown (non-finite) or out of range.
+    void add(double elevationDeg, double azimuthDeg, double snr)
+    {
+        if (!(elevationDeg >= 0.0 && elevationDeg <= 90.0 && azimuthDeg >= 0.0 && azimuthDeg <= 360.0))
+            return;
+        const size_t i = index(elevationDeg, azimuthDeg);
+        ++m_count[i];
+        if (snr > 0.0)
+        {
+            ++m_tracked[i];
+            m_snrSum[i] += snr;
+        }
+    }
+
+    void add(const QMap<int, SATInfo> &satMap);
+
+    /// Satellite rows [firstRow, lastRow) of @p columns.
+    void add(const EpochColumns &columns, size_t firstRow, size_t lastRow);
+
+    /// Add the bins of a histogram with the same binning.
+    void merge(const SkyHistogram &other);
+
+    void clear();
+
+    /**
+     * @brief Histogram of all satellite rows of @p columns.
+     *
+     * Rows are split across @p threads workers (0: hardware concurrency),
+     * each filling a private histogram that is merged at the end.
+     */
+    static SkyHistogram build(const EpochColumns &columns, double elevationStepDeg = 1.0,
+                              double azimuthStepDeg = 5.0, unsigned threads = 0);
+
+    int elevationBins() const { return m_elevationBins; }
+    int azimuthBins() const { return m_azimuthBins; }
+    double elevationStep() const { return m_elevationStep; }
+    double azimuthStep() const { return m_azimuthStep; }
+
+    uint64_t count(int elevationBin, int azimuthBin) const { return m_count[flat(elevationBin, azimuthBin)]; }
+    uint64_t tracked(int elevationBin, int azimuthBin) const { return m_tracked[flat(elevationBin, azimuthBin)]; }
+
+    /// Mean SNR of the tracked observations of a bin, NaN if none.
+    double meanSnr(int elevationBin, int azimuthBin) const;
+
+    uint64_t totalCount() const;
+
+    /**
+     * @brief Obstruction mask: per azimuth bin, the elevation (deg) up to
+     * which the sky looks blocked.
+     *
+     * A bin is obstructed when it holds at least @p minSamples observations
+     * and either less than @p minTrackedRatio of them were tracked or their
+     * mean SNR is below @p minSnr. The mask of an azimuth sector is the
+     * upper edge of its highest obstructed bin, 0 for a clear sector.
+     */
+    std::vector<double> obstructionMask(double minSnr = 30.0, uint64_t minSamples = 10,
+                                        double minTrackedRatio = 0.5) const;
+
+private:
+    size_t flat(int elevationBin, int azimuthBin) const
+    {
+        return static_cast<size_t>(elevationBin) * m_azimuthBins + azimuthBin;
+    }
+
+    size_t index(double elevationDeg, double azimuthDeg) const
+    {
+        // 90 deg and 360 deg fall in the last bins
+        const int e = std::min(static_cast<int>(elevationDeg * m_elevationScale), m_elevationBins - 1);
+        const int a = std::min(static_cast<int>(azimuthDeg * m_azimuthScale), m_azimuthBins - 1);
+        return flat(e, a);
+    }
+
+    double m_elevationStep;
+    double m_azimuthStep;
+    double m_elevationScale;
+    double m_azimuthScale;
+    int m_elevationBins;
+    int m_azimuthBins;
+    std::vector<uint64_t> m_count;
+    std::vector<uint64_t> m_tracked;
+    std::vector<double> m_snrSum;
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct EpochColumns;
+struct GNSSData;
+
+/**
+ * @brief One position returned by a SpatialIndex query.
+ */
+struct SpatialHit {
+    uint32_t id = 0;                // receiver
+    int64_t timeMs = 0;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double distance = 0.0;          // m, radius and nearest queries only
+};
+
+/**
+ * @brief In-memory index of fleet positions for bounding-box, radius and
+ * nearest-neighbour queries.
+ *
+ * Points are kept sorted by a 64-bit Z-order (Morton) key of their
+ * quantized latitude/longitude, so that every grid cell at every level is
+ * one contiguous key range. A query covers its area with at most 5 x 5
+ * cells of a suitable level, binary-searches the coalesced key ranges and
+ * filters the few points inside exactly; cost is O(log n) plus the points
+ * near the area.
+ *
+ * New points go to a small unsorted buffer that queries scan linearly and
+ * that is merged into the sorted arrays once it holds deltaLimit points.
+ *
+ * History mode keeps every point inserted. Latest mode keeps one point
+ * per id, the newest one: inserting replaces the previous position of
+ * that id.
+ *
+ * Distances are great-circle distances on a sphere of the mean Earth
+ * radius. Not thread-safe; queries are const and may run concurrently
+ * with each other.
+ */
+class SpatialIndex {
+public:
+    enum class Mode { History, Latest };
+
+    explicit SpatialIndex(Mode mode = Mode::History, size_t deltaLimit = 4096);
+
+    /// Add one position; in Latest mode, older than the stored one is ignored.
+    void insert(uint32_t id, double latitude, double longitude, int64_t timeMs);
+
+    /// Add the position of a GGA epoch; epochs without a fix are skipped.
+    void insert(uint32_t id, const GNSSData &data);
+
+    /// Bulk-load the fixes of one receiver (the last one only in Latest mode).
+    void insert(uint32_t id, const EpochColumns &columns);
+
+    /// Merge pending inserts into the sorted arrays now.
+    void flush();
+
+    void clear();
+
+    size_t size() const;
+    Mode mode() const { return m_mode; }
+
+    /**
+     * @brief Points with latitude in [minLat, maxLat] and longitude in
+     * [minLon, maxLon] (degrees); minLon > maxLon wraps over 180 deg.
+     */
+    size_t boundingBox(double minLat, double minLon, double maxLat, double maxLon,
+                       std::vector<SpatialHit> &out) const;
+
+    /// Points within @p radiusM meters, sorted by distance.
+    size_t radius(double latitude, double longitude, double radiusM, std::vector<SpatialHit> &out) const;
+
+    /// The @p k points nearest to the query point, sorted by distance.
+    size_t nearest(double latitude, double longitude, size_t k, std::vector<SpatialHit> &out) const;
+
+    /// Z-order key of a position (exposed for tests and external sharding).
+    static uint64_t key(double latitude, double longitude);
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t id;
+        int64_t timeMs;
+        double latitude;
+        double longitude;
+    };
+
+    static constexpr uint64_t kInDelta = uint64_t(1) << 63;
+
+    void add(const Entry &entry);
+    void eraseSlot(uint64_t slot);
+    void collect(double minLat, double minLon, double maxLat, double maxLon,
+                 std::vector<SpatialHit> &out) const;
+    void rebuildSlots();
+
+    Mode m_mode;
+    size_t m_deltaLimit;
+
+    // Sorted by key, structure of arrays
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_ids;
+    std::vector<int64_t> m_times;
+    std::vector<double> m_latitudes;
+    std::vector<double> m_longitudes;
+    std::vector<uint8_t> m_dead;            // Latest mode: replaced, dropped at next merge
+    size_t m_deadCount = 0;
+
+    std::vector<Entry> m_delta;
+
+    // Latest mode: id -> index in the sorted arrays, or kInDelta | index in m_delta
+    std::unordered_map<uint32_t, uint64_t> m_slots;
+};
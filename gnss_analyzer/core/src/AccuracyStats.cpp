@@ -0,0 +1,314 @@
+#include "AccuracyStats.hpp"
+#include "EpochColumns.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+    constexpr size_t kBlock = 256;
+    constexpr size_t kSelectBins = 4096;
+
+    bool keep(const EpochColumns &columns, size_t i, uint8_t fixQuality)
+    {
+        const uint8_t q = columns.fixQuality[i];
+        return q > 0 && (fixQuality == 0 || q == fixQuality)
+            && std::isfinite(columns.latitude[i]) && std::isfinite(columns.longitude[i])
+            && std::isfinite(columns.altitude[i]);
+    }
+
+    AccuracyReport computeAround(const EpochColumns &columns, const Accuracy::Reference *reference,
+                                 uint8_t fixQuality, unsigned threads)
+    {
+        AccuracyReport report;
+        const size_t rows = columns.size();
+
+        size_t firstFix = 0;
+        while (firstFix < rows && !keep(columns, firstFix, fixQuality))
+            ++firstFix;
+        if (firstFix == rows)
+            return report;
+
+        // Without a reference, ENU is taken around the first fix and re-centered on the centroid below
+        const Geodesy::ENUFrame frame = reference
+            ? Geodesy::makeENUFrame(reference->latitude, reference->longitude, reference->altitude)
+            : Geodesy::makeENUFrame(columns.latitude[firstFix], columns.longitude[firstFix], columns.altitude[firstFix]);
+
+        const unsigned workers = Parallel::workerCount(rows, threads);
+
+        // Pass 1: fixes per chunk, so that each worker writes its own slice
+        std::vector<size_t> offset(workers + 1, 0);
+        Parallel::forEachChunk(rows, workers, [&](unsigned t, size_t first, size_t last) {
+            size_t kept = 0;
+            for (size_t i = first; i < last; ++i)
+                kept += keep(columns, i, fixQuality);
+            offset[t + 1] = kept;
+        });
+        for (unsigned t = 0; t < workers; ++t)
+            offset[t + 1] += offset[t];
+        const size_t n = offset[workers];
+
+        // Pass 2: ENU of every fix and its moments
+        std::vector<double> east(n), north(n), up(n);
+        std::vector<RunningStats> stats(3 * workers);
+        Parallel::forEachChunk(rows, workers, [&](unsigned t, size_t first, size_t last) {
+            double lat[kBlock], lon[kBlock], alt[kBlock];
+            size_t out = offset[t];
+            size_t i = first;
+            while (i < last)
+            {
+                size_t m = 0;
+                for (; i < last && m < kBlock; ++i)
+                {
+                    if (!keep(columns, i, fixQuality))
+                        continue;
+                    lat[m] = columns.latitude[i];
+                    lon[m] = columns.longitude[i];
+                    alt[m] = columns.altitude[i];
+                    ++m;
+                }
+                Geodesy::llaToEnu(frame, lat, lon, alt, m, &east[out], &north[out], &up[out]);
+                for (size_t k = out; k < out + m; ++k)
+                {
+                    stats[3 * t].add(east[k]);
+                    stats[3 * t + 1].add(north[k]);
+                    stats[3 * t + 2].add(up[k]);
+                }
+                out += m;
+            }
+        });
+        for (unsigned t = 1; t < workers; ++t)
+            for (int axis = 0; axis < 3; ++axis)
+                stats[axis].merge(stats[3 * t + axis]);
+
+        const double centerEast = reference ? 0.0 : stats[0].mean();
+        const double centerNorth = reference ? 0.0 : stats[1].mean();
+        const double centerUp = reference ? 0.0 : stats[2].mean();
+
+        // Pass 3: horizontal and vertical error magnitudes
+        std::vector<double> horizontal(n), vertical(n);
+        const unsigned errorWorkers = Parallel::workerCount(n, threads);
+        std::vector<double> sumSquares(errorWorkers, 0.0);
+        Parallel::forEachChunk(n, errorWorkers, [&](unsigned t, size_t first, size_t last) {
+            double sum = 0.0;
+            for (size_t i = first; i < last; ++i)
+            {
+                const double de = east[i] - centerEast;
+                const double dn = north[i] - centerNorth;
+                const double h2 = de * de + dn * dn;
+                horizontal[i] = std::sqrt(h2);
+                vertical[i] = std::fabs(up[i] - centerUp);
+                sum += h2;
+            }
+            sumSquares[t] = sum;
+        });
+        double totalSquares = 0.0;
+        for (double s : sumSquares)
+            totalSquares += s;
+
+        const std::vector<double> cep = Accuracy::percentiles(horizontal, {0.5, 0.95}, threads);
+        const std::vector<double> vep = Accuracy::percentiles(vertical, {0.5, 0.95}, threads);
+
+        report.epochs = n;
+        report.meanEast = stats[0].mean() - centerEast;
+        report.meanNorth = stats[1].mean() - centerNorth;
+        report.meanUp = stats[2].mean() - centerUp;
+        report.sigmaEast = stats[0].stddev();
+        report.sigmaNorth = stats[1].stddev();
+        report.sigmaUp = stats[2].stddev();
+        report.cep50 = cep[0];
+        report.cep95 = cep[1];
+        report.drms = std::sqrt(totalSquares / static_cast<double>(n));
+        report.twoDrms = 2.0 * report.drms;
+        report.vertical50 = vep[0];
+        report.vertical95 = vep[1];
+        return report;
+    }
+}
+
+namespace Accuracy {
+
+    AccuracyReport compute(const EpochColumns &columns, uint8_t fixQuality, unsigned threads)
+    {
+        return computeAround(columns, nullptr, fixQuality, threads);
+    }
+
+    AccuracyReport compute(const EpochColumns &columns, const Reference &reference,
+                           uint8_t fixQuality, unsigned threads)
+    {
+        return computeAround(columns, &reference, fixQuality, threads);
+    }
+
+    std::vector<double> percentiles(const std::vector<double> &values, const std::vector<double> &quantiles,
+                                    unsigned threads)
+    {
+        std::vector<double> result(quantiles.size(), std::numeric_limits<double>::quiet_NaN());
+        if (values.empty())
+            return result;
+
+        // Range and count of the finite values; NaN and infinities take no rank
+        const unsigned workers = Parallel::workerCount(values.size(), threads);
+        std::vector<double> lows(workers, std::numeric_limits<double>::infinity());
+        std::vector<double> highs(workers, -std::numeric_limits<double>::infinity());
+        std::vector<size_t> finite(workers, 0);
+        Parallel::forEachChunk(values.size(), workers, [&](unsigned t, size_t first, size_t last) {
+            double lo = lows[t], hi = highs[t];
+            size_t count = 0;
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!std::isfinite(values[i]))
+                    continue;
+                lo = std::min(lo, values[i]);
+                hi = std::max(hi, values[i]);
+                ++count;
+            }
+            lows[t] = lo;
+            highs[t] = hi;
+            finite[t] = count;
+        });
+        size_t n = 0;
+        for (size_t count : finite)
+            n += count;
+        if (n == 0)
+            return result;
+
+        std::vector<size_t> ranks(quantiles.size());
+        for (size_t k = 0; k < quantiles.size(); ++k)
+        {
+            const double r = std::ceil(std::clamp(quantiles[k], 0.0, 1.0) * static_cast<double>(n));
+            ranks[k] = r < 1.0 ? 0 : std::min(n - 1, static_cast<size_t>(r) - 1);
+        }
+
+        const double lo = *std::min_element(lows.begin(), lows.end());
+        const double hi = *std::max_element(highs.begin(), highs.end());
+        if (!(hi > lo))
+        {
+            std::fill(result.begin(), result.end(), lo);
+            return result;
+        }
+
+        // (x - lo) * scale is monotonic in x, so bins are ordered like the values
+        const double scale = static_cast<double>(kSelectBins) / (hi - lo);
+        auto binOf = [lo, scale](double x) {
+            return std::min(static_cast<size_t>((x - lo) * scale), kSelectBins - 1);
+        };
+
+        std::vector<std::vector<uint64_t>> histograms(workers, std::vector<uint64_t>(kSelectBins, 0));
+        Parallel::forEachChunk(values.size(), workers, [&](unsigned t, size_t first, size_t last) {
+            uint64_t *h = histograms[t].data();
+            for (size_t i = first; i < last; ++i)
+                if (std::isfinite(values[i]))
+                    ++h[binOf(values[i])];
+        });
+        for (unsigned t = 1; t < workers; ++t)
+            for (size_t b = 0; b < kSelectBins; ++b)
+                histograms[0][b] += histograms[t][b];
+        const std::vector<uint64_t> &histogram = histograms[0];
+
+        // Bin of each rank and the rank inside that bin
+        std::vector<size_t> bins(ranks.size()), inside(ranks.size());
+        for (size_t k = 0; k < ranks.size(); ++k)
+        {
+            uint64_t below = 0;
+            size_t b = 0;
+            while (below + histogram[b] <= ranks[k])
+                below += histogram[b++];
+            bins[k] = b;
+            inside[k] = ranks[k] - below;
+        }
+        std::vector<size_t> targets = bins;
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+        std::vector<std::vector<std::vector<double>>> gathered(workers, std::vector<std::vector<double>>(targets.size()));
+        Parallel::forEachChunk(values.size(), workers, [&](unsigned t, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!std::isfinite(values[i]))
+                    continue;
+                const size_t b = binOf(values[i]);
+                const auto it = std::lower_bound(targets.begin(), targets.end(), b);
+                if (it != targets.end() && *it == b)
+                    gathered[t][it - targets.begin()].push_back(values[i]);
+            }
+        });
+        for (size_t j = 0; j < targets.size(); ++j)
+        {
+            std::vector<double> &candidates = gathered[0][j];
+            for (unsigned t = 1; t < workers; ++t)
+                candidates.insert(candidates.end(), gathered[t][j].begin(), gathered[t][j].end());
+        }
+
+        for (size_t k = 0; k < ranks.size(); ++k)
+        {
+            const size_t j = std::lower_bound(targets.begin(), targets.end(), bins[k]) - targets.begin();
+            std::vector<double> &candidates = gathered[0][j];
+            std::nth_element(candidates.begin(), candidates.begin() + inside[k], candidates.end());
+            result[k] = candidates[inside[k]];
+        }
+        return result;
+    }
+};
+
+AccuracyStream::AccuracyStream(const Accuracy::Reference &reference, uint8_t fixQuality)
+    : m_frame(Geodesy::makeENUFrame(reference.latitude, reference.longitude, reference.altitude)),
+      m_fixQuality(fixQuality)
+{
+}
+
+void AccuracyStream::add(const GNSSData &data)
+{
+    const uint8_t q = fixQualityCode(data.fixType);
+    if (q == 0 || (m_fixQuality != 0 && q != m_fixQuality))
+        return;
+    add(data.latitude, data.longitude, data.altitude);
+}
+
+void AccuracyStream::add(double latitude, double longitude, double altitude)
+{
+    double e, n, u;
+    Geodesy::llaToEnu(m_frame, &latitude, &longitude, &altitude, 1, &e, &n, &u);
+    m_east.add(e);
+    m_north.add(n);
+    m_up.add(u);
+    const double h2 = e * e + n * n;
+    m_sumSquares += h2;
+    m_cep50.add(std::sqrt(h2));
+    m_cep95.add(std::sqrt(h2));
+    m_vertical50.add(std::fabs(u));
+    m_vertical95.add(std::fabs(u));
+}
+
+void AccuracyStream::reset()
+{
+    m_east.reset();
+    m_north.reset();
+    m_up.reset();
+    m_sumSquares = 0.0;
+    m_cep50.reset();
+    m_cep95.reset();
+    m_vertical50.reset();
+    m_vertical95.reset();
+}
+
+AccuracyReport AccuracyStream::report() const
+{
+    AccuracyReport report;
+    report.epochs = m_east.count();
+    if (report.epochs == 0)
+        return report;
+    report.meanEast = m_east.mean();
+    report.meanNorth = m_north.mean();
+    report.meanUp = m_up.mean();
+    report.sigmaEast = m_east.stddev();
+    report.sigmaNorth = m_north.stddev();
+    report.sigmaUp = m_up.stddev();
+    report.cep50 = m_cep50.value();
+    report.cep95 = m_cep95.value();
+    report.drms = std::sqrt(m_sumSquares / static_cast<double>(report.epochs));
+    report.twoDrms = 2.0 * report.drms;
+    report.vertical50 = m_vertical50.value();
+    report.vertical95 = m_vertical95.value();
+    return report;
+}
@@ -0,0 +1,190 @@
+#include "AllanDeviation.hpp"
+#include "EpochColumns.hpp"
+#include "Geodesy.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr size_t kMaxIntervalSamples = 1 << 16;
+    constexpr size_t kBlock = 256;
+
+    AllanPoint deviation(const std::vector<double> &x, double tau0, size_t m,
+                         const std::vector<Allan::Segment> &segments)
+    {
+        AllanPoint point;
+        point.factor = m;
+        point.tau = static_cast<double>(m) * tau0;
+
+        double overlapping = 0.0, separate = 0.0;
+        size_t overlappingTerms = 0, separateTerms = 0;
+        for (const Allan::Segment &segment : segments)
+        {
+            if (segment.second - segment.first < 2 * m)
+                continue;
+            const size_t last = segment.second - 2 * m;
+            for (size_t i = segment.first; i <= last; ++i)
+            {
+                const double d = x[i + 2 * m] - 2.0 * x[i + m] + x[i];
+                overlapping += d * d;
+            }
+            overlappingTerms += last - segment.first + 1;
+            for (size_t i = segment.first; i <= last; i += m)
+            {
+                const double d = x[i + 2 * m] - 2.0 * x[i + m] + x[i];
+                separate += d * d;
+                ++separateTerms;
+            }
+        }
+
+        const double m2 = static_cast<double>(m) * static_cast<double>(m);
+        point.terms = overlappingTerms;
+        if (overlappingTerms > 0)
+            point.oadev = std::sqrt(overlapping / (2.0 * m2 * static_cast<double>(overlappingTerms)));
+        if (separateTerms > 0)
+            point.adev = std::sqrt(separate / (2.0 * m2 * static_cast<double>(separateTerms)));
+        return point;
+    }
+
+    /// Deviation for every factor from the cumulative sums @p x, factors handed out to workers.
+    std::vector<AllanPoint> fromSums(const std::vector<double> &x, double tau0, const std::vector<size_t> &factors,
+                                     const std::vector<Allan::Segment> &segments, unsigned threads)
+    {
+        std::vector<AllanPoint> points(factors.size());
+        if (factors.empty())
+            return points;
+
+        // Every factor is one pass over the samples
+        const unsigned workers = Parallel::workerCount(x.size() * factors.size(), threads);
+        Parallel::runTasks(factors.size(), workers, [&](size_t k) {
+            points[k] = deviation(x, tau0, factors[k], segments);
+        });
+        return points;
+    }
+
+    bool keep(const EpochColumns &columns, size_t i, uint8_t fixQuality)
+    {
+        const uint8_t q = columns.fixQuality[i];
+        return q > 0 && (fixQuality == 0 || q == fixQuality)
+            && std::isfinite(columns.latitude[i]) && std::isfinite(columns.longitude[i])
+            && std::isfinite(columns.altitude[i]);
+    }
+}
+
+namespace Allan {
+
+    std::vector<size_t> octaveFactors(size_t samples, int perOctave)
+    {
+        perOctave = std::max(perOctave, 1);
+        std::vector<size_t> factors;
+        for (int k = 0;; ++k)
+        {
+            const size_t m = static_cast<size_t>(std::llround(std::exp2(static_cast<double>(k) / perOctave)));
+            if (2 * m > samples)
+                break;
+            if (factors.empty() || m != factors.back())
+                factors.push_back(m);
+        }
+        return factors;
+    }
+
+    std::vector<AllanPoint> compute(const std::vector<double> &y, double tau0,
+                                    const std::vector<size_t> &factors,
+                                    const std::vector<Segment> &segments, unsigned threads)
+    {
+        std::vector<double> x(y.size() + 1);
+        x[0] = 0.0;
+        for (size_t i = 0; i < y.size(); ++i)
+            x[i + 1] = x[i] + y[i];
+        const std::vector<Segment> runs = segments.empty() ? std::vector<Segment>{{0, y.size()}} : segments;
+        return fromSums(x, tau0, factors, runs, threads);
+    }
+
+    PositionDeviation compute(const EpochColumns &columns, const std::vector<size_t> &factors,
+                              uint8_t fixQuality, unsigned threads)
+    {
+        PositionDeviation result;
+        const size_t rows = columns.size();
+
+        size_t firstFix = 0;
+        while (firstFix < rows && !keep(columns, firstFix, fixQuality))
+            ++firstFix;
+        if (firstFix == rows)
+            return result;
+
+        // tau0: median of a bounded sample of intervals between consecutive fixes
+        std::vector<int64_t> intervals;
+        const size_t stride = std::max<size_t>(1, rows / kMaxIntervalSamples);
+        for (size_t i = firstFix + 1; i < rows; i += stride)
+        {
+            if (keep(columns, i, fixQuality) && keep(columns, i - 1, fixQuality)
+                && columns.timeMs[i] > columns.timeMs[i - 1])
+            {
+                intervals.push_back(columns.timeMs[i] - columns.timeMs[i - 1]);
+            }
+        }
+        if (intervals.empty())
+            return result;
+        std::nth_element(intervals.begin(), intervals.begin() + intervals.size() / 2, intervals.end());
+        const int64_t tau0Ms = intervals[intervals.size() / 2];
+        result.tau0 = tau0Ms * 1e-3;
+
+        // Segments over the indexes of the kept fixes
+        std::vector<Segment> segments;
+        size_t n = 0;
+        int64_t previousMs = 0;
+        for (size_t i = firstFix; i < rows; ++i)
+        {
+            if (!keep(columns, i, fixQuality))
+                continue;
+            const int64_t dt = columns.timeMs[i] - previousMs;
+            if (n == 0 || 2 * std::llabs(dt - tau0Ms) > tau0Ms)
+                segments.emplace_back(n, n);
+            previousMs = columns.timeMs[i];
+            segments.back().second = ++n;
+        }
+        result.epochs = n;
+        result.segments = segments.size();
+
+        std::vector<size_t> taus = factors;
+        if (taus.empty())
+        {
+            size_t longest = 0;
+            for (const Segment &segment : segments)
+                longest = std::max(longest, segment.second - segment.first);
+            taus = octaveFactors(longest);
+        }
+
+        const Geodesy::ENUFrame frame = Geodesy::makeENUFrame(
+            columns.latitude[firstFix], columns.longitude[firstFix], columns.altitude[firstFix]);
+
+        std::vector<double> x(n + 1);
+        std::vector<AllanPoint> *outputs[3] = {&result.east, &result.north, &result.up};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            double lat[kBlock], lon[kBlock], alt[kBlock], enu[3][kBlock];
+            size_t out = 0;
+            x[0] = 0.0;
+            size_t i = firstFix;
+            while (i < rows)
+            {
+                size_t m = 0;
+                for (; i < rows && m < kBlock; ++i)
+                {
+                    if (!keep(columns, i, fixQuality))
+                        continue;
+                    lat[m] = columns.latitude[i];
+                    lon[m] = columns.longitude[i];
+                    alt[m] = columns.altitude[i];
+                    ++m;
+                }
+                Geodesy::llaToEnu(frame, lat, lon, alt, m, enu[0], enu[1], enu[2]);
+                for (size_t k = 0; k < m; ++k, ++out)
+                    x[out + 1] = x[out] + enu[axis][k];
+            }
+            *outputs[axis] = fromSums(x, result.tau0, taus, segments, threads);
+        }
+        return result;
+    }
+};
@@ -0,0 +1,244 @@
+#include "AnomalyDetector.hpp"
+#include "Geodesy.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr int64_t kDayMs = 86400000;
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kDegToRad = kPi / 180.0;
+
+    /// Milliseconds from @p from to @p to, reading a step back of more than 12 h as a midnight rollover.
+    int64_t elapsedMs(int64_t from, int64_t to)
+    {
+        const int64_t dt = to - from;
+        return dt < -kDayMs / 2 ? dt + kDayMs : dt;
+    }
+
+    /// Horizontal distance (m) on a local sphere; plenty for epoch-to-epoch steps.
+    double horizontalDistance(double lat1, double lon1, double lat2, double lon2)
+    {
+        double dLon = lon2 - lon1;
+        if (dLon > 180.0)
+            dLon -= 360.0;
+        else if (dLon < -180.0)
+            dLon += 360.0;
+        const double dn = (lat2 - lat1) * kDegToRad * Geodesy::kSemiMajorAxis;
+        const double de = dLon * kDegToRad * Geodesy::kSemiMajorAxis * std::cos(0.5 * (lat1 + lat2) * kDegToRad);
+        return std::hypot(de, dn);
+    }
+}
+
+AnomalyDetector::AnomalyDetector(const AnomalyDetectorConfig &config)
+    : m_config(config)
+{
+}
+
+void AnomalyDetector::reset()
+{
+    const AnomalyDetectorConfig config = m_config;
+    *this = AnomalyDetector(config);
+}
+
+void AnomalyDetector::flag(AnomalyReport &report, AnomalyType type)
+{
+    if (!report.has(type))
+    {
+        report.flags |= anomalyBit(type);
+        ++m_counts[static_cast<size_t>(type)];
+    }
+}
+
+bool AnomalyDetector::update(const GNSSData &data, AnomalyReport &report, double speedMps)
+{
+    // Epochs without a GGA time only carry GSV satellites
+    if (data.timestamp.isValid())
+    {
+        updateFix(data.timestamp.toMSecsSinceEpoch(), data.latitude, data.longitude, data.altitude,
+                  data.hdop, data.satellites, fixQualityCode(data.fixType), speedMps, report);
+    }
+    else
+    {
+        report.clear();
+    }
+    // satMap stays in GNSSData until the next GSV sequence completes. The
+    // parser publishes each sequence as a new map, so a map still shared
+    // with the last one fed is the same sequence
+    if (!data.satMap.isEmpty() && !data.satMap.isSharedWith(m_lastSatMap))
+    {
+        m_lastSatMap = data.satMap;
+        updateSatellites(data.satMap, report);
+    }
+    return report.any();
+}
+
+bool AnomalyDetector::updateFix(int64_t timeMs, double latitude, double longitude, double altitude,
+                                double hdop, int satellites, uint8_t fixQuality, double speedMps,
+                                AnomalyReport &report)
+{
+    report.clear();
+    checkTime(timeMs, report);
+    checkSatellites(satellites, report);
+    if (fixQuality > 0 && std::isfinite(latitude) && std::isfinite(longitude))
+    {
+        checkPosition(timeMs, latitude, longitude, hdop, speedMps, report);
+        if (std::isfinite(altitude))
+            checkAltitude(timeMs, altitude, report);
+    }
+    return report.any();
+}
+
+void AnomalyDetector::checkTime(int64_t timeMs, AnomalyReport &report)
+{
+    if (!m_haveTime)
+    {
+        m_haveTime = true;
+        m_lastTimeMs = timeMs;
+        report.intervalMs = 0;
+        return;
+    }
+
+    const int64_t dt = elapsedMs(m_lastTimeMs, timeMs);
+    report.intervalMs = dt;
+    if (dt == 0)
+    {
+        flag(report, AnomalyType::TimeDuplicate);
+        return;
+    }
+    if (dt < 0)
+    {
+        flag(report, AnomalyType::TimeBackwards);
+        if (++m_timeRejects < m_config.restartAfter)
+            return;
+        m_intervals.reset();
+    }
+    else if (m_intervals.count() >= static_cast<size_t>(m_config.minSamples)
+             && dt > m_config.gapFactor * m_intervals.mean())
+    {
+        flag(report, AnomalyType::TimeGap);
+    }
+    else
+    {
+        m_intervals.add(static_cast<double>(dt));
+    }
+    m_timeRejects = 0;
+    m_lastTimeMs = timeMs;
+}
+
+void AnomalyDetector::checkPosition(int64_t timeMs, double latitude, double longitude, double hdop,
+                                    double speedMps, AnomalyReport &report)
+{
+    if (m_haveFix)
+    {
+        const int64_t dtMs = elapsedMs(m_fixTimeMs, timeMs);
+        if (dtMs <= 0)
+            return;
+        const double dt = dtMs * 1e-3;
+
+        double speed = m_config.maxSpeed;
+        if (std::isfinite(speedMps) && speedMps >= 0.0)
+            speed = speedMps;
+        else if (m_speeds.count() >= static_cast<size_t>(m_config.minSamples))
+            speed = m_speeds.mean() + m_config.speedSigmas * m_speeds.stddev();
+
+        const double distance = horizontalDistance(m_latitude, m_longitude, latitude, longitude);
+        const double allowed = (speed * m_config.speedFactor + m_config.speedMargin) * dt
+                             + m_config.jumpSigmas * m_config.uere * std::max(hdop, 0.0);
+        report.jumpMeters = distance;
+        report.allowedJumpMeters = allowed;
+        if (distance > allowed)
+        {
+            flag(report, AnomalyType::PositionJump);
+            if (++m_positionRejects < m_config.restartAfter)
+                return;
+            m_speeds.reset();
+        }
+        else
+        {
+            m_speeds.add(distance / dt);
+        }
+    }
+    m_haveFix = true;
+    m_positionRejects = 0;
+    m_fixTimeMs = timeMs;
+    m_latitude = latitude;
+    m_longitude = longitude;
+}
+
+void AnomalyDetector::checkAltitude(int64_t timeMs, double altitude, AnomalyReport &report)
+{
+    if (m_haveAltitude)
+    {
+        const int64_t dtMs = elapsedMs(m_altitudeTimeMs, timeMs);
+        if (dtMs <= 0)
+            return;
+        const double dt = dtMs * 1e-3;
+
+        bool accept = true;
+        if (m_verticalRates.count() >= static_cast<size_t>(m_config.minSamples))
+        {
+            // Rate noise scales as 1/dt, so stddev * dt is the altitude noise at any epoch rate
+            const double deviation = altitude - (m_altitude + m_verticalRates.mean() * dt);
+            const double threshold = std::max(m_config.altitudeSigmas * m_verticalRates.stddev() * dt,
+                                              m_config.altitudeMinSpike);
+            if (std::fabs(deviation) > threshold)
+            {
+                report.altitudeDeviation = deviation;
+                flag(report, AnomalyType::AltitudeSpike);
+                if (++m_altitudeRejects < m_config.restartAfter)
+                    return;
+                m_verticalRates.reset();
+                accept = false;
+            }
+        }
+        if (accept)
+            m_verticalRates.add((altitude - m_altitude) / dt);
+    }
+    m_haveAltitude = true;
+    m_altitudeRejects = 0;
+    m_altitudeTimeMs = timeMs;
+    m_altitude = altitude;
+}
+
+void AnomalyDetector::checkSatellites(int satellites, AnomalyReport &report)
+{
+    if (m_satellites.count() >= static_cast<size_t>(m_config.minSamples))
+    {
+        const double level = m_satellites.mean();
+        report.satelliteLevel = level;
+        if (satellites < m_config.collapseRatio * level && level - satellites >= m_config.collapseMinDrop)
+            flag(report, AnomalyType::SatelliteCollapse);
+    }
+    m_satellites.add(satellites);
+}
+
+bool AnomalyDetector::updateSatellites(const QMap<int, SATInfo> &satMap, AnomalyReport &report)
+{
+    ++m_sequence;
+    bool dropped = false;
+    for (auto it = satMap.constBegin(); it != satMap.constEnd(); ++it)
+    {
+        const double snr = it.value().snr;
+        if (!(snr > 0.0))
+            continue;
+
+        PrnHistory &history = m_prns[it.key()];
+        if (history.snr.count() > 0
+            && history.lastSequence + static_cast<uint64_t>(m_config.snrMaxMissing) < m_sequence)
+        {
+            history.snr.reset();
+        }
+        if (history.snr.count() >= static_cast<size_t>(m_config.minSamples)
+            && snr < history.snr.mean() - m_config.snrDropDb)
+        {
+            report.snrDrops.push_back(it.key());
+            dropped = true;
+        }
+        history.snr.add(snr);
+        history.lastSequence = m_sequence;
+    }
+    if (dropped)
+        flag(report, AnomalyType::SnrDrop);
+    return dropped;
+}
@@ -0,0 +1,215 @@
+#include "AsyncIngest.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+    constexpr int kMaxEvents = 256;
+    constexpr uint64_t kReadsPerTurn = 16;     // reads before a source lets the others run
+
+    /// Root of a spawned task: starts at once and frees itself when done.
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+}
+
+namespace Ingest {
+
+    EventLoop::EventLoop()
+        : m_epoll(::epoll_create1(EPOLL_CLOEXEC))
+    {
+        if (m_epoll < 0)
+            throw std::system_error(errno, std::generic_category(), "EventLoop: epoll_create1");
+    }
+
+    EventLoop::~EventLoop()
+    {
+        ::close(m_epoll);
+    }
+
+    size_t EventLoop::add(int fd)
+    {
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+            throw std::system_error(errno, std::generic_category(), "EventLoop: fcntl");
+
+        size_t slot;
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            slot = m_slots.size();
+            m_slots.emplace_back();
+        }
+        Slot &s = m_slots[slot];
+        s = Slot();
+        s.fd = fd;
+        s.used = true;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        event.data.u64 = slot;
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            if (errno != EPERM)
+            {
+                const int error = errno;
+                s.used = false;
+                m_freeSlots.push_back(slot);
+                throw std::system_error(error, std::generic_category(), "EventLoop: epoll_ctl");
+            }
+            s.pollable = false;     // regular file: always readable
+        }
+        return slot;
+    }
+
+    void EventLoop::remove(size_t slot)
+    {
+        Slot &s = m_slots[slot];
+        if (!s.used)
+            return;
+        if (s.pollable)
+            ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, s.fd, nullptr);
+        s = Slot();
+        m_freeSlots.push_back(slot);
+    }
+
+    bool EventLoop::ReadableAwaiter::await_ready() const noexcept
+    {
+        Slot &s = loop.m_slots[slot];
+        if (!s.pollable)
+            return true;
+        return std::exchange(s.ready, false);
+    }
+
+    void EventLoop::ReadableAwaiter::await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        loop.m_slots[slot].waiter = h;
+    }
+
+    void EventLoop::spawn(Task<void> task)
+    {
+        ++m_active;
+        [](EventLoop &loop, Task<void> t) -> Detached {
+            try
+            {
+                co_await t;
+            }
+            catch (...)
+            {
+                if (!loop.m_error)
+                    loop.m_error = std::current_exception();
+            }
+            --loop.m_active;
+        }(*this, std::move(task));
+    }
+
+    void EventLoop::rethrow()
+    {
+        if (m_error)
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+
+    void EventLoop::run()
+    {
+        rethrow();
+        epoll_event events[kMaxEvents];
+        while (m_active > 0)
+        {
+            while (!m_ready.empty())
+            {
+                const std::coroutine_handle<> h = m_ready.front();
+                m_ready.pop_front();
+                h.resume();
+                rethrow();
+            }
+            if (m_active == 0)
+                break;
+
+            const int n = ::epoll_wait(m_epoll, events, kMaxEvents, -1);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "EventLoop: epoll_wait");
+            }
+            for (int i = 0; i < n; ++i)
+            {
+                const size_t slot = static_cast<size_t>(events[i].data.u64);
+                if (slot >= m_slots.size() || !m_slots[slot].used)
+                    continue;
+                if (const std::coroutine_handle<> h = std::exchange(m_slots[slot].waiter, {}))
+                {
+                    h.resume();
+                    rethrow();
+                }
+                else
+                {
+                    m_slots[slot].ready = true;
+                }
+            }
+        }
+    }
+
+    NMEASource::NMEASource(EventLoop &loop, int fd, size_t readSize)
+        : m_loop(loop), m_slot(loop.add(fd)), m_fd(fd), m_readSize(readSize)
+    {
+    }
+
+    NMEASource::~NMEASource()
+    {
+        m_loop.remove(m_slot);
+    }
+
+    Task<const EpochRecord *> NMEASource::nextEpoch()
+    {
+        for (;;)
+        {
+            std::string_view line;
+            while (m_framer.next(line))
+            {
+                if (m_context.parse(line))
+                    co_return &m_context.epoch();
+            }
+            if (m_eof)
+            {
+                if (m_framer.flush(line) && m_context.parse(line))
+                    co_return &m_context.epoch();
+                co_return nullptr;
+            }
+
+            const ssize_t n = ::read(m_fd, m_framer.writeBuffer(m_readSize), m_readSize);
+            if (n > 0)
+            {
+                m_framer.commit(static_cast<size_t>(n));
+                m_bytes += static_cast<uint64_t>(n);
+                if (++m_reads % kReadsPerTurn == 0)
+                    co_await m_loop.yield();
+            }
+            else if (n == 0)
+            {
+                m_eof = true;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                co_await m_loop.readable(m_slot);
+            }
+            else if (errno != EINTR)
+            {
+                throw std::system_error(errno, std::generic_category(), "NMEASource: read");
+            }
+        }
+    }
+};
@@ -0,0 +1,333 @@
+#include "BatchLogReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define GNSS_HAVE_IO_URING 1
+#endif
+
+namespace Ingest {
+
+#ifdef GNSS_HAVE_IO_URING
+
+    /**
+     * Submission and completion rings mapped from the kernel, plus the
+     * registered read buffers (queueDepth blocks of blockSize bytes).
+     */
+    struct BatchLogReader::Ring {
+        int fd = -1;
+        void *sqMap = MAP_FAILED;
+        size_t sqMapSize = 0;
+        void *cqMap = MAP_FAILED;
+        size_t cqMapSize = 0;
+        io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+        size_t sqesSize = 0;
+        unsigned *sqTail = nullptr;
+        unsigned *sqMask = nullptr;
+        unsigned *sqArray = nullptr;
+        unsigned *cqHead = nullptr;
+        unsigned *cqTail = nullptr;
+        unsigned *cqMask = nullptr;
+        io_uring_cqe *cqes = nullptr;
+        char *buffers = static_cast<char *>(MAP_FAILED);
+        size_t buffersSize = 0;
+
+        ~Ring()
+        {
+            if (buffers != MAP_FAILED)
+                ::munmap(buffers, buffersSize);
+            if (sqes != MAP_FAILED)
+                ::munmap(sqes, sqesSize);
+            if (cqMap != MAP_FAILED && cqMap != sqMap)
+                ::munmap(cqMap, cqMapSize);
+            if (sqMap != MAP_FAILED)
+                ::munmap(sqMap, sqMapSize);
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        /// Null when the kernel refuses io_uring or the buffer registration.
+        static std::unique_ptr<Ring> create(unsigned depth, size_t blockSize)
+        {
+            auto ring = std::make_unique<Ring>();
+            io_uring_params params{};
+            ring->fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+            if (ring->fd < 0)
+                return nullptr;
+
+            ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap)
+                ring->sqMapSize = ring->cqMapSize = std::max(ring->sqMapSize, ring->cqMapSize);
+
+            ring->sqMap = ::mmap(nullptr, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 ring->fd, IORING_OFF_SQ_RING);
+            if (ring->sqMap == MAP_FAILED)
+                return nullptr;
+            ring->cqMap = singleMap ? ring->sqMap
+                                    : ::mmap(nullptr, ring->cqMapSize, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+            if (ring->cqMap == MAP_FAILED)
+                return nullptr;
+            ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            ring->sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+            if (ring->sqes == MAP_FAILED)
+                return nullptr;
+
+            char *sq = static_cast<char *>(ring->sqMap);
+            char *cq = static_cast<char *>(ring->cqMap);
+            ring->sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            ring->sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            ring->sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+            ring->cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            ring->cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            ring->cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+            // Registered buffers are pinned once instead of on every read
+            ring->buffersSize = size_t(depth) * blockSize;
+            ring->buffers = static_cast<char *>(::mmap(nullptr, ring->buffersSize, PROT_READ | PROT_WRITE,
+                                                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (ring->buffers == MAP_FAILED)
+                return nullptr;
+            std::vector<iovec> iovecs(depth);
+            for (unsigned i = 0; i < depth; ++i)
+            {
+                iovecs[i].iov_base = ring->buffers + size_t(i) * blockSize;
+                iovecs[i].iov_len = blockSize;
+            }
+            if (::syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovecs.data(), depth) < 0)
+                return nullptr;
+            return ring;
+        }
+    };
+
+#else
+
+    struct BatchLogReader::Ring {
+        static std::unique_ptr<Ring> create(unsigned, size_t) { return nullptr; }
+    };
+
+#endif
+
+    BatchLogReader::BatchLogReader(EpochHandler onEpoch, const BatchLogReaderConfig &config)
+        : m_config(config), m_onEpoch(std::move(onEpoch))
+    {
+        m_config.queueDepth = std::max(1u, std::min(m_config.queueDepth, 4096u));
+        m_config.blockSize = std::max<size_t>(m_config.blockSize, 4096);
+        if (!m_config.usePread)
+            m_ring = Ring::create(m_config.queueDepth, m_config.blockSize);
+    }
+
+    BatchLogReader::~BatchLogReader() = default;
+
+    size_t BatchLogReader::add(int fd)
+    {
+        auto source = std::make_unique<Source>(m_config.maxLineLength);
+        source->id = m_sources.size();
+        source->fd = fd;
+        const off_t position = ::lseek(fd, 0, SEEK_CUR);
+        source->seekable = position >= 0;
+        source->offset = position >= 0 ? static_cast<uint64_t>(position) : 0;
+        m_sources.push_back(std::move(source));
+        return m_sources.back()->id;
+    }
+
+    ParseCounters BatchLogReader::parseCounters() const
+    {
+        ParseCounters total;
+        for (const auto &source : m_sources)
+            total += source->context.stats().snapshot();
+        return total;
+    }
+
+    void BatchLogReader::parse(Source &source, std::string_view line)
+    {
+        if (line.empty())
+            return;
+        ++source.sentences;
+        if (source.context.parse(line) && m_onEpoch)
+            m_onEpoch(source);
+    }
+
+    void BatchLogReader::consume(Source &source, const char *data, size_t length)
+    {
+        if (data)
+            source.framer.feed(data, length);
+        else
+            source.framer.commit(length);       // pread went straight into the framer
+        source.bytes += length;
+        m_bytes += length;
+
+        std::string_view line;
+        while (source.framer.next(line))
+            parse(source, line);
+    }
+
+    void BatchLogReader::finish(Source &source)
+    {
+        // The last line may lack its newline
+        std::string_view line;
+        if (!source.error && source.framer.flush(line))
+            parse(source, line);
+        source.finished = true;
+    }
+
+    void BatchLogReader::run()
+    {
+        if (m_ring)
+            runRing();
+        else
+            runPread();
+    }
+
+    void BatchLogReader::runPread()
+    {
+        bool active = true;
+        while (active)
+        {
+            active = false;
+            for (const std::unique_ptr<Source> &s : m_sources)
+            {
+                Source &source = *s;
+                if (source.finished)
+                    continue;
+                char *buffer = source.framer.writeBuffer(m_config.blockSize);
+                const ssize_t n = source.seekable
+                                      ? ::pread(source.fd, buffer, m_config.blockSize, static_cast<off_t>(source.offset))
+                                      : ::read(source.fd, buffer, m_config.blockSize);
+                ++m_systemCalls;
+                if (n > 0)
+                {
+                    source.offset += static_cast<uint64_t>(n);
+                    consume(source, nullptr, static_cast<size_t>(n));
+                    active = true;
+                }
+                else if (n == 0)
+                {
+                    finish(source);
+                }
+                else if (errno == EINTR || errno == EAGAIN)
+                {
+                    active = true;
+                }
+                else
+                {
+                    source.error = errno;
+                    finish(source);
+                }
+            }
+        }
+    }
+
+#ifdef GNSS_HAVE_IO_URING
+
+    void BatchLogReader::runRing()
+    {
+        Ring &ring = *m_ring;
+        const size_t blockSize = m_config.blockSize;
+        std::deque<Source *> waiting;                  // sources without a read in flight
+        for (const std::unique_ptr<Source> &source : m_sources)
+            if (!source->finished)
+                waiting.push_back(source.get());
+        std::vector<unsigned> freeBuffers;
+        for (unsigned i = m_config.queueDepth; i-- > 0;)
+            freeBuffers.push_back(i);
+        std::vector<Source *> bufferSource(m_config.queueDepth, nullptr);
+        size_t inFlight = 0;
+        unsigned unsubmitted = 0;
+
+        while (inFlight > 0 || !waiting.empty())
+        {
+            // One read per waiting source, as far as buffers allow
+            unsigned tail = *ring.sqTail;
+            const unsigned mask = *ring.sqMask;
+            while (!waiting.empty() && !freeBuffers.empty())
+            {
+                Source &source = *waiting.front();
+                waiting.pop_front();
+                const unsigned buffer = freeBuffers.back();
+                freeBuffers.pop_back();
+                bufferSource[buffer] = &source;
+
+                const unsigned index = tail & mask;
+                io_uring_sqe &sqe = ring.sqes[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READ_FIXED;
+                sqe.fd = source.fd;
+                sqe.off = source.seekable ? source.offset : ~uint64_t(0);     // -1: current position
+                sqe.addr = reinterpret_cast<uint64_t>(ring.buffers + buffer * blockSize);
+                sqe.len = static_cast<uint32_t>(blockSize);
+                sqe.buf_index = static_cast<uint16_t>(buffer);
+                sqe.user_data = buffer;
+                ring.sqArray[index] = index;
+                ++tail;
+                ++unsubmitted;
+                ++inFlight;
+            }
+            __atomic_store_n(ring.sqTail, tail, __ATOMIC_RELEASE);
+
+            const long submitted = ::syscall(__NR_io_uring_enter, ring.fd, unsubmitted, 1u, IORING_ENTER_GETEVENTS,
+                                             nullptr, 0);
+            ++m_systemCalls;
+            if (submitted < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "BatchLogReader: io_uring_enter");
+            }
+            unsubmitted -= static_cast<unsigned>(submitted);
+
+            unsigned head = *ring.cqHead;
+            const unsigned cqTail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+            for (; head != cqTail; ++head)
+            {
+                const io_uring_cqe &cqe = ring.cqes[head & *ring.cqMask];
+                const unsigned buffer = static_cast<unsigned>(cqe.user_data);
+                Source &source = *bufferSource[buffer];
+                const int result = cqe.res;
+                if (result > 0)
+                {
+                    source.offset += static_cast<uint64_t>(result);
+                    consume(source, ring.buffers + buffer * blockSize, static_cast<size_t>(result));
+                    waiting.push_back(&source);
+                }
+                else if (result == 0)
+                {
+                    finish(source);
+                }
+                else if (result == -EINTR || result == -EAGAIN)
+                {
+                    waiting.push_back(&source);
+                }
+                else
+                {
+                    source.error = -result;
+                    finish(source);
+                }
+                freeBuffers.push_back(buffer);
+                --inFlight;
+            }
+            __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+        }
+    }
+
+#else
+
+    void BatchLogReader::runRing()
+    {
+        runPread();
+    }
+
+#endif
+};
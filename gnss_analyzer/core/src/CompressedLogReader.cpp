@@ -0,0 +1,371 @@
+#include "CompressedLogReader.hpp"
+#include "NMEAParser.hpp"
+#include "NMEAException.hpp"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <zlib.h>
+#ifdef GNSS_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+    struct FileCloser {
+        void operator()(std::FILE *f) const { std::fclose(f); }
+    };
+    using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+    FilePtr openFile(const std::string &path)
+    {
+        FilePtr file(std::fopen(path.c_str(), "rb"));
+        if (!file)
+        {
+            throw ArchiveError("cannot open " + path);
+        }
+        return file;
+    }
+
+    // Producer stops as soon as the reader is destroyed
+    struct Cancelled {};
+}
+
+CompressedLogReader::CompressedLogReader(const std::string &path, Compression compression,
+                                         size_t chunkSize, size_t chunkCount)
+    : m_path(path),
+      m_compression(compression == Compression::Auto ? detect(path) : compression),
+      m_chunkSize(chunkSize)
+{
+    if (chunkSize == 0 || chunkCount < 2)
+    {
+        throw ArchiveError("need at least two non-empty chunks");
+    }
+#ifndef GNSS_HAVE_ZSTD
+    if (m_compression == Compression::Zstd)
+    {
+        throw ArchiveError("zstd support not built in: " + path);
+    }
+#endif
+
+    m_chunks.resize(chunkCount);
+    for (Chunk &chunk : m_chunks)
+    {
+        chunk.data.resize(chunkSize);
+        m_free.push_back(&chunk);
+    }
+    m_producer = std::thread(&CompressedLogReader::produce, this);
+}
+
+CompressedLogReader::~CompressedLogReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_freeCond.notify_all();
+    m_producer.join();
+}
+
+CompressedLogReader::Compression CompressedLogReader::detect(const std::string &path)
+{
+    FilePtr file = openFile(path);
+    unsigned char magic[4] = {};
+    const size_t got = std::fread(magic, 1, sizeof(magic), file.get());
+    if (got >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+        return Compression::Gzip;
+    if (got == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD)
+        return Compression::Zstd;
+    return Compression::None;
+}
+
+CompressedLogReader::Chunk *CompressedLogReader::acquireFree()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_freeCond.wait(lock, [this] { return m_stop || !m_free.empty(); });
+    if (m_stop)
+        throw Cancelled();
+    Chunk *chunk = m_free.front();
+    m_free.pop_front();
+    chunk->size = 0;
+    return chunk;
+}
+
+void CompressedLogReader::publish(Chunk *chunk)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(chunk);
+    }
+    m_readyCond.notify_one();
+}
+
+void CompressedLogReader::produce()
+{
+    try {
+        FilePtr file = openFile(m_path);
+        switch (m_compression)
+        {
+            case Compression::Gzip: inflateGzip(file.get()); break;
+            case Compression::Zstd: inflateZstd(file.get()); break;
+            default:                copyPlain(file.get()); break;
+        }
+    } catch (const Cancelled &) {
+        return;
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+    }
+    m_readyCond.notify_one();
+}
+
+void CompressedLogReader::copyPlain(std::FILE *file)
+{
+    for (;;)
+    {
+        Chunk *chunk = acquireFree();
+        chunk->size = std::fread(chunk->data.data(), 1, m_chunkSize, file);
+        if (chunk->size == 0)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(chunk);
+            break;
+        }
+        publish(chunk);
+    }
+    if (std::ferror(file))
+    {
+        throw ArchiveError("read failed: " + m_path);
+    }
+}
+
+void CompressedLogReader::inflateGzip(std::FILE *file)
+{
+    z_stream zs{};
+    // 15 + 32: zlib or gzip header, detected automatically
+    if (inflateInit2(&zs, 15 + 32) != Z_OK)
+    {
+        throw ArchiveError("inflateInit failed");
+    }
+    std::unique_ptr<z_stream, int (*)(z_stream *)> guard(&zs, inflateEnd);
+
+    std::vector<unsigned char> input(m_chunkSize);
+    Chunk *chunk = acquireFree();
+    bool streamEnd = false;
+
+    for (;;)
+    {
+        if (zs.avail_in == 0)
+        {
+            zs.next_in = input.data();
+            zs.avail_in = static_cast<uInt>(std::fread(input.data(), 1, input.size(), file));
+            if (zs.avail_in == 0)
+            {
+                if (std::ferror(file))
+                    throw ArchiveError("read failed: " + m_path);
+                if (!streamEnd)
+                    throw ArchiveError("truncated gzip stream: " + m_path);
+                break;
+            }
+        }
+
+        zs.next_out = reinterpret_cast<Bytef *>(chunk->data.data() + chunk->size);
+        zs.avail_out = static_cast<uInt>(m_chunkSize - chunk->size);
+        const int ret = inflate(&zs, Z_NO_FLUSH);
+        chunk->size = m_chunkSize - zs.avail_out;
+
+        if (ret == Z_STREAM_END)
+        {
+            // Concatenated members (e.g. rotated logs appended with cat)
+            streamEnd = true;
+            inflateReset(&zs);
+        }
+        else if (ret == Z_OK || ret == Z_BUF_ERROR)
+        {
+            streamEnd = false;
+        }
+        else
+        {
+            throw ArchiveError(std::string("gzip error: ") + (zs.msg ? zs.msg : "corrupt data") + " in " + m_path);
+        }
+
+        if (chunk->size == m_chunkSize)
+        {
+            publish(chunk);
+            chunk = acquireFree();
+        }
+    }
+
+    if (chunk->size > 0)
+    {
+        publish(chunk);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(chunk);
+    }
+}
+
+void CompressedLogReader::inflateZstd(std::FILE *file)
+{
+#ifdef GNSS_HAVE_ZSTD
+    std::unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream *)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+    if (!stream)
+    {
+        throw ArchiveError("ZSTD_createDStream failed");
+    }
+
+    std::vector<char> input(m_chunkSize);
+    ZSTD_inBuffer in{input.data(), 0, 0};
+    Chunk *chunk = acquireFree();
+    size_t pending = 0;     // 0 once a frame is complete
+
+    for (;;)
+    {
+        if (in.pos == in.size)
+        {
+            in.size = std::fread(input.data(), 1, input.size(), file);
+            in.pos = 0;
+            if (in.size == 0)
+            {
+                if (std::ferror(file))
+                    throw ArchiveError("read failed: " + m_path);
+                if (pending != 0)
+                    throw ArchiveError("truncated zstd stream: " + m_path);
+                break;
+            }
+        }
+
+        ZSTD_outBuffer out{chunk->data.data(), m_chunkSize, chunk->size};
+        pending = ZSTD_decompressStream(stream.get(), &out, &in);
+        if (ZSTD_isError(pending))
+        {
+            throw ArchiveError(std::string("zstd error: ") + ZSTD_getErrorName(pending) + " in " + m_path);
+        }
+        chunk->size = out.pos;
+
+        if (chunk->size == m_chunkSize)
+        {
+            publish(chunk);
+            chunk = acquireFree();
+        }
+    }
+
+    if (chunk->size > 0)
+    {
+        publish(chunk);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(chunk);
+    }
+#else
+    (void)file;
+    throw ArchiveError("zstd support not built in: " + m_path);
+#endif
+}
+
+bool CompressedLogReader::acquireReady()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_readyCond.wait(lock, [this] { return !m_ready.empty() || m_finished; });
+    if (!m_ready.empty())
+    {
+        m_current = m_ready.front();
+        m_ready.pop_front();
+        m_pos = 0;
+        return true;
+    }
+    if (m_error)
+    {
+        std::rethrow_exception(m_error);
+    }
+    return false;
+}
+
+void CompressedLogReader::releaseCurrent()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(m_current);
+    }
+    m_current = nullptr;
+    m_freeCond.notify_one();
+}
+
+bool CompressedLogReader::nextLine(const char *&line, size_t &length)
+{
+    m_carry.clear();
+    bool carrying = false;
+
+    for (;;)
+    {
+        if (!m_current && !acquireReady())
+        {
+            if (m_carry.empty())
+                return false;
+            break;  // last line has no terminator
+        }
+
+        const char *begin = m_current->data.data() + m_pos;
+        const size_t available = m_current->size - m_pos;
+        const char *nl = static_cast<const char *>(std::memchr(begin, '\n', available));
+        if (nl)
+        {
+            const size_t n = nl - begin;
+            m_pos += n + 1;
+            if (!carrying)
+            {
+                line = begin;
+                length = (n > 0 && begin[n - 1] == '\r') ? n - 1 : n;
+                return true;
+            }
+            m_carry.append(begin, n);
+            break;
+        }
+
+        // Line continues in the next chunk
+        m_carry.append(begin, available);
+        carrying = true;
+        releaseCurrent();
+    }
+
+    if (!m_carry.empty() && m_carry.back() == '\r')
+        m_carry.pop_back();
+    line = m_carry.data();
+    length = m_carry.size();
+    return true;
+}
+
+namespace NMEAParser {
+
+    size_t parseCompressedLog(const std::string &path, GNSSData &data,
+                              const std::function<void(const GNSSData &)> &onEpoch)
+    {
+        CompressedLogReader reader(path);
+        const char *line = nullptr;
+        size_t length = 0;
+        size_t epochs = 0;
+
+        while (reader.nextLine(line, length))
+        {
+            const QString sentence = QString::fromLatin1(line, static_cast<int>(length));
+            try {
+                parseLine(sentence, data);
+            } catch (const NMEAException &) {
+                continue;
+            }
+            if (DataType(sentence) == DATAType::GGA)
+            {
+                onEpoch(data);
+                ++epochs;
+            }
+        }
+        return epochs;
+    }
+};
@@ -0,0 +1,227 @@
+#include "DOP.hpp"
+#include "EpochColumns.hpp"
+#include "Geodesy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+    constexpr double kDegToRad = 3.14159265358979323846 / 180.0;
+
+    /// Line-of-sight unit vector (ENU) of a satellite.
+    struct LineOfSight {
+        int id;
+        double e, n, u;
+    };
+
+    /**
+     * Upper triangle of the symmetric normal matrix H^T H:
+     *
+     *   | a b c d |
+     *   | . e f g |
+     *   | . . h i |
+     *   | . . . j |
+     */
+    struct NormalMatrix {
+        double a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0, i = 0, j = 0;
+
+        void add(double x, double y, double z, double w = 1.0)
+        {
+            a += w * x * x; b += w * x * y; c += w * x * z; d += w * x;
+            e += w * y * y; f += w * y * z; g += w * y;
+            h += w * z * z; i += w * z;
+            j += w;
+        }
+    };
+
+    struct Covariance {
+        double qe, qn, qu, qt, det;
+    };
+
+    /**
+     * Diagonal of the inverse of a symmetric 4x4 matrix by cofactors, built
+     * from the 2x2 minors of rows 0-1 (s*) and rows 2-3 (c*). Straight-line
+     * code: the batch loop over epochs vectorizes.
+     */
+    inline Covariance invertDiagonal(double a, double b, double c, double d, double e,
+                                     double f, double g, double h, double i, double j)
+    {
+        const double s0 = a * e - b * b;
+        const double s1 = a * f - b * c;
+        const double s2 = a * g - b * d;
+        const double s3 = b * f - c * e;
+        const double s4 = b * g - d * e;
+        const double s5 = c * g - d * f;
+
+        const double c5 = h * j - i * i;
+        const double c4 = f * j - g * i;
+        const double c3 = f * i - g * h;
+        const double c2 = c * j - d * i;
+        const double c1 = c * i - d * h;
+        const double c0 = c * g - d * f;
+
+        Covariance q;
+        q.det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        const double invDet = 1.0 / q.det;
+        q.qe = (e * c5 - f * c4 + g * c3) * invDet;
+        q.qn = (a * c5 - c * c2 + d * c1) * invDet;
+        q.qu = (d * s4 - g * s2 + j * s0) * invDet;
+        q.qt = (h * s0 - f * s1 + c * s3) * invDet;
+        return q;
+    }
+
+    inline Covariance invertDiagonal(const NormalMatrix &m)
+    {
+        return invertDiagonal(m.a, m.b, m.c, m.d, m.e, m.f, m.g, m.h, m.i, m.j);
+    }
+
+    DOPValues toDOP(const Covariance &q, int satellites)
+    {
+        DOPValues dop;
+        dop.satellites = satellites;
+
+        // Singular geometry: the determinant vanishes relative to its n^4 scale
+        const double scale = static_cast<double>(satellites) * satellites * satellites * satellites;
+        dop.valid = satellites >= 4 && q.det > 1e-10 * scale
+                    && q.qe > 0.0 && q.qn > 0.0 && q.qu > 0.0 && q.qt > 0.0;
+        if (!dop.valid)
+        {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            dop.gdop = dop.pdop = dop.hdop = dop.vdop = dop.tdop = nan;
+            return dop;
+        }
+        dop.gdop = std::sqrt(q.qe + q.qn + q.qu + q.qt);
+        dop.pdop = std::sqrt(q.qe + q.qn + q.qu);
+        dop.hdop = std::sqrt(q.qe + q.qn);
+        dop.vdop = std::sqrt(q.qu);
+        dop.tdop = std::sqrt(q.qt);
+        return dop;
+    }
+
+    bool usable(double elevationDeg, double azimuthDeg, double maskDeg)
+    {
+        return std::isfinite(elevationDeg) && std::isfinite(azimuthDeg)
+               && elevationDeg >= maskDeg && elevationDeg <= 90.0;
+    }
+
+    std::vector<LineOfSight> lineOfSight(const QMap<int, SATInfo> &satMap, double maskDeg,
+                                         const std::vector<int> &excluded)
+    {
+        std::vector<LineOfSight> rows;
+        rows.reserve(satMap.size());
+        for (auto it = satMap.constBegin(); it != satMap.constEnd(); ++it)
+        {
+            const SATInfo &sat = it.value();
+            if (!usable(sat.elevation, sat.azimuth, maskDeg)
+                || std::find(excluded.begin(), excluded.end(), it.key()) != excluded.end())
+                continue;
+            const double el = sat.elevation * kDegToRad;
+            const double az = sat.azimuth * kDegToRad;
+            rows.push_back({it.key(), std::cos(el) * std::sin(az), std::cos(el) * std::cos(az), std::sin(el)});
+        }
+        return rows;
+    }
+}
+
+namespace DOP {
+
+    DOPValues compute(const QMap<int, SATInfo> &satMap, double elevationMaskDeg, const std::vector<int> &excluded)
+    {
+        NormalMatrix m;
+        const std::vector<LineOfSight> rows = lineOfSight(satMap, elevationMaskDeg, excluded);
+        for (const LineOfSight &los : rows)
+            m.add(los.e, los.n, los.u);
+        return toDOP(invertDiagonal(m), static_cast<int>(rows.size()));
+    }
+
+    void compute(const EpochColumns &columns, std::vector<DOPValues> &out, double elevationMaskDeg)
+    {
+        const size_t epochs = columns.size();
+        const size_t rows = columns.satelliteCount();
+
+        // Pass 1: line-of-sight vectors of every satellite row, batch trig
+        std::vector<double> elevation(rows), azimuth(rows), weight(rows);
+        for (size_t s = 0; s < rows; ++s)
+        {
+            const bool ok = usable(columns.elevation[s], columns.azimuth[s], elevationMaskDeg);
+            elevation[s] = ok ? columns.elevation[s] * kDegToRad : 0.0;
+            azimuth[s] = ok ? columns.azimuth[s] * kDegToRad : 0.0;
+            weight[s] = ok ? 1.0 : 0.0;
+        }
+        std::vector<double> sinEl(rows), cosEl(rows), sinAz(rows), cosAz(rows);
+        Geodesy::sinCos(elevation.data(), rows, sinEl.data(), cosEl.data());
+        Geodesy::sinCos(azimuth.data(), rows, sinAz.data(), cosAz.data());
+
+        // Pass 2: normal matrices, one column per upper-triangle entry
+        std::vector<double> nm[10];
+        for (std::vector<double> &entry : nm)
+            entry.assign(epochs, 0.0);
+        for (size_t k = 0; k < epochs; ++k)
+        {
+            NormalMatrix m;
+            for (size_t s = columns.satOffset[k]; s < columns.satOffset[k + 1]; ++s)
+                m.add(cosEl[s] * sinAz[s], cosEl[s] * cosAz[s], sinEl[s], weight[s]);
+            nm[0][k] = m.a; nm[1][k] = m.b; nm[2][k] = m.c; nm[3][k] = m.d; nm[4][k] = m.e;
+            nm[5][k] = m.f; nm[6][k] = m.g; nm[7][k] = m.h; nm[8][k] = m.i; nm[9][k] = m.j;
+        }
+
+        // Pass 3: inversions, vectorized across epochs
+        std::vector<Covariance> q(epochs);
+        const double *__restrict a = nm[0].data(), *__restrict b = nm[1].data(), *__restrict c = nm[2].data();
+        const double *__restrict d = nm[3].data(), *__restrict e = nm[4].data(), *__restrict f = nm[5].data();
+        const double *__restrict g = nm[6].data(), *__restrict h = nm[7].data(), *__restrict i = nm[8].data();
+        const double *__restrict j = nm[9].data();
+        Covariance *__restrict qOut = q.data();
+        for (size_t k = 0; k < epochs; ++k)
+            qOut[k] = invertDiagonal(a[k], b[k], c[k], d[k], e[k], f[k], g[k], h[k], i[k], j[k]);
+
+        out.resize(epochs);
+        for (size_t k = 0; k < epochs; ++k)
+            out[k] = toDOP(q[k], static_cast<int>(nm[9][k]));
+    }
+
+    std::vector<std::pair<int, DOPValues>> leaveOneOut(const QMap<int, SATInfo> &satMap, double elevationMaskDeg)
+    {
+        const std::vector<LineOfSight> rows = lineOfSight(satMap, elevationMaskDeg, {});
+        NormalMatrix all;
+        for (const LineOfSight &los : rows)
+            all.add(los.e, los.n, los.u);
+
+        std::vector<std::pair<int, DOPValues>> result;
+        result.reserve(rows.size());
+        for (const LineOfSight &los : rows)
+        {
+            NormalMatrix m = all;
+            m.add(los.e, los.n, los.u, -1.0);
+            result.emplace_back(los.id, toDOP(invertDiagonal(m), static_cast<int>(rows.size()) - 1));
+        }
+        return result;
+    }
+
+    DOPValues apply(GNSSData &data, double elevationMaskDeg)
+    {
+        const DOPValues dop = compute(data.satMap, elevationMaskDeg);
+        if (dop.valid)
+            data.vdop = dop.vdop;
+        return dop;
+    }
+
+    void apply(EpochColumns &columns, double elevationMaskDeg)
+    {
+        std::vector<DOPValues> dop;
+        compute(columns, dop, elevationMaskDeg);
+        for (size_t k = 0; k < dop.size(); ++k)
+        {
+            if (dop[k].valid)
+                columns.vdop[k] = dop[k].vdop;
+        }
+    }
+
+    bool hdopMismatch(double reportedHdop, const DOPValues &computed, double tolerance, double maxRatio)
+    {
+        if (!computed.valid || !(reportedHdop > 0.0))
+            return false;
+        return reportedHdop < computed.hdop * (1.0 - tolerance) || reportedHdop > computed.hdop * maxRatio;
+    }
+};
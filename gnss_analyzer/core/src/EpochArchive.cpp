@@ -0,0 +1,387 @@
+#include "EpochArchive.hpp"
+#include "GNSSDataModel.hpp"
+#include "QtAdapter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+    /// Byte offsets of each column inside a block.
+    struct BlockLayout {
+        size_t timeMs, latitude, longitude, altitude, hdop, vdop, snrAvg;
+        size_t satellites, fixQuality, satOffset, satId, elevation, azimuth, snr;
+        size_t total;
+    };
+
+    BlockLayout layoutFor(size_t n, size_t m)
+    {
+        BlockLayout l{};
+        size_t off = 0;
+        auto column = [&off](size_t bytes) {
+            const size_t at = off;
+            off = align8(off + bytes);
+            return at;
+        };
+        l.timeMs = column(n * sizeof(int64_t));
+        l.latitude = column(n * sizeof(double));
+        l.longitude = column(n * sizeof(double));
+        l.altitude = column(n * sizeof(double));
+        l.hdop = column(n * sizeof(double));
+        l.vdop = column(n * sizeof(double));
+        l.snrAvg = column(n * sizeof(double));
+        l.satellites = column(n);
+        l.fixQuality = column(n);
+        l.satOffset = column((n + 1) * sizeof(uint32_t));
+        l.satId = column(m * sizeof(int32_t));
+        l.elevation = column(m * sizeof(float));
+        l.azimuth = column(m * sizeof(float));
+        l.snr = column(m * sizeof(float));
+        l.total = off;
+        return l;
+    }
+
+    template <typename T>
+    void putColumn(std::vector<char> &block, size_t offset, const std::vector<T> &column)
+    {
+        if (!column.empty())
+            std::memcpy(block.data() + offset, column.data(), column.size() * sizeof(T));
+    }
+
+    template <typename T>
+    const T *columnAt(const uint8_t *block, size_t offset)
+    {
+        return reinterpret_cast<const T *>(block + offset);
+    }
+}
+
+namespace EpochArchive {
+
+    size_t blockSize(size_t epochs, size_t sats)
+    {
+        return layoutFor(epochs, sats).total;
+    }
+};
+
+EpochArchiveWriter::EpochArchiveWriter(const std::string &path, uint32_t blockCapacity)
+    : m_out(path, std::ios::binary | std::ios::trunc), m_blockCapacity(blockCapacity)
+{
+    if (!m_out)
+    {
+        throw ArchiveError("cannot create " + path);
+    }
+    if (blockCapacity == 0)
+    {
+        throw ArchiveError("block capacity must be positive");
+    }
+
+    EpochArchive::FileHeader header{};
+    m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_offset = sizeof(header);
+    m_pending.reserve(blockCapacity);
+    m_open = true;
+}
+
+EpochArchiveWriter::~EpochArchiveWriter()
+{
+    try {
+        close();
+    } catch (const ArchiveError &) {
+        // Destructors must not throw; call close() to observe write errors
+    }
+}
+
+void EpochArchiveWriter::checkOrder(int64_t timeMs)
+{
+    if (!m_open)
+    {
+        throw ArchiveError("append on a closed archive");
+    }
+    if (timeMs < m_lastTimeMs)
+    {
+        throw ArchiveError("epochs must be appended in time order");
+    }
+    m_lastTimeMs = timeMs;
+}
+
+void EpochArchiveWriter::append(const GNSSData &data)
+{
+    checkOrder(data.timestamp.isValid() ? data.timestamp.toMSecsSinceEpoch() : 0);
+    QtAdapter::append(m_pending, data);
+    if (m_pending.size() >= m_blockCapacity)
+        flushBlock();
+}
+
+void EpochArchiveWriter::append(const EpochColumns &columns)
+{
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        checkOrder(columns.timeMs[i]);
+        m_pending.append(columns, i);
+        if (m_pending.size() >= m_blockCapacity)
+            flushBlock();
+    }
+}
+
+void EpochArchiveWriter::flushBlock()
+{
+    const size_t n = m_pending.size();
+    const size_t m = m_pending.satelliteCount();
+    if (n == 0)
+        return;
+    if (m > UINT32_MAX)
+    {
+        throw ArchiveError("too many satellite rows in one block");
+    }
+
+    const BlockLayout layout = layoutFor(n, m);
+    m_scratch.assign(layout.total, 0);
+
+    putColumn(m_scratch, layout.timeMs, m_pending.timeMs);
+    putColumn(m_scratch, layout.latitude, m_pending.latitude);
+    putColumn(m_scratch, layout.longitude, m_pending.longitude);
+    putColumn(m_scratch, layout.altitude, m_pending.altitude);
+    putColumn(m_scratch, layout.hdop, m_pending.hdop);
+    putColumn(m_scratch, layout.vdop, m_pending.vdop);
+    putColumn(m_scratch, layout.snrAvg, m_pending.snrAvg);
+    putColumn(m_scratch, layout.satellites, m_pending.satellites);
+    putColumn(m_scratch, layout.fixQuality, m_pending.fixQuality);
+    uint32_t *offsets = reinterpret_cast<uint32_t *>(m_scratch.data() + layout.satOffset);
+    for (size_t i = 0; i <= n; ++i)
+        offsets[i] = static_cast<uint32_t>(m_pending.satOffset[i]);
+    putColumn(m_scratch, layout.satId, m_pending.satId);
+    putColumn(m_scratch, layout.elevation, m_pending.elevation);
+    putColumn(m_scratch, layout.azimuth, m_pending.azimuth);
+    putColumn(m_scratch, layout.snr, m_pending.snr);
+
+    m_out.write(m_scratch.data(), m_scratch.size());
+    if (!m_out)
+    {
+        throw ArchiveError("write failed");
+    }
+
+    EpochArchive::BlockIndexEntry entry{};
+    entry.firstTimeMs = m_pending.timeMs.front();
+    entry.lastTimeMs = m_pending.timeMs.back();
+    entry.offset = m_offset;
+    entry.firstEpoch = m_epochCount;
+    entry.epochCount = static_cast<uint32_t>(n);
+    entry.satCount = static_cast<uint32_t>(m);
+    m_index.push_back(entry);
+
+    m_offset += layout.total;
+    m_epochCount += n;
+    m_pending.clear();
+}
+
+void EpochArchiveWriter::close()
+{
+    if (!m_open)
+        return;
+    m_open = false;
+
+    flushBlock();
+    m_out.write(reinterpret_cast<const char *>(m_index.data()),
+                m_index.size() * sizeof(EpochArchive::BlockIndexEntry));
+
+    EpochArchive::FileHeader header{};
+    std::memcpy(header.magic, EpochArchive::kMagic, sizeof(header.magic));
+    header.version = EpochArchive::kVersion;
+    header.blockCapacity = m_blockCapacity;
+    header.epochCount = m_epochCount;
+    header.blockCount = m_index.size();
+    header.indexOffset = m_offset;
+    m_out.seekp(0);
+    m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_out.close();
+    if (!m_out)
+    {
+        throw ArchiveError("failed to finalize archive");
+    }
+}
+
+EpochArchiveReader::~EpochArchiveReader()
+{
+    close();
+}
+
+void EpochArchiveReader::open(const std::string &path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw ArchiveError("cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(EpochArchive::FileHeader))
+    {
+        ::close(fd);
+        throw ArchiveError("not an epoch archive: " + path);
+    }
+    void *map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        throw ArchiveError("mmap failed for " + path);
+    }
+    m_data = static_cast<const uint8_t *>(map);
+    m_size = st.st_size;
+
+    m_header = reinterpret_cast<const EpochArchive::FileHeader *>(m_data);
+    const auto fail = [this, &path](const char *why) {
+        close();
+        throw ArchiveError(std::string(why) + ": " + path);
+    };
+    if (std::memcmp(m_header->magic, EpochArchive::kMagic, sizeof(m_header->magic)) != 0)
+        fail("bad magic");
+    if (m_header->version != EpochArchive::kVersion)
+        fail("unsupported version");
+
+    const uint64_t indexBytes = m_header->blockCount * sizeof(EpochArchive::BlockIndexEntry);
+    if (m_header->indexOffset < sizeof(EpochArchive::FileHeader) || m_header->indexOffset % 8 != 0
+        || m_header->blockCount > m_size / sizeof(EpochArchive::BlockIndexEntry)
+        || m_header->indexOffset + indexBytes > m_size)
+        fail("corrupt block index");
+
+    m_index = reinterpret_cast<const EpochArchive::BlockIndexEntry *>(m_data + m_header->indexOffset);
+    m_blockCount = m_header->blockCount;
+
+    uint64_t expectedEpoch = 0;
+    uint64_t expectedOffset = sizeof(EpochArchive::FileHeader);
+    for (size_t b = 0; b < m_blockCount; ++b)
+    {
+        const EpochArchive::BlockIndexEntry &e = m_index[b];
+        if (e.offset != expectedOffset || e.firstEpoch != expectedEpoch || e.epochCount == 0
+            || (b > 0 && e.firstTimeMs < m_index[b - 1].lastTimeMs))
+            fail("corrupt block index");
+        expectedOffset += EpochArchive::blockSize(e.epochCount, e.satCount);
+        expectedEpoch += e.epochCount;
+    }
+    if (expectedOffset != m_header->indexOffset || expectedEpoch != m_header->epochCount)
+        fail("block index does not match header");
+}
+
+void EpochArchiveReader::close()
+{
+    if (m_data)
+        ::munmap(const_cast<uint8_t *>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_index = nullptr;
+    m_blockCount = 0;
+}
+
+EpochBlockView EpochArchiveReader::block(size_t i) const
+{
+    const EpochArchive::BlockIndexEntry &e = m_index[i];
+    const uint8_t *base = m_data + e.offset;
+    const BlockLayout layout = layoutFor(e.epochCount, e.satCount);
+
+    EpochBlockView view;
+    view.count = e.epochCount;
+    view.satCount = e.satCount;
+    view.firstEpoch = e.firstEpoch;
+    view.timeMs = columnAt<int64_t>(base, layout.timeMs);
+    view.latitude = columnAt<double>(base, layout.latitude);
+    view.longitude = columnAt<double>(base, layout.longitude);
+    view.altitude = columnAt<double>(base, layout.altitude);
+    view.hdop = columnAt<double>(base, layout.hdop);
+    view.vdop = columnAt<double>(base, layout.vdop);
+    view.snrAvg = columnAt<double>(base, layout.snrAvg);
+    view.satellites = columnAt<uint8_t>(base, layout.satellites);
+    view.fixQuality = columnAt<uint8_t>(base, layout.fixQuality);
+    view.satOffset = columnAt<uint32_t>(base, layout.satOffset);
+    view.satId = columnAt<int32_t>(base, layout.satId);
+    view.elevation = columnAt<float>(base, layout.elevation);
+    view.azimuth = columnAt<float>(base, layout.azimuth);
+    view.snr = columnAt<float>(base, layout.snr);
+
+    // Offsets index the satellite columns: non-decreasing from 0 to satCount
+    bool valid = view.satOffset[0] == 0 && view.satOffset[view.count] == view.satCount;
+    for (size_t k = 0; valid && k < view.count; ++k)
+        valid = view.satOffset[k] <= view.satOffset[k + 1];
+    if (!valid)
+    {
+        throw ArchiveError("corrupt satellite offsets in block " + std::to_string(i));
+    }
+    return view;
+}
+
+size_t EpochArchiveReader::findBlock(int64_t timeMs) const
+{
+    const auto *end = m_index + m_blockCount;
+    const auto *it = std::lower_bound(m_index, end, timeMs,
+        [](const EpochArchive::BlockIndexEntry &e, int64_t t) { return e.lastTimeMs < t; });
+    return it - m_index;
+}
+
+uint64_t EpochArchiveReader::lowerBound(int64_t timeMs) const
+{
+    const size_t b = findBlock(timeMs);
+    if (b == m_blockCount)
+        return epochCount();
+
+    const EpochBlockView view = block(b);
+    const int64_t *it = std::lower_bound(view.timeMs, view.timeMs + view.count, timeMs);
+    return view.firstEpoch + (it - view.timeMs);
+}
+
+void EpochArchiveReader::read(uint64_t first, uint64_t last, EpochColumns &out) const
+{
+    last = std::min(last, epochCount());
+    if (first >= last)
+        return;
+
+    const auto *end = m_index + m_blockCount;
+    const auto *it = std::upper_bound(m_index, end, first,
+        [](uint64_t epoch, const EpochArchive::BlockIndexEntry &e) { return epoch < e.firstEpoch; });
+    size_t b = (it - m_index) - 1;
+
+    for (uint64_t epoch = first; epoch < last; ++b)
+    {
+        const EpochBlockView view = block(b);
+        const size_t from = epoch - view.firstEpoch;
+        const size_t to = std::min<uint64_t>(view.count, last - view.firstEpoch);
+
+        out.timeMs.insert(out.timeMs.end(), view.timeMs + from, view.timeMs + to);
+        out.latitude.insert(out.latitude.end(), view.latitude + from, view.latitude + to);
+        out.longitude.insert(out.longitude.end(), view.longitude + from, view.longitude + to);
+        out.altitude.insert(out.altitude.end(), view.altitude + from, view.altitude + to);
+        out.hdop.insert(out.hdop.end(), view.hdop + from, view.hdop + to);
+        out.vdop.insert(out.vdop.end(), view.vdop + from, view.vdop + to);
+        out.snrAvg.insert(out.snrAvg.end(), view.snrAvg + from, view.snrAvg + to);
+        out.satellites.insert(out.satellites.end(), view.satellites + from, view.satellites + to);
+        out.fixQuality.insert(out.fixQuality.end(), view.fixQuality + from, view.fixQuality + to);
+
+        const size_t satFrom = view.satOffset[from];
+        const size_t satTo = view.satOffset[to];
+        const uint64_t base = out.satId.size();
+        for (size_t i = from + 1; i <= to; ++i)
+            out.satOffset.push_back(base + (view.satOffset[i] - satFrom));
+        out.satId.insert(out.satId.end(), view.satId + satFrom, view.satId + satTo);
+        out.elevation.insert(out.elevation.end(), view.elevation + satFrom, view.elevation + satTo);
+        out.azimuth.insert(out.azimuth.end(), view.azimuth + satFrom, view.azimuth + satTo);
+        out.snr.insert(out.snr.end(), view.snr + satFrom, view.snr + satTo);
+
+        epoch = view.firstEpoch + to;
+    }
+}
+
+void EpochArchiveReader::get(uint64_t i, GNSSData &data) const
+{
+    EpochColumns one;
+    read(i, i + 1, one);
+    if (one.size() != 1)
+    {
+        throw ArchiveError("epoch index out of range");
+    }
+    QtAdapter::toGNSSData(one, 0, data);
+}
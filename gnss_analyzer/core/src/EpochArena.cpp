@@ -0,0 +1,55 @@
+#include "EpochArena.hpp"
+#include <algorithm>
+
+EpochArena::EpochArena(size_t initialSize)
+{
+    m_blocks.reserve(8);
+    addBlock(std::max<size_t>(initialSize, 256));
+}
+
+void EpochArena::addBlock(size_t size)
+{
+    Block block;
+    block.data.reset(new std::byte[size]);
+    block.size = size;
+    m_blocks.push_back(std::move(block));
+    m_capacity += size;
+    ++m_blockAllocations;
+}
+
+void *EpochArena::do_allocate(size_t bytes, size_t alignment)
+{
+    for (;;)
+    {
+        Block &block = m_blocks[m_current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t start = ((base + m_offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+        if (start + bytes <= block.size)
+        {
+            m_offset = start + bytes;
+            m_used += bytes;
+            return block.data.get() + start;
+        }
+
+        // Next block, or a new one at least twice the last
+        if (m_current + 1 == m_blocks.size())
+            addBlock(std::max(2 * m_blocks.back().size, bytes + alignment));
+        ++m_current;
+        m_offset = 0;
+    }
+}
+
+void EpochArena::reset()
+{
+    if (m_current > 0)
+    {
+        // This epoch spilled over: one block of the whole size from now on
+        const size_t total = m_capacity;
+        m_blocks.clear();
+        m_capacity = 0;
+        addBlock(total);
+    }
+    m_current = 0;
+    m_offset = 0;
+    m_used = 0;
+}
@@ -0,0 +1,315 @@
+#include "EpochCodec.hpp"
+#include "ArchiveError.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    constexpr char kMagic[4] = {'G', 'E', 'C', '1'};
+    // Trailing zero bytes so the unpacker may always load 9 bytes past a field
+    constexpr size_t kPadding = 16;
+
+    inline uint64_t zigzag(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+    inline int64_t unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+    // Two's complement wrap-around, so that extreme deltas round-trip
+    inline int64_t sub(int64_t a, int64_t b) { return int64_t(uint64_t(a) - uint64_t(b)); }
+    inline int64_t add(int64_t a, int64_t b) { return int64_t(uint64_t(a) + uint64_t(b)); }
+
+    int64_t quantize(double value, double scale)
+    {
+        const double q = std::nearbyint(value * scale);
+        if (!std::isfinite(q) || std::fabs(q) > 0x1p62)
+        {
+            throw ArchiveError("value not representable by the epoch codec");
+        }
+        return static_cast<int64_t>(q);
+    }
+
+    void putVarint(std::vector<uint8_t> &out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(uint8_t(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(uint8_t(v));
+    }
+
+    /// Pack @p count residuals at the smallest common width, LSB first.
+    void putPacked(std::vector<uint8_t> &out, const uint64_t *values, size_t count)
+    {
+        uint64_t any = 0;
+        for (size_t i = 0; i < count; ++i)
+            any |= values[i];
+        const unsigned width = any ? 64 - __builtin_clzll(any) : 0;
+        out.push_back(uint8_t(width));
+        if (width == 0)
+            return;
+
+        const size_t bytes = (count * width + 7) / 8;
+        const size_t base = out.size();
+        // A field spans at most 9 bytes; the slack is trimmed afterwards
+        out.resize(base + bytes + 9, 0);
+        uint8_t *dst = out.data() + base;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t bit = i * width;
+            const unsigned shift = bit & 7;
+            uint8_t *p = dst + (bit >> 3);
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            word |= values[i] << shift;
+            std::memcpy(p, &word, sizeof(word));
+            if (shift + width > 64)
+                p[8] |= uint8_t(values[i] >> (64 - shift));
+        }
+        out.resize(base + bytes);
+    }
+
+    class Reader {
+    public:
+        Reader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+        uint64_t varint()
+        {
+            uint64_t v = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                need(1);
+                const uint8_t b = m_data[m_pos++];
+                v |= uint64_t(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return v;
+            }
+            throw ArchiveError("epoch codec: malformed varint");
+        }
+
+        /// Unpack @p count residuals into @p values.
+        void packed(uint64_t *values, size_t count)
+        {
+            need(1);
+            const unsigned width = m_data[m_pos++];
+            if (width > 64)
+            {
+                throw ArchiveError("epoch codec: invalid bit width");
+            }
+            if (width == 0)
+            {
+                std::memset(values, 0, count * sizeof(uint64_t));
+                return;
+            }
+            const size_t bytes = (count * width + 7) / 8;
+            need(bytes + 9);
+            const uint8_t *src = m_data + m_pos;
+            const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+
+            if (width <= 56)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const size_t bit = i * width;
+                    uint64_t word;
+                    std::memcpy(&word, src + (bit >> 3), sizeof(word));
+                    values[i] = (word >> (bit & 7)) & mask;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const size_t bit = i * width;
+                    const unsigned shift = bit & 7;
+                    uint64_t word;
+                    std::memcpy(&word, src + (bit >> 3), sizeof(word));
+                    uint64_t v = word >> shift;
+                    if (shift)
+                        v |= uint64_t(src[(bit >> 3) + 8]) << (64 - shift);
+                    values[i] = v & mask;
+                }
+            }
+            m_pos += bytes;
+        }
+
+        size_t position() const { return m_pos; }
+
+    private:
+        void need(size_t n) const
+        {
+            if (m_size - m_pos < n)
+            {
+                throw ArchiveError("epoch codec: truncated stream");
+            }
+        }
+
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+    };
+
+    /// First value plus packed zigzag deltas.
+    void encodeDelta(std::vector<uint8_t> &out, const int64_t *q, size_t n, uint64_t *scratch)
+    {
+        putVarint(out, zigzag(q[0]));
+        for (size_t i = 1; i < n; ++i)
+            scratch[i - 1] = zigzag(sub(q[i], q[i - 1]));
+        putPacked(out, scratch, n - 1);
+    }
+
+    void decodeDelta(Reader &in, int64_t *q, size_t n, uint64_t *scratch)
+    {
+        q[0] = unzigzag(in.varint());
+        in.packed(scratch, n - 1);
+        for (size_t i = 1; i < n; ++i)
+            q[i] = add(q[i - 1], unzigzag(scratch[i - 1]));
+    }
+
+    template <typename T>
+    void encodeScaled(std::vector<uint8_t> &out, const std::vector<T> &column, size_t first, size_t n,
+                      double scale, int64_t *q, uint64_t *scratch)
+    {
+        for (size_t i = 0; i < n; ++i)
+            q[i] = quantize(column[first + i], scale);
+        encodeDelta(out, q, n, scratch);
+    }
+
+    void decodeScaled(Reader &in, double *column, size_t n, double scale, int64_t *q, uint64_t *scratch)
+    {
+        decodeDelta(in, q, n, scratch);
+        const double inverse = 1.0 / scale;
+        for (size_t i = 0; i < n; ++i)
+            column[i] = q[i] * inverse;
+    }
+
+    void decodeSmall(Reader &in, uint8_t *column, size_t n, int64_t *q, uint64_t *scratch)
+    {
+        decodeDelta(in, q, n, scratch);
+        for (size_t i = 0; i < n; ++i)
+            column[i] = uint8_t(q[i]);
+    }
+
+    void decodeBlocks(Reader &in, EpochColumns &out, size_t base, uint64_t count)
+    {
+        int64_t q[EpochCodec::kBlockSize];
+        uint64_t scratch[EpochCodec::kBlockSize];
+
+        for (uint64_t first = 0; first < count; first += EpochCodec::kBlockSize)
+        {
+            const size_t n = std::min<uint64_t>(EpochCodec::kBlockSize, count - first);
+            const size_t at = base + first;
+
+            int64_t *t = out.timeMs.data() + at;
+            t[0] = unzigzag(in.varint());
+            if (n > 1)
+            {
+                int64_t delta = unzigzag(in.varint());
+                t[1] = add(t[0], delta);
+                in.packed(scratch, n - 2);
+                for (size_t i = 2; i < n; ++i)
+                {
+                    delta = add(delta, unzigzag(scratch[i - 2]));
+                    t[i] = add(t[i - 1], delta);
+                }
+            }
+
+            decodeScaled(in, out.latitude.data() + at, n, EpochCodec::kDegreeScale, q, scratch);
+            decodeScaled(in, out.longitude.data() + at, n, EpochCodec::kDegreeScale, q, scratch);
+            decodeScaled(in, out.altitude.data() + at, n, EpochCodec::kAltitudeScale, q, scratch);
+            decodeScaled(in, out.hdop.data() + at, n, EpochCodec::kRatioScale, q, scratch);
+            decodeScaled(in, out.vdop.data() + at, n, EpochCodec::kRatioScale, q, scratch);
+            decodeScaled(in, out.snrAvg.data() + at, n, EpochCodec::kRatioScale, q, scratch);
+            decodeSmall(in, out.satellites.data() + at, n, q, scratch);
+            decodeSmall(in, out.fixQuality.data() + at, n, q, scratch);
+        }
+    }
+}
+
+namespace EpochCodec {
+
+    void encode(const EpochColumns &columns, std::vector<uint8_t> &out)
+    {
+        const size_t count = columns.size();
+        out.insert(out.end(), kMagic, kMagic + sizeof(kMagic));
+        putVarint(out, count);
+
+        int64_t q[kBlockSize];
+        uint64_t scratch[kBlockSize];
+
+        for (size_t first = 0; first < count; first += kBlockSize)
+        {
+            const size_t n = std::min(kBlockSize, count - first);
+
+            // --- Time: first value, first delta, packed delta-of-delta ---
+            const int64_t *t = columns.timeMs.data() + first;
+            putVarint(out, zigzag(t[0]));
+            if (n > 1)
+            {
+                putVarint(out, zigzag(sub(t[1], t[0])));
+                for (size_t i = 2; i < n; ++i)
+                    scratch[i - 2] = zigzag(sub(sub(t[i], t[i - 1]), sub(t[i - 1], t[i - 2])));
+                putPacked(out, scratch, n - 2);
+            }
+
+            encodeScaled(out, columns.latitude, first, n, kDegreeScale, q, scratch);
+            encodeScaled(out, columns.longitude, first, n, kDegreeScale, q, scratch);
+            encodeScaled(out, columns.altitude, first, n, kAltitudeScale, q, scratch);
+            encodeScaled(out, columns.hdop, first, n, kRatioScale, q, scratch);
+            encodeScaled(out, columns.vdop, first, n, kRatioScale, q, scratch);
+            encodeScaled(out, columns.snrAvg, first, n, kRatioScale, q, scratch);
+            encodeScaled(out, columns.satellites, first, n, 1.0, q, scratch);
+            encodeScaled(out, columns.fixQuality, first, n, 1.0, q, scratch);
+        }
+        out.insert(out.end(), kPadding, 0);
+    }
+
+    std::vector<uint8_t> encode(const EpochColumns &columns)
+    {
+        std::vector<uint8_t> out;
+        encode(columns, out);
+        return out;
+    }
+
+    void decode(const uint8_t *data, size_t size, EpochColumns &out)
+    {
+        if (size < sizeof(kMagic) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+        {
+            throw ArchiveError("epoch codec: bad magic");
+        }
+        Reader in(data + sizeof(kMagic), size - sizeof(kMagic));
+        const uint64_t count = in.varint();
+        // Each epoch costs at least one bit per column; reject absurd counts early
+        if (count > (size - sizeof(kMagic)) * 8)
+        {
+            throw ArchiveError("epoch codec: epoch count exceeds stream size");
+        }
+        const size_t base = out.size();
+        const size_t total = base + count;
+        out.timeMs.resize(total);
+        out.latitude.resize(total);
+        out.longitude.resize(total);
+        out.altitude.resize(total);
+        out.hdop.resize(total);
+        out.vdop.resize(total);
+        out.snrAvg.resize(total);
+        out.satellites.resize(total);
+        out.fixQuality.resize(total);
+
+        try {
+            decodeBlocks(in, out, base, count);
+        } catch (const ArchiveError &) {
+            // Leave the caller's columns as they were
+            out.timeMs.resize(base);
+            out.latitude.resize(base);
+            out.longitude.resize(base);
+            out.altitude.resize(base);
+            out.hdop.resize(base);
+            out.vdop.resize(base);
+            out.snrAvg.resize(base);
+            out.satellites.resize(base);
+            out.fixQuality.resize(base);
+            throw;
+        }
+        out.satOffset.insert(out.satOffset.end(), count, out.satOffset.back());
+    }
+};
@@ -0,0 +1,101 @@
+#include "EpochColumns.hpp"
+#include "EpochRecord.hpp"
+
+void EpochColumns::clear()
+{
+    timeMs.clear();
+    latitude.clear();
+    longitude.clear();
+    altitude.clear();
+    hdop.clear();
+    vdop.clear();
+    snrAvg.clear();
+    satellites.clear();
+    fixQuality.clear();
+    satOffset.assign(1, 0);
+    satId.clear();
+    elevation.clear();
+    azimuth.clear();
+    snr.clear();
+}
+
+void EpochColumns::reserve(size_t epochs, size_t satellitesPerEpoch)
+{
+    timeMs.reserve(epochs);
+    latitude.reserve(epochs);
+    longitude.reserve(epochs);
+    altitude.reserve(epochs);
+    hdop.reserve(epochs);
+    vdop.reserve(epochs);
+    snrAvg.reserve(epochs);
+    satellites.reserve(epochs);
+    fixQuality.reserve(epochs);
+    satOffset.reserve(epochs + 1);
+
+    const size_t sats = epochs * satellitesPerEpoch;
+    satId.reserve(sats);
+    elevation.reserve(sats);
+    azimuth.reserve(sats);
+    snr.reserve(sats);
+}
+
+void EpochColumns::append(const EpochRecord &record)
+{
+    timeMs.push_back(record.timeMs());
+    latitude.push_back(record.latitude);
+    longitude.push_back(record.longitude);
+    altitude.push_back(record.altitude);
+    hdop.push_back(record.hdop);
+    vdop.push_back(record.vdop);
+    snrAvg.push_back(record.snrAvg);
+    satellites.push_back(record.satellites);
+    fixQuality.push_back(record.fixQuality);
+
+    for (const SatelliteRecord &satellite : record.satellitesInView)
+    {
+        satId.push_back(satellite.id);
+        elevation.push_back(static_cast<float>(satellite.elevation));
+        azimuth.push_back(static_cast<float>(satellite.azimuth));
+        snr.push_back(static_cast<float>(satellite.snr));
+    }
+    satOffset.push_back(satId.size());
+}
+
+void EpochColumns::append(const EpochColumns &other, size_t i)
+{
+    timeMs.push_back(other.timeMs[i]);
+    latitude.push_back(other.latitude[i]);
+    longitude.push_back(other.longitude[i]);
+    altitude.push_back(other.altitude[i]);
+    hdop.push_back(other.hdop[i]);
+    vdop.push_back(other.vdop[i]);
+    snrAvg.push_back(other.snrAvg[i]);
+    satellites.push_back(other.satellites[i]);
+    fixQuality.push_back(other.fixQuality[i]);
+
+    const size_t first = other.satOffset[i];
+    const size_t last = other.satOffset[i + 1];
+    satId.insert(satId.end(), other.satId.begin() + first, other.satId.begin() + last);
+    elevation.insert(elevation.end(), other.elevation.begin() + first, other.elevation.begin() + last);
+    azimuth.insert(azimuth.end(), other.azimuth.begin() + first, other.azimuth.begin() + last);
+    snr.insert(snr.end(), other.snr.begin() + first, other.snr.begin() + last);
+    satOffset.push_back(satId.size());
+}
+
+void EpochColumns::get(size_t i, EpochRecord &record) const
+{
+    record.time = EpochTime(std::chrono::milliseconds(timeMs[i]));
+    record.hasTime = true;
+    record.latitude = latitude[i];
+    record.longitude = longitude[i];
+    record.altitude = altitude[i];
+    record.hdop = hdop[i];
+    record.vdop = vdop[i];
+    record.snrAvg = snrAvg[i];
+    record.satellites = satellites[i];
+    record.fixQuality = fixQuality[i];
+
+    record.satellitesInView.clear();
+    for (size_t s = satOffset[i]; s < satOffset[i + 1]; ++s)
+        record.satellitesInView.push_back(SatelliteRecord{satId[s], elevation[s], azimuth[s], snr[s]});
+}
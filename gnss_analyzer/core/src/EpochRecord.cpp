@@ -0,0 +1,25 @@
+#include "EpochRecord.hpp"
+
+EpochRecord::EpochRecord(const EpochRecord &other, const allocator_type &allocator)
+    : time(other.time), hasTime(other.hasTime), latitude(other.latitude), longitude(other.longitude),
+      altitude(other.altitude), hdop(other.hdop), vdop(other.vdop), snrAvg(other.snrAvg),
+      satellites(other.satellites), fixQuality(other.fixQuality),
+      satellitesInView(other.satellitesInView, allocator)
+{
+}
+
+const char *fixQualityName(uint8_t fixQuality)
+{
+    switch (fixQuality)
+    {
+        case 1: return "GPS Fix";
+        case 2: return "DGPS Fix";
+        case 4: return "RTK Fix";
+        default: return "No Fix";
+    }
+}
+
+double averageSnr(const SatelliteList &satellites)
+{
+    return averageTrackedSnr(satellites);
+}
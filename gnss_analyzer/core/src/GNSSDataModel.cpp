@@ -0,0 +1,22 @@
+#include "GNSSDataModel.hpp"
+
+uint8_t fixQualityCode(const QString &fixType)
+{
+    if (fixType == "GPS Fix")
+        return 1;
+    if (fixType == "DGPS Fix")
+        return 2;
+    if (fixType == "RTK Fix")
+        return 4;
+    return 0;
+}
+
+QString fixTypeLabel(uint8_t fixQuality)
+{
+    return QString(fixQualityName(fixQuality));
+}
+
+double averageSnr(const QMap<int, SATInfo> &satMap)
+{
+    return averageTrackedSnr(satMap);
+}
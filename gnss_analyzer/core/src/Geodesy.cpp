@@ -0,0 +1,287 @@
+#include "Geodesy.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kPiOver2 = kPi / 2;
+    constexpr double kPiOver4 = kPi / 4;
+    constexpr double kDegToRad = kPi / 180.0;
+    constexpr double kRadToDeg = 180.0 / kPi;
+    constexpr double kSecondEccentricity2 =
+        (Geodesy::kSemiMajorAxis * Geodesy::kSemiMajorAxis - Geodesy::kSemiMinorAxis * Geodesy::kSemiMinorAxis)
+        / (Geodesy::kSemiMinorAxis * Geodesy::kSemiMinorAxis);
+
+    inline uint64_t bits(double v)
+    {
+        uint64_t b;
+        std::memcpy(&b, &v, sizeof(b));
+        return b;
+    }
+
+    inline double fromBits(uint64_t b)
+    {
+        double v;
+        std::memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+
+    /**
+     * Branch-free sin/cos. Cody-Waite reduction by pi/2 (exact for
+     * |x| < 2^20 * pi/2) and the fdlibm minimax kernels on [-pi/4, pi/4].
+     * The quadrant is read from the mantissa of the rounding bias, so the
+     * whole function is integer/float arithmetic plus selects.
+     */
+    inline void fastSinCos(double x, double &sinOut, double &cosOut)
+    {
+        constexpr double kRoundBias = 0x1.8p52;
+        constexpr double kTwoOverPi = 0.63661977236758134308;
+        constexpr double kPio2Hi = 1.57079632673412561417e+00;
+        constexpr double kPio2Mid = 6.07710050630396597660e-11;
+        constexpr double kPio2Lo = 2.02226624871116645580e-21;
+
+        const double biased = x * kTwoOverPi + kRoundBias;
+        const double q = biased - kRoundBias;
+        const uint64_t quadrant = bits(biased);
+
+        const double r = ((x - q * kPio2Hi) - q * kPio2Mid) - q * kPio2Lo;
+        const double z = r * r;
+
+        const double sinPoly = -1.66666666666666324348e-01 + z * (8.33333333332248946124e-03
+                             + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+                             + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10))));
+        const double cosPoly = 4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03
+                             + z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07
+                             + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11))));
+        const double s = r + r * z * sinPoly;
+        const double c = 1.0 - 0.5 * z + z * z * cosPoly;
+
+        // Odd quadrants swap sin and cos; bit 1 of q (resp. q + 1) negates
+        const uint64_t swap = uint64_t(0) - (quadrant & 1);
+        const uint64_t sBits = bits(s);
+        const uint64_t cBits = bits(c);
+        sinOut = fromBits(((sBits & ~swap) | (cBits & swap)) ^ ((quadrant & 2) << 62));
+        cosOut = fromBits(((cBits & ~swap) | (sBits & swap)) ^ (((quadrant + 1) & 2) << 62));
+    }
+
+    /**
+     * Cephes atan on [0, inf). The three reduction ranges are blended with
+     * 0/1 weights rather than selected, which keeps the vectorizer away from
+     * mixed bool/double masks it cannot handle.
+     */
+    inline double fastAtanPositive(double x)
+    {
+        constexpr double kTan3Pi8 = 2.41421356237309504880;
+        constexpr double kMoreBits = 6.123233995736765886130e-17;
+
+        // Exactly one of low/mid/big is 1: x, (x - 1) / (x + 1), -1 / x
+        const double big = static_cast<double>(x > kTan3Pi8);
+        const double mid = static_cast<double>(x > 0.66) - big;
+        const double low = 1.0 - big - mid;
+
+        const double num = x - mid - big * (x + 1.0);
+        const double den = low + mid * (x + 1.0) + big * x;
+        const double t = num / den;
+        const double base = big * kPiOver2 + mid * kPiOver4;
+        const double extra = big * kMoreBits + mid * (0.5 * kMoreBits);
+
+        const double z = t * t;
+        const double p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z
+                         - 7.500855792314704667340e1) * z - 1.228866684490136173410e2) * z
+                         - 6.485021904942025371773e1;
+        const double q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z
+                         + 4.328810604912902668951e2) * z + 4.853903996359136964868e2) * z
+                         + 1.945506571482613964425e2;
+        return base + (t * z * p / q + t + extra);
+    }
+
+    inline double fastAtan2(double y, double x)
+    {
+        const double ay = std::fabs(y);
+        const double ax = std::fabs(x);
+        // atan of min/max <= 1, so x == 0 never divides by zero; y == x == 0 yields 0 like std::atan2
+        const double lo = std::min(ay, ax);
+        const double hi = std::max(ay, ax);
+        const double ratio = hi == 0.0 ? 0.0 : lo / hi;
+        const double r = fastAtanPositive(ratio);
+        const double a = ay > ax ? kPiOver2 - r : r;
+        const double reflected = x < 0.0 ? kPi - a : a;
+        return std::copysign(reflected, y);
+    }
+
+    inline void llaToEcefPoint(double latDeg, double lonDeg, double alt, double &x, double &y, double &z)
+    {
+        double sinLat, cosLat, sinLon, cosLon;
+        fastSinCos(latDeg * kDegToRad, sinLat, cosLat);
+        fastSinCos(lonDeg * kDegToRad, sinLon, cosLon);
+        const double n = Geodesy::kSemiMajorAxis / std::sqrt(1.0 - Geodesy::kEccentricity2 * sinLat * sinLat);
+        x = (n + alt) * cosLat * cosLon;
+        y = (n + alt) * cosLat * sinLon;
+        z = (n * (1.0 - Geodesy::kEccentricity2) + alt) * sinLat;
+    }
+
+    /// Bowring's method: two closed-form steps, the second from the parametric latitude of the first.
+    inline void ecefToLlaPoint(double x, double y, double z, double &latDeg, double &lonDeg, double &alt)
+    {
+        constexpr double a = Geodesy::kSemiMajorAxis;
+        constexpr double b = Geodesy::kSemiMinorAxis;
+
+        const double p = std::sqrt(x * x + y * y);
+        const double za = z * a;
+        const double pb = p * b;
+        const double r = std::sqrt(za * za + pb * pb);
+        const double invR = 1.0 / r;
+        double sinTheta = r > 0.0 ? za * invR : 0.0;
+        double cosTheta = r > 0.0 ? pb * invR : 1.0;
+
+        double num = z + kSecondEccentricity2 * b * sinTheta * sinTheta * sinTheta;
+        double den = p - Geodesy::kEccentricity2 * a * cosTheta * cosTheta * cosTheta;
+
+        // Second step from the parametric latitude of the first (see Geodesy.hpp for the error)
+        const double bn = b * num;
+        const double ad = a * den;
+        const double t = std::sqrt(bn * bn + ad * ad);
+        const double invT = 1.0 / t;
+        sinTheta = t > 0.0 ? bn * invT : 0.0;
+        cosTheta = t > 0.0 ? ad * invT : 1.0;
+        num = z + kSecondEccentricity2 * b * sinTheta * sinTheta * sinTheta;
+        den = p - Geodesy::kEccentricity2 * a * cosTheta * cosTheta * cosTheta;
+
+        const double rho = std::sqrt(num * num + den * den);
+        const double invRho = 1.0 / rho;
+        const double sinLat = rho > 0.0 ? num * invRho : 0.0;
+        const double cosLat = rho > 0.0 ? den * invRho : 1.0;
+
+        latDeg = fastAtan2(num, den) * kRadToDeg;
+        lonDeg = fastAtan2(y, x) * kRadToDeg;
+        alt = p * cosLat + z * sinLat - a * std::sqrt(1.0 - Geodesy::kEccentricity2 * sinLat * sinLat);
+    }
+}
+
+namespace Geodesy {
+
+    ENUFrame makeENUFrame(double latDeg, double lonDeg, double alt)
+    {
+        ENUFrame frame;
+        llaToEcef(latDeg, lonDeg, alt, frame.originX, frame.originY, frame.originZ);
+        frame.sinLat = std::sin(latDeg * kDegToRad);
+        frame.cosLat = std::cos(latDeg * kDegToRad);
+        frame.sinLon = std::sin(lonDeg * kDegToRad);
+        frame.cosLon = std::cos(lonDeg * kDegToRad);
+        return frame;
+    }
+
+    void llaToEcef(double latDeg, double lonDeg, double alt, double &x, double &y, double &z)
+    {
+        const double lat = latDeg * kDegToRad;
+        const double lon = lonDeg * kDegToRad;
+        const double sinLat = std::sin(lat);
+        const double n = kSemiMajorAxis / std::sqrt(1.0 - kEccentricity2 * sinLat * sinLat);
+        x = (n + alt) * std::cos(lat) * std::cos(lon);
+        y = (n + alt) * std::cos(lat) * std::sin(lon);
+        z = (n * (1.0 - kEccentricity2) + alt) * sinLat;
+    }
+
+    void ecefToLla(double x, double y, double z, double &latDeg, double &lonDeg, double &alt)
+    {
+        // Fixed-point iteration on the latitude, converged to machine precision
+        const double p = std::hypot(x, y);
+        double lat = std::atan2(z, p * (1.0 - kEccentricity2));
+        double n = kSemiMajorAxis;
+        for (int i = 0; i < 10; ++i)
+        {
+            const double sinLat = std::sin(lat);
+            n = kSemiMajorAxis / std::sqrt(1.0 - kEccentricity2 * sinLat * sinLat);
+            const double next = std::atan2(z + kEccentricity2 * n * sinLat, p);
+            if (next == lat)
+                break;
+            lat = next;
+        }
+        const double sinLat = std::sin(lat);
+        latDeg = lat * kRadToDeg;
+        lonDeg = std::atan2(y, x) * kRadToDeg;
+        alt = p * std::cos(lat) + z * sinLat - kSemiMajorAxis * std::sqrt(1.0 - kEccentricity2 * sinLat * sinLat);
+    }
+
+    void ecefToEnu(const ENUFrame &f, double x, double y, double z, double &e, double &n, double &u)
+    {
+        const double dx = x - f.originX;
+        const double dy = y - f.originY;
+        const double dz = z - f.originZ;
+        e = -f.sinLon * dx + f.cosLon * dy;
+        n = -f.sinLat * f.cosLon * dx - f.sinLat * f.sinLon * dy + f.cosLat * dz;
+        u = f.cosLat * f.cosLon * dx + f.cosLat * f.sinLon * dy + f.sinLat * dz;
+    }
+
+    void llaToEcef(const double *__restrict latDeg, const double *__restrict lonDeg,
+                   const double *__restrict alt, size_t count,
+                   double *__restrict x, double *__restrict y, double *__restrict z)
+    {
+        for (size_t i = 0; i < count; ++i)
+            llaToEcefPoint(latDeg[i], lonDeg[i], alt[i], x[i], y[i], z[i]);
+    }
+
+    void ecefToLla(const double *__restrict x, const double *__restrict y, const double *__restrict z,
+                   size_t count,
+                   double *__restrict latDeg, double *__restrict lonDeg, double *__restrict alt)
+    {
+        for (size_t i = 0; i < count; ++i)
+            ecefToLlaPoint(x[i], y[i], z[i], latDeg[i], lonDeg[i], alt[i]);
+    }
+
+    void ecefToEnu(const ENUFrame &frame, const double *__restrict x, const double *__restrict y,
+                   const double *__restrict z, size_t count,
+                   double *__restrict e, double *__restrict n, double *__restrict u)
+    {
+        const ENUFrame f = frame;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double dx = x[i] - f.originX;
+            const double dy = y[i] - f.originY;
+            const double dz = z[i] - f.originZ;
+            e[i] = -f.sinLon * dx + f.cosLon * dy;
+            n[i] = -f.sinLat * f.cosLon * dx - f.sinLat * f.sinLon * dy + f.cosLat * dz;
+            u[i] = f.cosLat * f.cosLon * dx + f.cosLat * f.sinLon * dy + f.sinLat * dz;
+        }
+    }
+
+    void llaToEnu(const ENUFrame &frame, const double *__restrict latDeg, const double *__restrict lonDeg,
+                  const double *__restrict alt, size_t count,
+                  double *__restrict e, double *__restrict n, double *__restrict u)
+    {
+        const ENUFrame f = frame;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double x, y, z;
+            llaToEcefPoint(latDeg[i], lonDeg[i], alt[i], x, y, z);
+            const double dx = x - f.originX;
+            const double dy = y - f.originY;
+            const double dz = z - f.originZ;
+            e[i] = -f.sinLon * dx + f.cosLon * dy;
+            n[i] = -f.sinLat * f.cosLon * dx - f.sinLat * f.sinLon * dy + f.cosLat * dz;
+            u[i] = f.cosLat * f.cosLon * dx + f.cosLat * f.sinLon * dy + f.sinLat * dz;
+        }
+    }
+
+    void enuToLla(const ENUFrame &frame, const double *__restrict e, const double *__restrict n,
+                  const double *__restrict u, size_t count,
+                  double *__restrict latDeg, double *__restrict lonDeg, double *__restrict alt)
+    {
+        const ENUFrame f = frame;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double x = f.originX - f.sinLon * e[i] - f.sinLat * f.cosLon * n[i] + f.cosLat * f.cosLon * u[i];
+            const double y = f.originY + f.cosLon * e[i] - f.sinLat * f.sinLon * n[i] + f.cosLat * f.sinLon * u[i];
+            const double z = f.originZ + f.cosLat * n[i] + f.sinLat * u[i];
+            ecefToLlaPoint(x, y, z, latDeg[i], lonDeg[i], alt[i]);
+        }
+    }
+
+    void sinCos(const double *__restrict radians, size_t count, double *__restrict sinOut, double *__restrict cosOut)
+    {
+        for (size_t i = 0; i < count; ++i)
+            fastSinCos(radians[i], sinOut[i], cosOut[i]);
+    }
+};
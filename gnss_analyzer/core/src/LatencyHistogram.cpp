@@ -0,0 +1,45 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index)
+{
+    constexpr int kHalf = kSubBucketBits - 1;
+    if (index < (size_t(1) << kSubBucketBits))
+        return index;
+    const int shift = int(index >> kHalf) - 1;
+    const uint64_t mantissa = (index & ((size_t(1) << kHalf) - 1)) | (uint64_t(1) << kHalf);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const
+{
+    if (m_count == 0)
+        return 0;
+    const double clamped = std::clamp(percentile, 0.0, 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(clamped / 100.0 * double(m_count))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= rank)
+            return std::clamp(bucketUpperBound(i), min(), m_max);
+    }
+    return m_max;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (size_t i = 0; i < kBuckets; ++i)
+        m_counts[i] += other.m_counts[i];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
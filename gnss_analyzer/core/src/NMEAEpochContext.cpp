@@ -0,0 +1,98 @@
+#include "NMEAEpochContext.hpp"
+#include "NMEAException.hpp"
+#include <chrono>
+#include <utility>
+
+NMEAEpochContext::NMEAEpochContext(size_t arenaSize)
+    : m_arenas{EpochArena(arenaSize), EpochArena(arenaSize)}
+{
+    m_record.emplace(EpochRecord::allocator_type(&m_arenas[0]));
+}
+
+void NMEAEpochContext::endEpoch()
+{
+    // The other arena has held nothing live since the last boundary
+    const size_t next = 1 - m_active;
+    m_arenas[next].reset();
+    EpochRecord moved(*m_record, EpochRecord::allocator_type(&m_arenas[next]));
+    m_record.emplace(std::move(moved));
+    m_active = next;
+    m_epochDone = false;
+}
+
+bool NMEAEpochContext::parse(std::string_view line)
+{
+#ifndef GNSS_PARSE_STATS
+    if (m_epochDone)
+        endEpoch();
+    return parseSentence(line);
+#else
+    using Clock = std::chrono::steady_clock;
+    ParseStats::Shard &stats = m_stats.local();
+    switch (NMEAStreamParser::sentenceType(line))
+    {
+    case DATAType::GGA: stats.add(ParseCounter::GGASentences); break;
+    case DATAType::GSV: stats.add(ParseCounter::GSVSentences); break;
+    default:            stats.add(ParseCounter::OtherSentences); break;
+    }
+    stats.add(ParseCounter::Bytes, line.size());
+
+    const bool timed = stats.sampleTiming();
+    Clock::time_point start;
+    if (timed)
+        start = Clock::now();
+    if (m_epochDone)
+        endEpoch();
+    Clock::time_point epochEnd;
+    if (timed)
+        epochEnd = Clock::now();
+    if (NMEAStreamParser::checksumMismatch(line))
+        stats.add(ParseCounter::ChecksumFailures);
+    Clock::time_point checksum;
+    if (timed)
+        checksum = Clock::now();
+
+    const uint64_t resets = m_parser.sequenceResets();
+    const bool done = parseSentence(line, &stats);
+    if (m_parser.sequenceResets() != resets)
+        stats.add(ParseCounter::GSVResets);
+
+    if (timed)
+    {
+        const auto ns = [](Clock::duration d) {
+            return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        };
+        stats.add(ParseCounter::EpochEndNs, ns(epochEnd - start));
+        stats.add(ParseCounter::ChecksumNs, ns(checksum - epochEnd));
+        stats.add(ParseCounter::ParseNs, ns(Clock::now() - checksum));
+        stats.add(ParseCounter::TimedSentences);
+    }
+    return done;
+#endif
+}
+
+bool NMEAEpochContext::parseSentence(std::string_view line, ParseStats::Shard *stats)
+{
+    try
+    {
+        if (m_parser.parse(line, *m_record) != NMEAStreamParser::Update::Fix)
+            return false;
+    }
+    catch (const InvalidDataError &)
+    {
+        ++m_rejected;
+        if (stats)
+            stats->add(ParseCounter::InvalidDataErrors);
+        return false;
+    }
+    catch (const NMEAException &)
+    {
+        ++m_rejected;
+        if (stats)
+            stats->add(ParseCounter::ParsingErrors);
+        return false;
+    }
+    ++m_epochs;
+    m_epochDone = true;
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "NMEAFramer.hpp"
+#include <algorithm>
+#include <cstring>
+
+NMEAFramer::NMEAFramer(size_t maxLineLength)
+    : m_maxLineLength(std::max<size_t>(maxLineLength, 16))
+{
+}
+
+void NMEAFramer::compact()
+{
+    // Drop returned bytes before growing, so the buffer stays bounded by
+    // one line plus one read
+    if (m_head == 0)
+        return;
+    std::memmove(&m_buffer[0], m_buffer.data() + m_head, m_size - m_head);
+    m_size -= m_head;
+    m_scan -= m_head;
+    m_head = 0;
+}
+
+char *NMEAFramer::writeBuffer(size_t capacity)
+{
+    compact();
+    if (m_buffer.size() < m_size + capacity)
+        m_buffer.resize(std::max(m_size + capacity, 2 * m_buffer.size()));
+    return &m_buffer[m_size];
+}
+
+void NMEAFramer::commit(size_t length)
+{
+    m_size = std::min(m_size + length, m_buffer.size());
+}
+
+void NMEAFramer::feed(const char *data, size_t length)
+{
+    std::memcpy(writeBuffer(length), data, length);
+    commit(length);
+}
+
+bool NMEAFramer::next(std::string_view &line)
+{
+    const char *base = m_buffer.data();
+    while (m_head < m_size)
+    {
+        const void *newline = std::memchr(base + m_scan, '\n', m_size - m_scan);
+        if (!newline)
+        {
+            m_scan = m_size;
+            if (m_size - m_head > m_maxLineLength)
+            {
+                // Overlong: forget it up to the next newline
+                if (!m_discarding)
+                    ++m_overlongLines;
+                m_discarding = true;
+                m_head = m_scan = m_size;
+            }
+            return false;
+        }
+
+        const size_t start = m_head;
+        size_t end = static_cast<const char *>(newline) - base;
+        m_head = m_scan = end + 1;
+        if (m_discarding)
+        {
+            m_discarding = false;
+            continue;
+        }
+        if (end - start > m_maxLineLength)
+        {
+            ++m_overlongLines;
+            continue;
+        }
+        if (end > start && base[end - 1] == '\r')
+            --end;
+        line = std::string_view(base + start, end - start);
+        return true;
+    }
+    return false;
+}
+
+bool NMEAFramer::flush(std::string_view &line)
+{
+    if (next(line))
+        return true;
+    const size_t start = m_head;
+    size_t end = m_size;
+    m_head = m_scan = m_size;
+    if (m_discarding || start == end)
+    {
+        m_discarding = false;
+        return false;
+    }
+    if (m_buffer[end - 1] == '\r')
+        --end;
+    line = std::string_view(m_buffer.data() + start, end - start);
+    return true;
+}
+
+void NMEAFramer::clear()
+{
+    m_head = m_size = m_scan = 0;
+    m_discarding = false;
+}
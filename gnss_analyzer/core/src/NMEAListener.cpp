@@ -0,0 +1,501 @@
+#include "NMEAListener.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+    constexpr int kMaxEvents = 64;
+    constexpr int kReadsPerEvent = 16;      // recvmmsg/read calls before the other sockets get a turn
+
+    [[noreturn]] void throwErrno(const char *what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    /// Parse an IPv4 or IPv6 literal; returns the sockaddr length, 0 if invalid.
+    socklen_t makeAddress(const std::string &address, uint16_t port, sockaddr_storage &storage)
+    {
+        std::memset(&storage, 0, sizeof(storage));
+        auto *v4 = reinterpret_cast<sockaddr_in *>(&storage);
+        if (::inet_pton(AF_INET, address.c_str(), &v4->sin_addr) == 1)
+        {
+            v4->sin_family = AF_INET;
+            v4->sin_port = htons(port);
+            return sizeof(sockaddr_in);
+        }
+        auto *v6 = reinterpret_cast<sockaddr_in6 *>(&storage);
+        if (::inet_pton(AF_INET6, address.c_str(), &v6->sin6_addr) == 1)
+        {
+            v6->sin6_family = AF_INET6;
+            v6->sin6_port = htons(port);
+            return sizeof(sockaddr_in6);
+        }
+        return 0;
+    }
+
+    std::string peerName(const sockaddr_storage &storage)
+    {
+        char text[INET6_ADDRSTRLEN] = "?";
+        uint16_t port = 0;
+        if (storage.ss_family == AF_INET)
+        {
+            const auto &v4 = reinterpret_cast<const sockaddr_in &>(storage);
+            ::inet_ntop(AF_INET, &v4.sin_addr, text, sizeof(text));
+            port = ntohs(v4.sin_port);
+        }
+        else if (storage.ss_family == AF_INET6)
+        {
+            const auto &v6 = reinterpret_cast<const sockaddr_in6 &>(storage);
+            ::inet_ntop(AF_INET6, &v6.sin6_addr, text, sizeof(text));
+            port = ntohs(v6.sin6_port);
+            return "[" + std::string(text) + "]:" + std::to_string(port);
+        }
+        return std::string(text) + ":" + std::to_string(port);
+    }
+
+    int openSocket(const std::string &address, uint16_t port, int type)
+    {
+        sockaddr_storage storage;
+        const socklen_t length = makeAddress(address, port, storage);
+        if (length == 0)
+            throw std::system_error(EINVAL, std::generic_category(), "NMEAListener: invalid address " + address);
+
+        const int fd = ::socket(storage.ss_family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            throwErrno("NMEAListener: socket");
+        const int one = 1;
+        if (type == SOCK_STREAM)
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, reinterpret_cast<const sockaddr *>(&storage), length) < 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "NMEAListener: bind " + address);
+        }
+        return fd;
+    }
+
+    uint16_t boundPort(int fd)
+    {
+        sockaddr_storage storage;
+        socklen_t length = sizeof(storage);
+        if (::getsockname(fd, reinterpret_cast<sockaddr *>(&storage), &length) < 0)
+            return 0;
+        if (storage.ss_family == AF_INET6)
+            return ntohs(reinterpret_cast<const sockaddr_in6 &>(storage).sin6_port);
+        return ntohs(reinterpret_cast<const sockaddr_in &>(storage).sin_port);
+    }
+}
+
+namespace Ingest {
+
+    bool NMEAListener::PeerKey::operator==(const PeerKey &other) const
+    {
+        return port == other.port && family == other.family
+               && std::memcmp(address, other.address, sizeof(address)) == 0;
+    }
+
+    size_t NMEAListener::PeerKeyHash::operator()(const PeerKey &key) const
+    {
+        // FNV-1a over the address, then port and family
+        uint64_t hash = 1469598103934665603ULL;
+        for (uint8_t byte : key.address)
+            hash = (hash ^ byte) * 1099511628211ULL;
+        hash = (hash ^ key.port) * 1099511628211ULL;
+        hash = (hash ^ key.family) * 1099511628211ULL;
+        return static_cast<size_t>(hash);
+    }
+
+    NMEAListener::NMEAListener(EpochHandler onEpoch, const NMEAListenerConfig &config)
+        : m_config(config), m_onEpoch(std::move(onEpoch))
+    {
+        if (m_config.udpBatch == 0)
+            m_config.udpBatch = 1;
+        if (m_config.datagramSize == 0)
+            m_config.datagramSize = 2048;
+
+        m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll < 0)
+            throwErrno("NMEAListener: epoll_create1");
+        m_wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wakeup < 0)
+        {
+            const int error = errno;
+            ::close(m_epoll);
+            throw std::system_error(error, std::generic_category(), "NMEAListener: eventfd");
+        }
+        watch(m_wakeup, Kind::Wakeup);
+
+        // recvmmsg headers point once and for all into the batch buffers
+        const size_t batch = m_config.udpBatch;
+        m_datagramBuffer.resize(batch * m_config.datagramSize);
+        m_peerAddresses.resize(batch);
+        m_iovecs.resize(batch);
+        m_headers.resize(batch);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            m_iovecs[i].iov_base = m_datagramBuffer.data() + i * m_config.datagramSize;
+            m_iovecs[i].iov_len = m_config.datagramSize;
+            std::memset(&m_headers[i], 0, sizeof(mmsghdr));
+            m_headers[i].msg_hdr.msg_name = &m_peerAddresses[i];
+            m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+            m_headers[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    NMEAListener::~NMEAListener()
+    {
+        for (auto &entry : m_handles)
+            ::close(entry.second.fd);
+        ::close(m_epoll);
+    }
+
+    uint64_t NMEAListener::watch(int fd, Kind kind, std::unique_ptr<Connection> connection)
+    {
+        // Keys are never reused, so an event of a socket closed earlier in
+        // the same epoll_wait batch finds no handle instead of a new socket
+        const uint64_t key = m_nextKey++;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = key;
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "NMEAListener: epoll_ctl");
+        }
+        m_handles.emplace(key, Handle{kind, fd, std::move(connection)});
+        return key;
+    }
+
+    void NMEAListener::close(uint64_t key)
+    {
+        const auto it = m_handles.find(key);
+        if (it == m_handles.end())
+            return;
+        ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        ::close(it->second.fd);
+        if (it->second.connection)
+            it->second.connection->receiver->connected = false;
+        m_handles.erase(it);
+    }
+
+    uint16_t NMEAListener::listenUdp(const std::string &address, uint16_t port)
+    {
+        const int fd = openSocket(address, port, SOCK_DGRAM);
+        if (m_config.receiveBuffer > 0)
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &m_config.receiveBuffer, sizeof(m_config.receiveBuffer));
+        watch(fd, Kind::Udp);
+        return boundPort(fd);
+    }
+
+    uint16_t NMEAListener::listenTcp(const std::string &address, uint16_t port, int backlog)
+    {
+        const int fd = openSocket(address, port, SOCK_STREAM);
+        if (::listen(fd, backlog) < 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "NMEAListener: listen");
+        }
+        watch(fd, Kind::TcpListen);
+        return boundPort(fd);
+    }
+
+    NMEAListener::Receiver *NMEAListener::newReceiver(bool tcp, const sockaddr_storage &address)
+    {
+        if (m_receivers.size() >= std::max<size_t>(m_config.maxReceivers, 1))
+        {
+            // Connected TCP receivers are owned by their connection and stay
+            Receiver *oldest = nullptr;
+            for (const auto &entry : m_receivers)
+            {
+                Receiver *candidate = entry.second.get();
+                if (candidate->tcp && candidate->connected)
+                    continue;
+                if (!oldest || candidate->lastActiveNs < oldest->lastActiveNs)
+                    oldest = candidate;
+            }
+            if (!oldest)
+            {
+                ++m_refusedPeers;
+                return nullptr;
+            }
+            retire(*oldest);
+        }
+
+        auto receiver = std::make_unique<Receiver>(m_config.arenaSize);
+        receiver->id = m_nextReceiverId++;
+        receiver->tcp = tcp;
+        receiver->peer = peerName(address);
+        receiver->lastActiveNs = LatencyHistogram::clockNs();
+        Receiver *created = receiver.get();
+        m_receivers.emplace(created->id, std::move(receiver));
+        return created;
+    }
+
+    void NMEAListener::retire(Receiver &receiver)
+    {
+        if (!receiver.tcp)
+        {
+            for (auto it = m_udpPeers.begin(); it != m_udpPeers.end(); ++it)
+            {
+                if (it->second == &receiver)
+                {
+                    m_udpPeers.erase(it);
+                    break;
+                }
+            }
+        }
+        ++m_retiredReceivers;
+        m_retiredCounters += receiver.context.stats().snapshot();
+        m_receivers.erase(receiver.id);
+    }
+
+    ParseCounters NMEAListener::parseCounters() const
+    {
+        ParseCounters total = m_retiredCounters;
+        for (const auto &entry : m_receivers)
+            total += entry.second->context.stats().snapshot();
+        return total;
+    }
+
+    NMEAListener::EpochHandle NMEAListener::publish(const Receiver &receiver)
+    {
+        EpochHandle epoch = m_epochs.acquire();
+        *epoch = receiver.context.epoch();
+        return epoch;
+    }
+
+    size_t NMEAListener::retireIdle(int64_t idleMs)
+    {
+        const int64_t before = LatencyHistogram::clockNs() - idleMs * 1000000;
+        std::vector<Receiver *> idle;
+        for (const auto &entry : m_receivers)
+        {
+            Receiver &receiver = *entry.second;
+            if (receiver.tcp ? !receiver.connected : receiver.lastActiveNs <= before)
+                idle.push_back(&receiver);
+        }
+        for (Receiver *receiver : idle)
+            retire(*receiver);
+        return idle.size();
+    }
+
+    size_t NMEAListener::dispatch(Receiver &receiver, std::string_view line, int64_t arrivalNs)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            return 0;
+        ++receiver.sentences;
+        ++m_sentences;
+        if (receiver.epochStartNs < 0)
+            receiver.epochStartNs = arrivalNs;
+        if (receiver.context.parse(line))
+        {
+            receiver.latency.recordSpan(receiver.epochStartNs, LatencyHistogram::clockNs());
+            receiver.epochStartNs = -1;
+            if (m_onEpoch)
+                m_onEpoch(receiver);
+        }
+        return 1;
+    }
+
+    size_t NMEAListener::readUdp(int fd)
+    {
+        size_t parsed = 0;
+        for (int call = 0; call < kReadsPerEvent; ++call)
+        {
+            for (mmsghdr &header : m_headers)
+                header.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            const int count = ::recvmmsg(fd, m_headers.data(), m_config.udpBatch, MSG_DONTWAIT, nullptr);
+            ++m_receiveCalls;
+            if (count <= 0)
+            {
+                if (count < 0 && errno == EINTR)
+                    continue;
+                break;      // EAGAIN, or an ICMP error reported on the socket
+            }
+            const int64_t arrivalNs = LatencyHistogram::clockNs();
+
+            for (int i = 0; i < count; ++i)
+            {
+                const mmsghdr &header = m_headers[i];
+                const sockaddr_storage &address = m_peerAddresses[i];
+                PeerKey key{};
+                key.family = address.ss_family;
+                if (address.ss_family == AF_INET6)
+                {
+                    const auto &v6 = reinterpret_cast<const sockaddr_in6 &>(address);
+                    std::memcpy(key.address, &v6.sin6_addr, 16);
+                    key.port = v6.sin6_port;
+                }
+                else
+                {
+                    const auto &v4 = reinterpret_cast<const sockaddr_in &>(address);
+                    std::memcpy(key.address, &v4.sin_addr, 4);
+                    key.port = v4.sin_port;
+                }
+
+                ++m_datagrams;
+                const auto found = m_udpPeers.find(key);
+                Receiver *receiver = found != m_udpPeers.end() ? found->second : newReceiver(false, address);
+                if (!receiver)
+                    continue;
+                if (found == m_udpPeers.end())
+                    m_udpPeers.emplace(key, receiver);
+
+                const char *data = static_cast<const char *>(header.msg_hdr.msg_iov->iov_base);
+                const size_t length = header.msg_len;
+                receiver->bytes += length;
+                receiver->lastActiveNs = arrivalNs;
+
+                // Whole sentences per datagram; the last one may lack its newline
+                for (size_t start = 0; start < length;)
+                {
+                    const void *newline = std::memchr(data + start, '\n', length - start);
+                    const size_t end = newline ? static_cast<const char *>(newline) - data : length;
+                    parsed += dispatch(*receiver, std::string_view(data + start, end - start), arrivalNs);
+                    start = end + 1;
+                }
+            }
+            if (static_cast<unsigned>(count) < m_config.udpBatch)
+                break;
+        }
+        return parsed;
+    }
+
+    void NMEAListener::acceptTcp(int fd)
+    {
+        for (int i = 0; i < kReadsPerEvent; ++i)
+        {
+            sockaddr_storage address;
+            socklen_t length = sizeof(address);
+            const int client = ::accept4(fd, reinterpret_cast<sockaddr *>(&address), &length,
+                                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                return;     // EAGAIN, or out of descriptors until a connection closes
+            }
+            Receiver *receiver = newReceiver(true, address);
+            if (!receiver)
+            {
+                ::close(client);
+                continue;
+            }
+            auto connection = std::make_unique<Connection>(m_config.maxLineLength);
+            connection->fd = client;
+            connection->receiver = receiver;
+            watch(client, Kind::Tcp, std::move(connection));
+        }
+    }
+
+    size_t NMEAListener::readTcp(uint64_t key, Connection &connection)
+    {
+        size_t parsed = 0;
+        Receiver &receiver = *connection.receiver;
+        std::string_view line;
+        for (int i = 0; i < kReadsPerEvent; ++i)
+        {
+            const bool carried = connection.framer.buffered() > 0;
+            const ssize_t n = ::read(connection.fd, connection.framer.writeBuffer(m_config.tcpReadSize),
+                                     m_config.tcpReadSize);
+            ++m_receiveCalls;
+            if (n > 0)
+            {
+                connection.framer.commit(static_cast<size_t>(n));
+                receiver.bytes += static_cast<uint64_t>(n);
+
+                // A line begun in an earlier read dates from that read
+                const int64_t arrivalNs = LatencyHistogram::clockNs();
+                receiver.lastActiveNs = arrivalNs;
+                int64_t lineStartNs = carried ? connection.partialSinceNs : arrivalNs;
+                while (connection.framer.next(line))
+                {
+                    parsed += dispatch(receiver, line, lineStartNs);
+                    lineStartNs = arrivalNs;
+                }
+                connection.partialSinceNs = lineStartNs;
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+
+            // End of stream or reset
+            if (connection.framer.flush(line))
+                parsed += dispatch(receiver, line, connection.partialSinceNs);
+            close(key);
+            break;
+        }
+        return parsed;
+    }
+
+    size_t NMEAListener::poll(int timeoutMs)
+    {
+        epoll_event events[kMaxEvents];
+        const int n = ::epoll_wait(m_epoll, events, kMaxEvents, timeoutMs);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                return 0;
+            throwErrno("NMEAListener: epoll_wait");
+        }
+
+        size_t parsed = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            const uint64_t key = events[i].data.u64;
+            const auto it = m_handles.find(key);
+            if (it == m_handles.end())
+                continue;
+            Handle &handle = it->second;
+            switch (handle.kind)
+            {
+            case Kind::Wakeup:
+            {
+                uint64_t value;
+                while (::read(m_wakeup, &value, sizeof(value)) > 0)
+                {
+                }
+                m_stopped = true;
+                break;
+            }
+            case Kind::Udp:
+                parsed += readUdp(handle.fd);
+                break;
+            case Kind::TcpListen:
+                acceptTcp(handle.fd);
+                break;
+            case Kind::Tcp:
+                parsed += readTcp(key, *handle.connection);
+                break;
+            }
+        }
+        return parsed;
+    }
+
+    void NMEAListener::run()
+    {
+        while (!m_stopped)
+            poll(-1);
+        m_stopped = false;
+    }
+
+    void NMEAListener::stop()
+    {
+        const uint64_t one = 1;
+        [[maybe_unused]] const ssize_t n = ::write(m_wakeup, &one, sizeof(one));
+    }
+};
@@ -0,0 +1,297 @@
+#include "NMEALogIndex.hpp"
+#include "NMEAParser.hpp"
+#include "NMEAException.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sys/stat.h>
+
+namespace {
+
+    constexpr char kMagic[8] = {'G', 'N', 'S', 'S', 'I', 'D', 'X', '1'};
+    constexpr int64_t kDayMs = 86400000;
+    constexpr size_t kChunkSize = 1 << 20;
+
+    struct FileCloser {
+        void operator()(std::FILE *f) const { std::fclose(f); }
+    };
+    using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+    FilePtr openFile(const std::string &path, const char *mode)
+    {
+        FilePtr file(std::fopen(path.c_str(), mode));
+        if (!file)
+        {
+            throw ArchiveError("cannot open " + path);
+        }
+        return file;
+    }
+
+    uint64_t fileSize(const std::string &path)
+    {
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0)
+        {
+            throw ArchiveError("cannot stat " + path);
+        }
+        return st.st_size;
+    }
+
+    bool isGGA(const char *line, size_t length)
+    {
+        return length >= 6 && std::memcmp(line, "$GPGGA", 6) == 0;
+    }
+
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    /// UTC time of day of a GGA line in ms, -1 if absent or malformed.
+    int64_t ggaTimeOfDay(const char *line, size_t length)
+    {
+        // "$GPGGA,hhmmss[.sss],"
+        if (length < 13 || line[6] != ',')
+            return -1;
+        const char *t = line + 7;
+        for (int i = 0; i < 6; ++i)
+        {
+            if (!isDigit(t[i]))
+                return -1;
+        }
+        const int hour = (t[0] - '0') * 10 + (t[1] - '0');
+        const int minute = (t[2] - '0') * 10 + (t[3] - '0');
+        const int second = (t[4] - '0') * 10 + (t[5] - '0');
+        if (hour > 23 || minute > 59 || second > 60)
+            return -1;
+
+        int millis = 0;
+        size_t pos = 13;
+        if (pos < length && line[pos] == '.')
+        {
+            int scale = 100;
+            for (++pos; pos < length && isDigit(line[pos]); ++pos, scale /= 10)
+                millis += (line[pos] - '0') * scale;
+        }
+        return ((hour * 60 + minute) * 60 + second) * 1000LL + millis;
+    }
+
+    /// Maps GGA time of day onto the index time line.
+    class DayUnwrapper {
+    public:
+        explicit DayUnwrapper(int64_t startMs = -1) : m_last(startMs)
+        {
+            if (startMs >= 0)
+                m_dayBase = startMs - startMs % kDayMs;
+        }
+
+        int64_t operator()(int64_t timeOfDay)
+        {
+            // Only a step back of more than half a day is midnight; a repeated
+            // or out-of-order GGA stays on the same day
+            int64_t t = m_dayBase + timeOfDay;
+            if (m_last >= 0 && t + kDayMs / 2 < m_last)
+            {
+                m_dayBase += kDayMs;
+                t += kDayMs;
+            }
+            m_last = t;
+            return t;
+        }
+
+    private:
+        int64_t m_dayBase = 0;
+        int64_t m_last;
+    };
+
+    /**
+     * Calls @p onLine(line, length, offset) for each line of @p file from its
+     * current position. Stops early when onLine returns false.
+     */
+    template <typename OnLine>
+    void forEachLine(std::FILE *file, uint64_t startOffset, OnLine &&onLine)
+    {
+        std::vector<char> buffer(kChunkSize);
+        size_t kept = 0;
+        uint64_t bufferOffset = startOffset;
+
+        for (;;)
+        {
+            if (kept == buffer.size())
+                buffer.resize(buffer.size() * 2);   // line longer than a chunk
+            const size_t got = std::fread(buffer.data() + kept, 1, buffer.size() - kept, file);
+            const size_t size = kept + got;
+            const bool eof = got == 0;
+
+            size_t start = 0;
+            while (start < size)
+            {
+                const char *nl = static_cast<const char *>(std::memchr(buffer.data() + start, '\n', size - start));
+                if (!nl && !eof)
+                    break;
+                const size_t end = nl ? size_t(nl - buffer.data()) : size;
+                size_t length = end - start;
+                if (length > 0 && buffer[start + length - 1] == '\r')
+                    --length;
+                if (!onLine(buffer.data() + start, length, bufferOffset + start))
+                    return;
+                start = end + 1;
+            }
+            if (eof)
+                return;
+
+            kept = size - start;
+            std::memmove(buffer.data(), buffer.data() + start, kept);
+            bufferOffset += start;
+        }
+    }
+}
+
+NMEALogIndex NMEALogIndex::build(const std::string &logPath, int64_t intervalMs)
+{
+    if (intervalMs <= 0)
+    {
+        throw ArchiveError("index interval must be positive");
+    }
+
+    NMEALogIndex index;
+    index.m_intervalMs = intervalMs;
+    index.m_logSize = fileSize(logPath);
+
+    FilePtr file = openFile(logPath, "rb");
+    DayUnwrapper unwrap;
+    int64_t nextMs = INT64_MIN;
+    forEachLine(file.get(), 0, [&](const char *line, size_t length, uint64_t offset) {
+        if (!isGGA(line, length))
+            return true;
+        const int64_t timeOfDay = ggaTimeOfDay(line, length);
+        if (timeOfDay < 0)
+            return true;
+        const int64_t t = unwrap(timeOfDay);
+        if (t >= nextMs)
+        {
+            index.m_entries.push_back({t, offset});
+            nextMs = t + intervalMs;
+        }
+        return true;
+    });
+    return index;
+}
+
+NMEALogIndex NMEALogIndex::load(const std::string &indexPath)
+{
+    FilePtr file = openFile(indexPath, "rb");
+
+    char magic[sizeof(kMagic)];
+    uint64_t header[3];
+    if (std::fread(magic, 1, sizeof(magic), file.get()) != sizeof(magic)
+        || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0
+        || std::fread(header, sizeof(uint64_t), 3, file.get()) != 3)
+    {
+        throw ArchiveError("not an NMEA log index: " + indexPath);
+    }
+
+    NMEALogIndex index;
+    index.m_logSize = header[0];
+    index.m_intervalMs = static_cast<int64_t>(header[1]);
+    const uint64_t count = header[2];
+    if (count > (fileSize(indexPath) / sizeof(Entry)))
+    {
+        throw ArchiveError("truncated NMEA log index: " + indexPath);
+    }
+    index.m_entries.resize(count);
+    if (std::fread(index.m_entries.data(), sizeof(Entry), count, file.get()) != count)
+    {
+        throw ArchiveError("truncated NMEA log index: " + indexPath);
+    }
+    return index;
+}
+
+NMEALogIndex NMEALogIndex::openOrBuild(const std::string &logPath, int64_t intervalMs)
+{
+    const std::string sidecar = sidecarPath(logPath);
+    try {
+        NMEALogIndex index = load(sidecar);
+        if (index.m_logSize == fileSize(logPath) && index.m_intervalMs == intervalMs)
+            return index;
+    } catch (const ArchiveError &) {
+        // Missing or unreadable sidecar: rebuild it
+    }
+
+    NMEALogIndex index = build(logPath, intervalMs);
+    index.save(sidecar);
+    return index;
+}
+
+void NMEALogIndex::save(const std::string &indexPath) const
+{
+    FilePtr file = openFile(indexPath, "wb");
+    const uint64_t header[3] = {m_logSize, static_cast<uint64_t>(m_intervalMs), m_entries.size()};
+    if (std::fwrite(kMagic, 1, sizeof(kMagic), file.get()) != sizeof(kMagic)
+        || std::fwrite(header, sizeof(uint64_t), 3, file.get()) != 3
+        || std::fwrite(m_entries.data(), sizeof(Entry), m_entries.size(), file.get()) != m_entries.size()
+        || std::fflush(file.get()) != 0)
+    {
+        throw ArchiveError("write failed: " + indexPath);
+    }
+}
+
+const NMEALogIndex::Entry &NMEALogIndex::seek(int64_t timeMs) const
+{
+    if (m_entries.empty())
+    {
+        throw ArchiveError("seek on an empty NMEA log index");
+    }
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), timeMs,
+        [](int64_t t, const Entry &e) { return t < e.timeMs; });
+    return it == m_entries.begin() ? *it : *(it - 1);
+}
+
+namespace NMEAParser {
+
+    size_t parseWindow(const std::string &logPath, const NMEALogIndex &index,
+                       int64_t fromMs, int64_t toMs, GNSSData &data,
+                       const std::function<void(const GNSSData &, int64_t)> &onEpoch)
+    {
+        if (index.isEmpty() || fromMs >= toMs)
+            return 0;
+
+        const NMEALogIndex::Entry &start = index.seek(fromMs);
+        FilePtr file = openFile(logPath, "rb");
+        if (::fseeko(file.get(), static_cast<off_t>(start.offset), SEEK_SET) != 0)
+        {
+            throw ArchiveError("seek failed in " + logPath);
+        }
+
+        DayUnwrapper unwrap(start.timeMs);
+        bool inWindow = false;
+        size_t epochs = 0;
+        forEachLine(file.get(), start.offset, [&](const char *line, size_t length, uint64_t) {
+            int64_t epochMs = -1;
+            if (isGGA(line, length))
+            {
+                const int64_t timeOfDay = ggaTimeOfDay(line, length);
+                if (timeOfDay >= 0)
+                {
+                    epochMs = unwrap(timeOfDay);
+                    if (epochMs >= toMs)
+                        return false;
+                    inWindow = epochMs >= fromMs;
+                }
+            }
+            if (!inWindow)
+                return true;
+
+            try {
+                parseLine(QString::fromLatin1(line, static_cast<int>(length)), data);
+            } catch (const NMEAException &) {
+                return true;
+            }
+            if (epochMs >= 0)
+            {
+                onEpoch(data, epochMs);
+                ++epochs;
+            }
+            return true;
+        });
+        return epochs;
+    }
+};
@@ -1,96 +1,68 @@
 #include "NMEAParser.hpp"
 #include "NMEAException.hpp"
+#include "NMEASentences.hpp"
 #include <QtMath>
 #include <QDebug>
 #include <QTime>
+#include <string_view>
+#include <vector>
 
 static QMap<int, SATInfo> gsvTempSatellites;
 static int expectedGSVParts = 0;
 
+namespace {
+
+    /// Latin-1 copies of the tokens and views on them, the input of the NMEASentences schemas.
+    struct Fields {
+        explicit Fields(const QStringList &tokens)
+        {
+            bytes.reserve(tokens.size());
+            for (const QString &token : tokens)
+                bytes.push_back(token.toLatin1());
+            views.reserve(bytes.size());
+            for (const QByteArray &token : bytes)
+                views.emplace_back(token.constData(), static_cast<size_t>(token.size()));
+        }
+
+        const std::string_view *data() const { return views.data(); }
+        size_t size() const { return views.size(); }
+
+        std::vector<QByteArray> bytes;
+        std::vector<std::string_view> views;
+    };
+}
+
 
 namespace NMEAParser {
 
+    /**
+     * @brief Parse GGA (fix data) sentence, fields and checks of
+     * NMEASentences::kGGA.
+     *
+     * Example:
+     *   $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47
+     *
+     * The timestamp is the current date at the whole second of field 1;
+     * it is left unchanged when the time is impossible.
+     */
     void parseGGA(const QStringList &tokens, GNSSData &data)
     {
-        // Ex: $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47
-        // Fields:
-        //  0 = $GPGGA
-        //  1 = UTC Time (hhmmss.sss)
-        //  2 = Latitude (ddmm.mmmm)
-        //  3 = N/S
-        //  4 = Longitude (dddmm.mmmm)
-        //  5 = E/W
-        //  6 = Fix quality (0=Invalid, 1=GPS fix, 2=DGPS fix)
-        //  7 = Number of satellites
-        //  8 = HDOP
-        //  9 = Altitude (meters)
-        // 10 = 'M' (meters)
-        // 11 = Height of geoid (optionnel)
-        // 12 = 'M'
-        // 13 = (optional) time since last DGPS update
-        // 14 = (optional) DGPS station ID
         try {
-            // --- UTC ---
-            if (tokens.size() < 10)
-            {
-                throw ParsingError("GGA frame too short: expected >=10 fields");
-            }
+            const Fields fields(tokens);
+            NMEASentences::GGA gga;
+            NMEASchema::parse<NMEASentences::kGGA>(fields.data(), fields.size(), gga);
 
-            QString timeStr = tokens[1];
-            if (timeStr.size() < 6 )
+            if (gga.timeOfDayMs >= 0)
             {
-                throw InvalidDataError("Invalid UTC time in GGA frame");
-            }
-            int hour = timeStr.mid(0, 2).toInt();
-            int minute = timeStr.mid(2, 2).toInt();
-            int second = timeStr.mid(4, 2).toInt();
-            QTime time(hour, minute, second);
-            if (time.isValid()) {
+                const QTime time = QTime::fromMSecsSinceStartOfDay(static_cast<int>(gga.timeOfDayMs / 1000 * 1000));
                 data.timestamp = QDateTime(QDate::currentDate(), time, Qt::UTC);
             }
-            
-            // --- Latitude ---
-            data.latitude = convertToDecimalDegrees(tokens[2], tokens[3]);
-
-            // --- Longitude ---
-            data.longitude = convertToDecimalDegrees(tokens[4], tokens[5]);
-            if (data.longitude == -qInf())
-            {
-                throw InvalidDataError("Longitude conversion failed");
-            }
-
-            // --- Fix type ---
-            int fixQuality = tokens[6].toInt();
-            switch (fixQuality)
-            {
-                case 0: data.fixType = "No Fix"; break;
-                case 1: data.fixType = "GPS Fix"; break;
-                case 2: data.fixType = "DGPS Fix"; break;
-                case 4: data.fixType = "RTK Fix"; break;
-                default:
-                    throw InvalidDataError(QString("Unknown fix quality code: %1").arg(fixQuality));
-            }
-
-            // --- Nb of satellites ---
-            data.satellites = tokens[7].toInt();
-            if (data.satellites < 0 || data.satellites > 50)
-            {
-                throw InvalidDataError("Number of satellites out of range");
-            }
-            
-            // --- HDOP ---
-            data.hdop = tokens[8].toDouble();
-            if (data.hdop <= 0 || data.hdop > 50.0)
-            {
-                throw InvalidDataError("HDOP value out of range");
-            }
-            
-            // --- Altitude ---
-            data.altitude = tokens[9].toDouble();
-            if (data.altitude < -500 || data.altitude > 10000)
-            {
-                throw InvalidDataError("Altitude out of realistic bounds");
-            }
+            data.latitude = gga.latitude;
+            data.longitude = gga.longitude;
+            data.fixType = fixTypeLabel(gga.fixQuality);
+            data.satellites = gga.satellites;
+            data.hdop = gga.hdop;
+            data.altitude = gga.altitude;
         } catch (const NMEAException &e) {
             qWarning() << "[parseGGA] Exception:" << e.what();
             throw;
@@ -123,61 +95,49 @@ namespace NMEAParser {
     */
 
     /**
-     * @brief Parse GSV (Satellites in View) sentence.
+     * @brief Parse GSV (Satellites in View) sentence, fields and checks of
+     * NMEASentences::kGSV and kGSVSatellite.
      *
      * Example:
      *   $GPGSV,3,1,12,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A
      *
-     * Fields:
-     *   1 - Total number of GSV messages
-     *   2 - Message number (1..N)
-     *   3 - Total satellites in view
-     *   4+ - Repeated blocks of 4 values per satellite:
-     *        [PRN number, elevation (°), azimuth (°), SNR (dB-Hz)]
+     * The satellites of a sequence are published in data.satMap, with
+     * snrAvg, when its last part arrives.
      */
     void parseGSV(const QStringList &tokens, GNSSData &data)
     {
         try
         {
-            if (tokens.size() < 4)
-            {
-                throw ParsingError("GSV frame too short: expected >=4 fields");
-            }
-
-            int totalMsgs = tokens[1].toInt();
-            int msgNum = tokens[2].toInt();
-            int totalSats = tokens[3].toInt();
+            const Fields fields(tokens);
+            NMEASentences::GSV gsv;
+            NMEASchema::parse<NMEASentences::kGSV>(fields.data(), fields.size(), gsv);
 
             // Reset temporary storage when starting a new sequence
-            if (msgNum == 1)
+            if (gsv.messageNumber == 1)
             {
                 gsvTempSatellites.clear();
-                expectedGSVParts = totalMsgs;
+                expectedGSVParts = gsv.totalMessages;
             }
 
-            for (int i = 4; i+3 < tokens.size(); i+4){
-                if (i + 3 >= tokens.size())
-                // Ensure that all required tokens exist before reading
-                if (i + 3 >= tokens.size())
-                    break;
-
-                bool okId = false, okElev = false, okAzim = false, okSnr = false;
-
-                int id         = tokens[i].toInt(&okId);
-                double elev    = tokens[i + 1].toDouble(&okElev);
-                double azimuth = tokens[i + 2].toDouble(&okAzim);
-                double snr     = tokens[i + 3].toDouble(&okSnr);
-
-                if (!okId || id <= 0)
+            for (size_t i = NMEASentences::kGSVFirstBlock; i + NMEASentences::kGSVBlockSize <= fields.size();
+                 i += NMEASentences::kGSVBlockSize)
+            {
+                SatelliteRecord satellite;
+                if (!NMEASchema::parse<NMEASentences::kGSVSatellite>(fields.data() + i, NMEASentences::kGSVBlockSize,
+                                                                     satellite))
                 {
                     continue; // invalid satellite ID
                 }
+                gsvTempSatellites[satellite.id] = SATInfo{satellite.elevation, satellite.azimuth, satellite.snr};
+            }
 
-                SATInfo info;
-                info.elevation = okElev ? elev : -qInf();
-                info.azimuth   = okAzim ? azimuth : -qInf();
-                info.snr       = okSnr ? snr : -qInf();
-                gsvTempSatellites[id] = info;  
+            // Publish the satellite map once the whole sequence is in
+            if (gsv.messageNumber == expectedGSVParts)
+            {
+                data.satMap = gsvTempSatellites;
+                data.snrAvg = averageSnr(data.satMap);
+                gsvTempSatellites.clear();
+                expectedGSVParts = 0;
             }
             
         } catch (const NMEAException &e)
@@ -209,33 +169,12 @@ namespace NMEAParser {
     }*/
     double convertToDecimalDegrees(const QString &value, const QString &direction)
     {
-        
-        if (value.isEmpty() || direction.isEmpty()) {
-            throw InvalidDataError("InvalidData: Empty latitude/longitude or direction");
-        }
-
-        int degDigits = (direction == "N" || direction == "S") ? 2 : 3;
-
-        if (value.size() < degDigits) {
-            throw InvalidDataError("InvalidData: String too short for degrees");
-        }
-
-        bool okDeg = false;
-        bool okMin = false;
-
-        int degreePart = value.left(degDigits).toInt(&okDeg);
-        
-        double minutePart = value.mid(degDigits).toDouble(&okMin);
-        
-        if (!okDeg || !okMin) {
-            throw InvalidDataError("InvalidData: Conversion failed");
-        }
-
-        double decimalDegrees = degreePart + (minutePart / 60.0);
-        if (direction == "S" || direction == "W") {
-            decimalDegrees = -decimalDegrees;
-        }
-
+        const QByteArray valueBytes = value.toLatin1();
+        const QByteArray directionBytes = direction.toLatin1();
+        double decimalDegrees = 0.0;
+        NMEASchema::toDegrees(std::string_view(valueBytes.constData(), static_cast<size_t>(valueBytes.size())),
+                              std::string_view(directionBytes.constData(), static_cast<size_t>(directionBytes.size())),
+                              decimalDegrees);
         return decimalDegrees;
     }
 
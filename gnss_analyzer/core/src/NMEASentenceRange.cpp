@@ -0,0 +1,109 @@
+#include "NMEASentenceRange.hpp"
+#include <cstring>
+
+namespace {
+
+    constexpr size_t kMaxFields = 24;
+
+    size_t split(std::string_view line, std::string_view *fields)
+    {
+        size_t count = 0;
+        for (size_t start = 0; count < kMaxFields;)
+        {
+            const size_t comma = line.find(',', start);
+            fields[count++] = line.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start);
+            if (comma == std::string_view::npos)
+                break;
+            start = comma + 1;
+        }
+        return count;
+    }
+
+    NMEASentence parseGSA(const std::string_view *fields, size_t count)
+    {
+        NMEASentences::GSA gsa;
+        NMEASchema::parse<NMEASentences::kGSA>(fields, count, gsa);
+        for (size_t i = 0; i < NMEASentences::kGSAPrnFields; ++i)
+        {
+            int prn = 0;
+            if (NMEASchema::toInt(fields[NMEASentences::kGSAFirstPrn + i], {}, prn) && prn > 0)
+                gsa.prns[gsa.prnCount++] = prn;
+        }
+        return gsa;
+    }
+
+    NMEASentence parseGSV(const std::string_view *fields, size_t count)
+    {
+        GSVMessage message;
+        NMEASchema::parse<NMEASentences::kGSV>(fields, count, message.header);
+        for (size_t i = NMEASentences::kGSVFirstBlock;
+             i + NMEASentences::kGSVBlockSize <= count && message.count < message.satellites.size();
+             i += NMEASentences::kGSVBlockSize)
+        {
+            SatelliteRecord &satellite = message.satellites[message.count];
+            if (NMEASchema::parse<NMEASentences::kGSVSatellite>(fields + i, NMEASentences::kGSVBlockSize, satellite))
+                ++message.count;
+        }
+        return message;
+    }
+}
+
+NMEASentence parseSentence(std::string_view line)
+{
+    // "$ttSSS,": any two-letter talker
+    if (line.size() < 7 || line[0] != '$' || line[6] != ',')
+        return std::monostate();
+    const std::string_view type = line.substr(3, 3);
+    if (type != "GGA" && type != "GSV" && type != "GSA")
+        return std::monostate();
+
+    std::string_view fields[kMaxFields];
+    const size_t count = split(line, fields);
+    try
+    {
+        if (type == "GGA")
+        {
+            NMEASentences::GGA gga;
+            NMEASchema::parse<NMEASentences::kGGA>(fields, count, gga);
+            return gga;
+        }
+        if (type == "GSV")
+            return parseGSV(fields, count);
+        return parseGSA(fields, count);
+    }
+    catch (const NMEAException &e)
+    {
+        return NMEARejected{e.what()};
+    }
+}
+
+NMEASentenceRange::iterator::iterator(const char *begin, const char *end)
+    : m_begin(begin), m_next(begin), m_end(end), m_done(false)
+{
+    advance();
+}
+
+void NMEASentenceRange::iterator::advance()
+{
+    while (m_next < m_end)
+    {
+        const char *start = m_next;
+        const char *newline = static_cast<const char *>(std::memchr(start, '\n', m_end - start));
+        const char *stop = newline ? newline : m_end;
+        m_next = newline ? newline + 1 : m_end;
+        if (stop > start && stop[-1] == '\r')
+            --stop;
+        if (start == stop || *start != '$')
+            continue;
+
+        std::string_view line(start, stop - start);
+        NMEASentence sentence = parseSentence(line);
+        if (std::holds_alternative<std::monostate>(sentence))
+            continue;
+        m_item.line = line;
+        m_item.offset = static_cast<uint64_t>(start - m_begin);
+        m_item.sentence = std::move(sentence);
+        return;
+    }
+    m_done = true;
+}
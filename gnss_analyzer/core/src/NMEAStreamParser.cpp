@@ -0,0 +1,176 @@
+#include "NMEAStreamParser.hpp"
+#include "NMEASentences.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    constexpr size_t kMaxFields = 24;       // GSV: 4 header fields, 4 x 4 satellite fields, signal ID
+    constexpr int64_t kDayMs = 86400000;
+
+    int64_t dayStart(int64_t ms)
+    {
+        const int64_t day = ms / kDayMs - (ms % kDayMs < 0 ? 1 : 0);
+        return day * kDayMs;
+    }
+}
+
+NMEAStreamParser::NMEAStreamParser()
+{
+    setDate(std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()));
+}
+
+void NMEAStreamParser::setDate(EpochTime day)
+{
+    m_dayMs = dayStart(day.time_since_epoch().count());
+    m_lastTimeOfDayMs = -1;
+}
+
+void NMEAStreamParser::reset()
+{
+    m_pending.clear();
+    m_expectedParts = 0;
+}
+
+DATAType NMEAStreamParser::sentenceType(std::string_view line)
+{
+    if (line.substr(0, 6) == "$GPGGA")
+        return DATAType::GGA;
+    if (line.substr(0, 6) == "$GPGSV")
+        return DATAType::GSV;
+    return DATAType::Unknown;
+}
+
+bool NMEAStreamParser::checksumMismatch(std::string_view line)
+{
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+        line.remove_suffix(1);
+    if (line.size() < 4 || line[line.size() - 3] != '*')
+        return false;
+
+    const auto hexDigit = [](char c) {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        return -1;
+    };
+    const int high = hexDigit(line[line.size() - 2]);
+    const int low = hexDigit(line[line.size() - 1]);
+    if (high < 0 || low < 0)
+        return true;
+
+    // XOR of everything between '$' and '*', eight bytes at a time
+    const char *data = line.data() + (line.front() == '$' ? 1 : 0);
+    const char *end = line.data() + line.size() - 3;
+    uint64_t words = 0;
+    for (; end - data >= 8; data += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        words ^= word;
+    }
+    unsigned char sum = 0;
+    for (int shift = 0; shift < 64; shift += 8)
+        sum ^= static_cast<unsigned char>(words >> shift);
+    for (; data < end; ++data)
+        sum ^= static_cast<unsigned char>(*data);
+    return sum != (high << 4 | low);
+}
+
+NMEAStreamParser::Update NMEAStreamParser::parse(std::string_view line, EpochRecord &record)
+{
+    const DATAType type = sentenceType(line);
+    if (type == DATAType::Unknown)
+        return Update::None;
+
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+        line.remove_suffix(1);
+
+    std::string_view fields[kMaxFields];
+    size_t count = 0;
+    for (size_t start = 0; count < kMaxFields;)
+    {
+        const size_t comma = line.find(',', start);
+        fields[count++] = line.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start);
+        if (comma == std::string_view::npos)
+            break;
+        start = comma + 1;
+    }
+
+    if (type == DATAType::GGA)
+    {
+        parseGGA(fields, count, record);
+        return Update::Fix;
+    }
+    return parseGSV(fields, count, record) ? Update::Satellites : Update::None;
+}
+
+void NMEAStreamParser::parseGGA(const std::string_view *fields, size_t count, EpochRecord &record)
+{
+    NMEASentences::GGA gga;
+    NMEASchema::parse<NMEASentences::kGGA>(fields, count, gga);
+
+    if (gga.timeOfDayMs >= 0)
+    {
+        if (m_lastTimeOfDayMs >= 0 && gga.timeOfDayMs + kDayMs / 2 < m_lastTimeOfDayMs)
+            m_dayMs += kDayMs;
+        m_lastTimeOfDayMs = gga.timeOfDayMs;
+        record.time = EpochTime(std::chrono::milliseconds(m_dayMs + gga.timeOfDayMs));
+        record.hasTime = true;
+    }
+    record.latitude = gga.latitude;
+    record.longitude = gga.longitude;
+    record.fixQuality = gga.fixQuality;
+    record.satellites = gga.satellites;
+    record.hdop = gga.hdop;
+    record.altitude = gga.altitude;
+}
+
+bool NMEAStreamParser::parseGSV(const std::string_view *fields, size_t count, EpochRecord &record)
+{
+    NMEASentences::GSV gsv;
+    NMEASchema::parse<NMEASentences::kGSV>(fields, count, gsv);
+
+    // Reset temporary storage when starting a new sequence
+    if (gsv.messageNumber == 1)
+    {
+        if (m_expectedParts != 0)
+            ++m_sequenceResets;
+        m_pending.clear();
+        m_expectedParts = gsv.totalMessages;
+    }
+
+    for (size_t i = NMEASentences::kGSVFirstBlock; i + NMEASentences::kGSVBlockSize <= count;
+         i += NMEASentences::kGSVBlockSize)
+    {
+        SatelliteRecord satellite;
+        if (!NMEASchema::parse<NMEASentences::kGSVSatellite>(fields + i, NMEASentences::kGSVBlockSize, satellite))
+            continue;       // invalid satellite ID
+
+        const auto it = std::lower_bound(m_pending.begin(), m_pending.end(), satellite.id,
+                                         [](const SatelliteRecord &s, int32_t key) { return s.id < key; });
+        if (it != m_pending.end() && it->id == satellite.id)
+            *it = satellite;
+        else
+            m_pending.insert(it, satellite);
+    }
+
+    // Publish the satellites once the whole sequence is in
+    if (gsv.messageNumber != m_expectedParts)
+        return false;
+    record.satellitesInView.assign(m_pending.begin(), m_pending.end());
+    record.snrAvg = averageSnr(record.satellitesInView);
+    m_pending.clear();
+    m_expectedParts = 0;
+    return true;
+}
+
+double NMEAStreamParser::toDecimalDegrees(std::string_view value, std::string_view direction)
+{
+    double degrees = 0.0;
+    NMEASchema::toDegrees(value, direction, degrees);
+    return degrees;
+}
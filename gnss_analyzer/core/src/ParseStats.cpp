@@ -0,0 +1,79 @@
+#include "ParseStats.hpp"
+
+#ifdef GNSS_PARSE_STATS
+
+namespace {
+
+    std::atomic<uint64_t> g_nextId{1};
+
+    // Last shard used by this thread; one context per thread is the common case
+    struct ShardCache {
+        uint64_t owner = 0;
+        ParseStats::Shard *shard = nullptr;
+    };
+    thread_local ShardCache t_cache;
+}
+
+ParseStats::ParseStats()
+    : m_id(g_nextId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+ParseStats::~ParseStats()
+{
+    Shard *shard = m_shards.load(std::memory_order_acquire);
+    while (shard)
+    {
+        Shard *next = shard->next;
+        delete shard;
+        shard = next;
+    }
+}
+
+ParseStats::Shard &ParseStats::local()
+{
+    if (t_cache.owner == m_id)
+        return *t_cache.shard;
+    return addShard();
+}
+
+ParseStats::Shard &ParseStats::addShard()
+{
+    // A thread switching between contexts finds its shard again
+    const std::thread::id self = std::this_thread::get_id();
+    Shard *shard = m_shards.load(std::memory_order_acquire);
+    while (shard && shard->thread != self)
+        shard = shard->next;
+
+    if (!shard)
+    {
+        shard = new Shard;
+        shard->thread = self;
+        shard->next = m_shards.load(std::memory_order_relaxed);
+        while (!m_shards.compare_exchange_weak(shard->next, shard, std::memory_order_release,
+                                               std::memory_order_relaxed))
+            ;
+    }
+    t_cache.owner = m_id;
+    t_cache.shard = shard;
+    return *shard;
+}
+
+ParseCounters ParseStats::snapshot() const
+{
+    ParseCounters total;
+    for (const Shard *shard = m_shards.load(std::memory_order_acquire); shard; shard = shard->next)
+        for (size_t i = 0; i < total.values.size(); ++i)
+            total.values[i] += shard->values[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t ParseStats::shards() const
+{
+    size_t count = 0;
+    for (const Shard *shard = m_shards.load(std::memory_order_acquire); shard; shard = shard->next)
+        ++count;
+    return count;
+}
+
+#endif
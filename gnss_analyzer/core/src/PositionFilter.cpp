@@ -0,0 +1,110 @@
+#include "PositionFilter.hpp"
+#include <cmath>
+
+PositionFilter::PositionFilter(const PositionFilterConfig &config)
+    : m_config(config)
+{
+    m_h(0, 0) = 1.0;
+}
+
+double PositionFilter::uere(uint8_t fixQuality) const
+{
+    switch (fixQuality)
+    {
+        case 1: return m_config.uereAutonomous;
+        case 2: return m_config.uereDGPS;
+        case 4: return m_config.uereRTK;
+        default: return 0.0;
+    }
+}
+
+bool PositionFilter::update(const GNSSData &data, TrackPoint &out)
+{
+    const int64_t timeMs = data.timestamp.isValid() ? data.timestamp.toMSecsSinceEpoch() : 0;
+    return update(timeMs, data.latitude, data.longitude, data.altitude,
+                  data.hdop, data.vdop, fixQualityCode(data.fixType), out);
+}
+
+bool PositionFilter::update(int64_t timeMs, double latitude, double longitude, double altitude,
+                            double hdop, double vdop, uint8_t fixQuality, TrackPoint &out)
+{
+    const double range = uere(fixQuality);
+    if (range <= 0.0 || !(hdop > 0.0))
+        return false;
+
+    const double sigmaH = hdop * range;
+    const double sigmaV = (vdop > 0.0 ? vdop : m_config.vdopFactor * hdop) * range;
+    const double variance[3] = {sigmaH * sigmaH, sigmaH * sigmaH, sigmaV * sigmaV};
+
+    const int64_t dtMs = timeMs - m_lastTimeMs;
+    if (!m_initialized || dtMs < 0 || dtMs > m_config.maxGapMs)
+    {
+        m_frame = Geodesy::makeENUFrame(latitude, longitude, altitude);
+        start(variance);
+        m_lastTimeMs = timeMs;
+        output(timeMs, out);
+        return true;
+    }
+
+    double enu[3];
+    Geodesy::llaToEnu(m_frame, &latitude, &longitude, &altitude, 1, &enu[0], &enu[1], &enu[2]);
+
+    AxisFilter::Covariance f = AxisFilter::Covariance::identity();
+    AxisFilter::Covariance q;
+    if (dtMs > 0)
+    {
+        const double dt = dtMs * 1e-3;
+        const double a2 = m_config.accelerationNoise * m_config.accelerationNoise;
+        f(0, 1) = dt;
+        q(0, 0) = 0.25 * dt * dt * dt * dt * a2;
+        q(0, 1) = q(1, 0) = 0.5 * dt * dt * dt * a2;
+        q(1, 1) = dt * dt * a2;
+    }
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (dtMs > 0)
+            m_axis[axis].predict(f, q);
+        AxisFilter::Measurement z;
+        AxisFilter::MeasurementNoise r;
+        z[0] = enu[axis];
+        r(0, 0) = variance[axis];
+        if (!m_axis[axis].update(z, m_h, r))
+        {
+            // Only reachable with a corrupted covariance: start over at this fix
+            m_frame = Geodesy::makeENUFrame(latitude, longitude, altitude);
+            start(variance);
+            break;
+        }
+    }
+    m_lastTimeMs = timeMs;
+    output(timeMs, out);
+    return true;
+}
+
+void PositionFilter::start(const double variance[3])
+{
+    // The frame is anchored at the fix: position 0, velocity unknown
+    AxisFilter::Covariance p;
+    p(1, 1) = m_config.initialVelocitySigma * m_config.initialVelocitySigma;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        p(0, 0) = variance[axis];
+        m_axis[axis].init(AxisFilter::State(), p);
+    }
+    m_initialized = true;
+}
+
+void PositionFilter::output(int64_t timeMs, TrackPoint &out) const
+{
+    const double e = m_axis[0].state()[0];
+    const double n = m_axis[1].state()[0];
+    const double u = m_axis[2].state()[0];
+    out.timeMs = timeMs;
+    Geodesy::enuToLla(m_frame, &e, &n, &u, 1, &out.latitude, &out.longitude, &out.altitude);
+    out.velocityEast = m_axis[0].state()[1];
+    out.velocityNorth = m_axis[1].state()[1];
+    out.velocityUp = m_axis[2].state()[1];
+    out.sigmaHorizontal = std::sqrt(m_axis[0].covariance()(0, 0) + m_axis[1].covariance()(0, 0));
+    out.sigmaVertical = std::sqrt(m_axis[2].covariance()(0, 0));
+}
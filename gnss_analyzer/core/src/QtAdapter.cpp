@@ -0,0 +1,99 @@
+#include "QtAdapter.hpp"
+
+namespace QtAdapter {
+
+    void toGNSSData(const EpochRecord &record, GNSSData &data)
+    {
+        data.timestamp = record.hasTime
+                       ? QDateTime::fromMSecsSinceEpoch(record.time.time_since_epoch().count(), Qt::UTC)
+                       : QDateTime();
+        data.latitude = record.latitude;
+        data.longitude = record.longitude;
+        data.altitude = record.altitude;
+        data.hdop = record.hdop;
+        data.vdop = record.vdop;
+        data.snrAvg = record.snrAvg;
+        data.satellites = record.satellites;
+        data.fixType = fixTypeLabel(record.fixQuality);
+        data.satMap = toSatMap(record.satellitesInView);
+    }
+
+    void toEpochRecord(const GNSSData &data, EpochRecord &record)
+    {
+        record.hasTime = data.timestamp.isValid();
+        record.time = EpochTime(std::chrono::milliseconds(record.hasTime ? data.timestamp.toMSecsSinceEpoch() : 0));
+        record.latitude = data.latitude;
+        record.longitude = data.longitude;
+        record.altitude = data.altitude;
+        record.hdop = data.hdop;
+        record.vdop = data.vdop;
+        record.snrAvg = data.snrAvg;
+        record.satellites = data.satellites;
+        record.fixQuality = fixQualityCode(data.fixType);
+
+        record.satellitesInView.clear();
+        record.satellitesInView.reserve(data.satMap.size());
+        for (auto it = data.satMap.constBegin(); it != data.satMap.constEnd(); ++it)
+        {
+            record.satellitesInView.push_back(
+                SatelliteRecord{it.key(), it.value().elevation, it.value().azimuth, it.value().snr});
+        }
+    }
+
+    QMap<int, SATInfo> toSatMap(const SatelliteList &satellites)
+    {
+        QMap<int, SATInfo> satMap;
+        for (const SatelliteRecord &satellite : satellites)
+            satMap.insert(satellite.id, SATInfo{satellite.elevation, satellite.azimuth, satellite.snr});
+        return satMap;
+    }
+
+    void append(EpochColumns &columns, const GNSSData &data)
+    {
+        columns.timeMs.push_back(data.timestamp.isValid() ? data.timestamp.toMSecsSinceEpoch() : 0);
+        columns.latitude.push_back(data.latitude);
+        columns.longitude.push_back(data.longitude);
+        columns.altitude.push_back(data.altitude);
+        columns.hdop.push_back(data.hdop);
+        columns.vdop.push_back(data.vdop);
+        columns.snrAvg.push_back(data.snrAvg);
+        columns.satellites.push_back(data.satellites);
+        columns.fixQuality.push_back(fixQualityCode(data.fixType));
+
+        for (auto it = data.satMap.constBegin(); it != data.satMap.constEnd(); ++it)
+        {
+            columns.satId.push_back(it.key());
+            columns.elevation.push_back(static_cast<float>(it.value().elevation));
+            columns.azimuth.push_back(static_cast<float>(it.value().azimuth));
+            columns.snr.push_back(static_cast<float>(it.value().snr));
+        }
+        columns.satOffset.push_back(columns.satId.size());
+    }
+
+    void toGNSSData(const EpochColumns &columns, size_t i, GNSSData &data)
+    {
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(columns.timeMs[i], Qt::UTC);
+        data.latitude = columns.latitude[i];
+        data.longitude = columns.longitude[i];
+        data.altitude = columns.altitude[i];
+        data.hdop = columns.hdop[i];
+        data.vdop = columns.vdop[i];
+        data.snrAvg = columns.snrAvg[i];
+        data.satellites = columns.satellites[i];
+        data.fixType = fixTypeLabel(columns.fixQuality[i]);
+
+        data.satMap.clear();
+        for (size_t s = columns.satOffset[i]; s < columns.satOffset[i + 1]; ++s)
+            data.satMap.insert(columns.satId[s], SATInfo{columns.elevation[s], columns.azimuth[s], columns.snr[s]});
+    }
+
+    ParsingError parsingError(const QString &message)
+    {
+        return ParsingError(message.toStdString());
+    }
+
+    InvalidDataError invalidData(const QString &message)
+    {
+        return InvalidDataError(message.toStdString());
+    }
+};
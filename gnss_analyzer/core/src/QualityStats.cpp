@@ -0,0 +1,52 @@
+#include "QualityStats.hpp"
+
+void QualityStats::addFix(const GNSSData &data)
+{
+    ++m_epochs;
+    ++m_fixCounts[fixQualityCode(data.fixType)];
+    m_satellites.add(data.satellites);
+    if (data.hdop > 0.0)
+    {
+        m_hdop.add(data.hdop);
+        m_hdopP95.add(data.hdop);
+    }
+}
+
+void QualityStats::addSatellites(const QMap<int, SATInfo> &satMap)
+{
+    int tracked = 0;
+    double sum = 0.0;
+    for (auto it = satMap.constBegin(); it != satMap.constEnd(); ++it)
+    {
+        const double snr = it.value().snr;
+        if (!(snr > 0.0))
+            continue;
+        m_perSatellite[it.key()].add(snr);
+        m_perSystem[static_cast<size_t>(SatelliteId::systemOf(it.key()))].add(snr);
+        sum += snr;
+        ++tracked;
+    }
+    if (tracked > 0)
+        m_snrAvg.add(sum / tracked);
+}
+
+void QualityStats::reset()
+{
+    *this = QualityStats();
+}
+
+uint64_t QualityStats::fixCount(uint8_t fixQuality) const
+{
+    return fixQuality < kFixCodes ? m_fixCounts[fixQuality] : 0;
+}
+
+double QualityStats::fixRatio(uint8_t fixQuality) const
+{
+    return m_epochs > 0 ? static_cast<double>(fixCount(fixQuality)) / static_cast<double>(m_epochs) : 0.0;
+}
+
+const SNRStats *QualityStats::satellite(int id) const
+{
+    const auto it = m_perSatellite.find(id);
+    return it != m_perSatellite.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,380 @@
+#include "RTCM3Decoder.hpp"
+#include "NMEAException.hpp"
+#include <QtMath>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+    constexpr uint8_t kPreamble = 0xD3;
+    constexpr size_t kHeaderSize = 3;
+    constexpr size_t kCrcSize = 3;
+    constexpr size_t kMaxPayload = 1023;
+
+    // Speed of light in meters per millisecond: MSM ranges are in light-ms.
+    constexpr double kRangeMs = 299792.458;
+    constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+    // Register holds the 24-bit CRC in its upper bits, so the tables are
+    // those of a non-reflected CRC-32 with polynomial 0x1864CFB << 8.
+    using CrcTables = std::array<std::array<uint32_t, 256>, 4>;
+
+    constexpr CrcTables makeCrcTables()
+    {
+        CrcTables t{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t c = i << 24;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 0x80000000u) ? (c << 1) ^ 0x864CFB00u : (c << 1);
+            t[0][i] = c;
+        }
+        for (int s = 1; s < 4; ++s)
+            for (uint32_t i = 0; i < 256; ++i)
+                t[s][i] = (t[s - 1][i] << 8) ^ t[0][t[s - 1][i] >> 24];
+        return t;
+    }
+
+    constexpr CrcTables kCrcTables = makeCrcTables();
+
+    inline int popcount64(uint64_t v)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(v);
+#else
+        int n = 0;
+        for (; v; v &= v - 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    inline int leadingZeros64(uint64_t v)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(v);
+#else
+        int n = 0;
+        for (uint64_t bit = 1ull << 63; !(v & bit); bit >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    GNSSSystem systemForMessage(uint16_t type)
+    {
+        switch (type / 10)
+        {
+            case 107: return GNSSSystem::GPS;
+            case 108: return GNSSSystem::GLONASS;
+            case 109: return GNSSSystem::Galileo;
+            case 110: return GNSSSystem::SBAS;
+            case 111: return GNSSSystem::QZSS;
+            case 112: return GNSSSystem::BeiDou;
+            case 113: return GNSSSystem::NavIC;
+            default:  return GNSSSystem::Unknown;
+        }
+    }
+
+    /// Reads a field of up to 64 bits, for the satellite and cell masks.
+    inline uint64_t getWide(RTCM3::BitReader &reader, unsigned n)
+    {
+        if (n <= 32)
+            return reader.getBits(n);
+        const uint64_t hi = reader.getBits(n - 32);
+        return (hi << 32) | reader.getBits(32);
+    }
+}
+
+namespace RTCM3 {
+
+    uint32_t crc24q(const uint8_t *data, size_t length, uint32_t crc)
+    {
+        uint32_t c = (crc & 0xFFFFFFu) << 8;
+        while (length >= 4)
+        {
+            c ^= (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16)
+               | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+            c = kCrcTables[3][c >> 24] ^ kCrcTables[2][(c >> 16) & 0xFF]
+              ^ kCrcTables[1][(c >> 8) & 0xFF] ^ kCrcTables[0][c & 0xFF];
+            data += 4;
+            length -= 4;
+        }
+        while (length--)
+            c = (c << 8) ^ kCrcTables[0][(c >> 24) ^ *data++];
+        return c >> 8;
+    }
+
+    void Framer::feed(const uint8_t *data, size_t length)
+    {
+        // Drop consumed bytes before growing, so the buffer stays bounded
+        // by one frame plus one feed.
+        if (m_head > 0)
+        {
+            m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_head);
+            m_head = 0;
+        }
+        m_buffer.insert(m_buffer.end(), data, data + length);
+    }
+
+    bool Framer::next(Frame &frame)
+    {
+        const uint8_t *base = m_buffer.data();
+        const size_t size = m_buffer.size();
+
+        while (m_head < size)
+        {
+            const void *sync = std::memchr(base + m_head, kPreamble, size - m_head);
+            if (!sync)
+            {
+                m_skippedBytes += size - m_head;
+                m_head = size;
+                return false;
+            }
+            const size_t start = static_cast<const uint8_t *>(sync) - base;
+            m_skippedBytes += start - m_head;
+            m_head = start;
+
+            if (size - start < kHeaderSize)
+                return false;
+
+            // 6 reserved bits must be zero, then a 10-bit payload length
+            if (base[start + 1] & 0xFC)
+            {
+                ++m_head;
+                ++m_skippedBytes;
+                continue;
+            }
+            const size_t length = (size_t(base[start + 1] & 0x03) << 8) | base[start + 2];
+            const size_t total = kHeaderSize + length + kCrcSize;
+            if (size - start < total)
+                return false;
+
+            const uint8_t *crcBytes = base + start + kHeaderSize + length;
+            const uint32_t expected = (uint32_t(crcBytes[0]) << 16) | (uint32_t(crcBytes[1]) << 8) | crcBytes[2];
+            if (crc24q(base + start, kHeaderSize + length) != expected)
+            {
+                ++m_crcErrors;
+                ++m_head;
+                ++m_skippedBytes;
+                continue;
+            }
+
+            frame.payload = base + start + kHeaderSize;
+            frame.length = length;
+            frame.messageType = messageType(frame.payload, length);
+            m_head = start + total;
+            return true;
+        }
+        return false;
+    }
+
+    uint16_t messageType(const uint8_t *payload, size_t length)
+    {
+        if (length < 2)
+            return 0;
+        return static_cast<uint16_t>((payload[0] << 4) | (payload[1] >> 4));
+    }
+
+    bool isSupportedMSM(uint16_t type)
+    {
+        const int kind = type % 10;
+        return (kind == 4 || kind == 7) && systemForMessage(type) != GNSSSystem::Unknown;
+    }
+
+    bool decodeMSM(const uint8_t *payload, size_t length, MSMEpoch &epoch)
+    {
+        // Header up to and including the signal mask (DF002..DF396)
+        constexpr size_t kFixedHeaderBits = 169;
+
+        const uint16_t type = messageType(payload, length);
+        if (!isSupportedMSM(type))
+        {
+            return false;
+        }
+        if (length > kMaxPayload || length * 8 < kFixedHeaderBits)
+        {
+            throw ParsingError("RTCM3 MSM header truncated");
+        }
+
+        const bool msm7 = (type % 10) == 7;
+        const GNSSSystem system = systemForMessage(type);
+
+        BitReader reader(payload, length);
+        reader.skip(12);
+        epoch.messageType = type;
+        epoch.system = system;
+        epoch.stationId = static_cast<uint16_t>(reader.getBits(12));
+        if (system == GNSSSystem::GLONASS)
+        {
+            epoch.gloDayOfWeek = static_cast<uint8_t>(reader.getBits(3));
+            epoch.epochTimeMs = static_cast<uint32_t>(reader.getBits(27));
+        }
+        else
+        {
+            epoch.gloDayOfWeek = 0;
+            epoch.epochTimeMs = static_cast<uint32_t>(reader.getBits(30));
+        }
+        epoch.multipleMessage = reader.getBits(1) != 0;
+        epoch.iods = static_cast<uint8_t>(reader.getBits(3));
+        // reserved(7), clock steering(2), external clock(2), smoothing(1), interval(3)
+        reader.skip(15);
+
+        const uint64_t satMask = getWide(reader, 64);
+        const uint32_t sigMask = static_cast<uint32_t>(reader.getBits(32));
+        const int nSat = popcount64(satMask);
+        const int nSig = popcount64(sigMask);
+        const int nMaskCells = nSat * nSig;
+        if (nMaskCells > 64)
+        {
+            throw ParsingError("RTCM3 MSM cell mask exceeds 64 cells");
+        }
+
+        const size_t satBits = msm7 ? 36 : 18;
+        const size_t cellBits = msm7 ? 80 : 48;
+        if (length * 8 < kFixedHeaderBits + nMaskCells)
+        {
+            throw ParsingError("RTCM3 MSM cell mask truncated");
+        }
+        const uint64_t cellMask = nMaskCells > 0 ? getWide(reader, nMaskCells) : 0;
+        const int nCell = popcount64(cellMask);
+        if (length * 8 < kFixedHeaderBits + nMaskCells + nSat * satBits + nCell * cellBits)
+        {
+            throw ParsingError("RTCM3 MSM satellite/signal data truncated");
+        }
+
+        // Satellite data: each field is transmitted for all satellites in turn
+        uint8_t satNumber[64];
+        uint8_t roughInt[64];
+        uint16_t roughMod[64];
+        int16_t roughRate[64];
+        {
+            uint64_t mask = satMask;
+            for (int s = 0; s < nSat; ++s)
+            {
+                const int bit = leadingZeros64(mask);
+                satNumber[s] = static_cast<uint8_t>(bit + 1);
+                mask &= ~(1ull << (63 - bit));
+            }
+        }
+        for (int s = 0; s < nSat; ++s)
+            roughInt[s] = static_cast<uint8_t>(reader.getBits(8));
+        if (msm7)
+            reader.skip(4 * nSat); // extended satellite info
+        for (int s = 0; s < nSat; ++s)
+            roughMod[s] = static_cast<uint16_t>(reader.getBits(10));
+        if (msm7)
+        {
+            for (int s = 0; s < nSat; ++s)
+                roughRate[s] = static_cast<int16_t>(reader.getSignedBits(14));
+        }
+
+        // Signal data, same field-major layout over the active cells
+        int32_t finePr[64];
+        int32_t finePhase[64];
+        uint16_t lockTime[64];
+        uint8_t halfCycle[64];
+        uint16_t cnr[64];
+        int16_t fineRate[64];
+        const unsigned prBits = msm7 ? 20 : 15;
+        const unsigned phaseBits = msm7 ? 24 : 22;
+        const unsigned lockBits = msm7 ? 10 : 4;
+        const unsigned cnrBits = msm7 ? 10 : 6;
+        for (int c = 0; c < nCell; ++c)
+            finePr[c] = static_cast<int32_t>(reader.getSignedBits(prBits));
+        for (int c = 0; c < nCell; ++c)
+            finePhase[c] = static_cast<int32_t>(reader.getSignedBits(phaseBits));
+        for (int c = 0; c < nCell; ++c)
+            lockTime[c] = static_cast<uint16_t>(reader.getBits(lockBits));
+        for (int c = 0; c < nCell; ++c)
+            halfCycle[c] = static_cast<uint8_t>(reader.getBits(1));
+        for (int c = 0; c < nCell; ++c)
+            cnr[c] = static_cast<uint16_t>(reader.getBits(cnrBits));
+        if (msm7)
+        {
+            for (int c = 0; c < nCell; ++c)
+                fineRate[c] = static_cast<int16_t>(reader.getSignedBits(15));
+        }
+
+        // Invalid markers: the most negative value of each signed field
+        const int32_t prInvalid = -(1 << (prBits - 1));
+        const int32_t phaseInvalid = -(1 << (phaseBits - 1));
+        const double prScale = msm7 ? 0x1p-29 : 0x1p-24;
+        const double phaseScale = msm7 ? 0x1p-31 : 0x1p-29;
+        const double cnrScale = msm7 ? 0.0625 : 1.0;
+
+        uint8_t sigNumber[32];
+        {
+            uint32_t mask = sigMask;
+            for (int g = 0; g < nSig; ++g)
+            {
+                const int bit = leadingZeros64(uint64_t(mask) << 32);
+                sigNumber[g] = static_cast<uint8_t>(bit + 1);
+                mask &= ~(1u << (31 - bit));
+            }
+        }
+
+        epoch.observations.clear();
+        epoch.observations.reserve(nCell);
+        int cell = 0;
+        for (int s = 0; s < nSat; ++s)
+        {
+            const bool roughValid = roughInt[s] != 0xFF;
+            const double rough = roughInt[s] + roughMod[s] / 1024.0;
+            const bool rateValid = msm7 && roughRate[s] != -8192;
+
+            for (int g = 0; g < nSig; ++g)
+            {
+                const int maskBit = s * nSig + g;
+                if (!((cellMask >> (nMaskCells - 1 - maskBit)) & 1))
+                    continue;
+
+                MSMObservation obs;
+                obs.system = system;
+                obs.satellite = satNumber[s];
+                obs.satelliteId = SatelliteId::toNMEA(system, satNumber[s]);
+                obs.signal = sigNumber[g];
+                obs.pseudorange = (roughValid && finePr[cell] != prInvalid)
+                    ? (rough + finePr[cell] * prScale) * kRangeMs : kNaN;
+                obs.phaseRange = (roughValid && finePhase[cell] != phaseInvalid)
+                    ? (rough + finePhase[cell] * phaseScale) * kRangeMs : kNaN;
+                obs.phaseRangeRate = (rateValid && fineRate[cell] != -16384)
+                    ? roughRate[s] + fineRate[cell] * 0.0001 : kNaN;
+                obs.cnr = cnr[cell] * cnrScale;
+                obs.lockTimeIndicator = lockTime[cell];
+                obs.halfCycleAmbiguity = halfCycle[cell] != 0;
+                epoch.observations.push_back(obs);
+                ++cell;
+            }
+        }
+        return true;
+    }
+
+    void applyToSatMap(const MSMEpoch &epoch, QMap<int, SATInfo> &satMap)
+    {
+        int lastId = 0;
+        for (const MSMObservation &obs : epoch.observations)
+        {
+            // Observations are satellite-major: keep the first signal only
+            if (obs.satelliteId == 0 || obs.satelliteId == lastId)
+                continue;
+            lastId = obs.satelliteId;
+
+            auto it = satMap.find(obs.satelliteId);
+            if (it == satMap.end())
+            {
+                SATInfo info;
+                info.elevation = -qInf();
+                info.azimuth = -qInf();
+                info.snr = obs.cnr;
+                satMap.insert(obs.satelliteId, info);
+            }
+            else
+            {
+                it->snr = obs.cnr;
+            }
+        }
+    }
+};
@@ -0,0 +1,245 @@
+#include "ReceiverComparison.hpp"
+#include "EpochColumns.hpp"
+#include "Geodesy.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+    constexpr size_t kChunk = 1 << 16;      // matched rows per task of the columnar pass
+    constexpr size_t kBlock = 256;
+    constexpr double kDegToRad = M_PI / 180.0;
+    constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+    struct Task {
+        size_t pair;
+        size_t first;
+        size_t last;
+    };
+
+    /// Differences of matched rows [first, last) of one pair; fills its columns and a partial summary.
+    void compareRows(const EpochColumns &ref, const EpochColumns &other, ComparisonColumns &out,
+                     size_t first, size_t last, ComparisonSummary &partial)
+    {
+        double latA[kBlock], lonA[kBlock], altA[kBlock], latB[kBlock], lonB[kBlock], altB[kBlock];
+        double xA[kBlock], yA[kBlock], zA[kBlock], xB[kBlock], yB[kBlock], zB[kBlock];
+        double latRad[kBlock], lonRad[kBlock], sinLat[kBlock], cosLat[kBlock], sinLon[kBlock], cosLon[kBlock];
+        bool bothFix[kBlock];
+
+        for (size_t begin = first; begin < last; begin += kBlock)
+        {
+            const size_t m = std::min(kBlock, last - begin);
+            for (size_t k = 0; k < m; ++k)
+            {
+                const size_t a = out.referenceRow[begin + k];
+                const size_t b = out.otherRow[begin + k];
+                const uint8_t qa = ref.fixQuality[a];
+                const uint8_t qb = other.fixQuality[b];
+                bothFix[k] = qa > 0 && qb > 0;
+                out.fixAgree[begin + k] = qa == qb;
+                partial.fixAgreements += qa == qb;
+
+                // Rows without a fix may hold -inf; keep the kernels on finite input
+                latA[k] = bothFix[k] ? ref.latitude[a] : 0.0;
+                lonA[k] = bothFix[k] ? ref.longitude[a] : 0.0;
+                altA[k] = bothFix[k] ? ref.altitude[a] : 0.0;
+                latB[k] = bothFix[k] ? other.latitude[b] : 0.0;
+                lonB[k] = bothFix[k] ? other.longitude[b] : 0.0;
+                altB[k] = bothFix[k] ? other.altitude[b] : 0.0;
+                latRad[k] = latA[k] * kDegToRad;
+                lonRad[k] = lonA[k] * kDegToRad;
+            }
+
+            Geodesy::llaToEcef(latA, lonA, altA, m, xA, yA, zA);
+            Geodesy::llaToEcef(latB, lonB, altB, m, xB, yB, zB);
+            Geodesy::sinCos(latRad, m, sinLat, cosLat);
+            Geodesy::sinCos(lonRad, m, sinLon, cosLon);
+
+            for (size_t k = 0; k < m; ++k)
+            {
+                const size_t i = begin + k;
+                if (!bothFix[k])
+                {
+                    out.east[i] = out.north[i] = out.up[i] = kNaN;
+                    continue;
+                }
+                const double dx = xB[k] - xA[k];
+                const double dy = yB[k] - yA[k];
+                const double dz = zB[k] - zA[k];
+                const double e = -sinLon[k] * dx + cosLon[k] * dy;
+                const double n = -sinLat[k] * cosLon[k] * dx - sinLat[k] * sinLon[k] * dy + cosLat[k] * dz;
+                const double u = cosLat[k] * cosLon[k] * dx + cosLat[k] * sinLon[k] * dy + sinLat[k] * dz;
+                out.east[i] = e;
+                out.north[i] = n;
+                out.up[i] = u;
+                partial.east.add(e);
+                partial.north.add(n);
+                partial.up.add(u);
+                partial.horizontal.add(std::sqrt(e * e + n * n));
+            }
+        }
+
+        // Satellites of an epoch are sorted by ID: merge the two lists
+        for (size_t i = first; i < last; ++i)
+        {
+            const size_t a = out.referenceRow[i];
+            const size_t b = out.otherRow[i];
+            size_t sa = ref.satOffset[a];
+            const size_t ea = ref.satOffset[a + 1];
+            size_t sb = other.satOffset[b];
+            const size_t eb = other.satOffset[b + 1];
+            double sum = 0.0;
+            int common = 0;
+            while (sa < ea && sb < eb)
+            {
+                const int32_t ida = ref.satId[sa];
+                const int32_t idb = other.satId[sb];
+                if (ida < idb)
+                {
+                    ++sa;
+                    continue;
+                }
+                if (idb < ida)
+                {
+                    ++sb;
+                    continue;
+                }
+                const float snrA = ref.snr[sa++];
+                const float snrB = other.snr[sb++];
+                if (!(snrA > 0.0f && snrB > 0.0f))
+                    continue;
+                const double delta = static_cast<double>(snrB) - static_cast<double>(snrA);
+                sum += delta;
+                ++common;
+                partial.snrDelta.add(delta);
+                partial.satelliteSnrDelta[ida].add(delta);
+            }
+            out.commonSatellites[i] = static_cast<uint8_t>(std::min(common, 255));
+            out.snrDelta[i] = common ? static_cast<float>(sum / common) : std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+
+    void mergeSummary(ComparisonSummary &into, const ComparisonSummary &partial)
+    {
+        into.east.merge(partial.east);
+        into.north.merge(partial.north);
+        into.up.merge(partial.up);
+        into.horizontal.merge(partial.horizontal);
+        into.snrDelta.merge(partial.snrDelta);
+        into.fixAgreements += partial.fixAgreements;
+        for (const auto &satellite : partial.satelliteSnrDelta)
+            into.satelliteSnrDelta[satellite.first].merge(satellite.second);
+    }
+}
+
+namespace Comparison {
+
+    void mergeJoin(const EpochColumns &a, const EpochColumns &b, int64_t toleranceMs,
+                   std::vector<uint64_t> &rowsA, std::vector<uint64_t> &rowsB)
+    {
+        rowsA.clear();
+        rowsB.clear();
+        const std::vector<int64_t> &ta = a.timeMs;
+        const std::vector<int64_t> &tb = b.timeMs;
+        if (!std::is_sorted(ta.begin(), ta.end()) || !std::is_sorted(tb.begin(), tb.end()))
+        {
+            throw std::invalid_argument("Comparison: epoch columns must be sorted by time");
+        }
+
+        size_t i = 0, j = 0;
+        while (i < ta.size() && j < tb.size())
+        {
+            if (ta[i] < tb[j] - toleranceMs)
+            {
+                ++i;
+            }
+            else if (tb[j] < ta[i] - toleranceMs)
+            {
+                ++j;
+            }
+            else
+            {
+                rowsA.push_back(i++);
+                rowsB.push_back(j++);
+            }
+        }
+    }
+
+    std::vector<ReceiverComparison> compare(const std::vector<const EpochColumns *> &receivers, size_t reference,
+                                            int64_t toleranceMs, unsigned threads)
+    {
+        if (reference >= receivers.size())
+        {
+            throw std::invalid_argument("Comparison: reference index out of range");
+        }
+        // Checked here rather than in the workers, so that no task starts on bad input
+        for (const EpochColumns *receiver : receivers)
+        {
+            if (!receiver)
+                throw std::invalid_argument("Comparison: null receiver");
+            if (!std::is_sorted(receiver->timeMs.begin(), receiver->timeMs.end()))
+                throw std::invalid_argument("Comparison: epoch columns must be sorted by time");
+        }
+        const EpochColumns &ref = *receivers[reference];
+
+        std::vector<ReceiverComparison> result;
+        for (size_t r = 0; r < receivers.size(); ++r)
+        {
+            if (r == reference)
+                continue;
+            result.emplace_back();
+            result.back().receiver = r;
+        }
+
+        // Joins, one receiver per task
+        size_t epochs = 0;
+        for (const EpochColumns *receiver : receivers)
+            epochs += receiver->size();
+        Parallel::runTasks(result.size(), Parallel::workerCount(epochs, threads), [&](size_t p) {
+            ReceiverComparison &comparison = result[p];
+            const EpochColumns &other = *receivers[comparison.receiver];
+            ComparisonColumns &columns = comparison.columns;
+            mergeJoin(ref, other, toleranceMs, columns.referenceRow, columns.otherRow);
+
+            const size_t n = columns.referenceRow.size();
+            columns.timeMs.resize(n);
+            for (size_t i = 0; i < n; ++i)
+                columns.timeMs[i] = ref.timeMs[columns.referenceRow[i]];
+            columns.east.resize(n);
+            columns.north.resize(n);
+            columns.up.resize(n);
+            columns.snrDelta.resize(n);
+            columns.commonSatellites.resize(n);
+            columns.fixAgree.resize(n);
+
+            comparison.summary.referenceEpochs = ref.size();
+            comparison.summary.otherEpochs = other.size();
+            comparison.summary.matched = n;
+        });
+
+        // Columnar pass over fixed-size chunks of every pair
+        std::vector<Task> tasks;
+        size_t matched = 0;
+        for (size_t p = 0; p < result.size(); ++p)
+        {
+            const size_t n = result[p].columns.size();
+            for (size_t first = 0; first < n; first += kChunk)
+                tasks.push_back(Task{p, first, std::min(n, first + kChunk)});
+            matched += n;
+        }
+        std::vector<ComparisonSummary> partials(tasks.size());
+        Parallel::runTasks(tasks.size(), Parallel::workerCount(matched, threads), [&](size_t t) {
+            const Task &task = tasks[t];
+            ReceiverComparison &comparison = result[task.pair];
+            compareRows(ref, *receivers[comparison.receiver], comparison.columns,
+                        task.first, task.last, partials[t]);
+        });
+        for (size_t t = 0; t < tasks.size(); ++t)
+            mergeSummary(result[tasks[t].pair].summary, partials[t]);
+
+        return result;
+    }
+};
@@ -0,0 +1,132 @@
+#include "RunningStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+void RunningStats::merge(const RunningStats &other)
+{
+    if (other.m_count == 0)
+        return;
+    if (m_count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    // Chan et al. pairwise update
+    const double n1 = static_cast<double>(m_count);
+    const double n2 = static_cast<double>(other.m_count);
+    const double n = n1 + n2;
+    const double delta = other.m_mean - m_mean;
+    m_mean += delta * n2 / n;
+    m_m2 += other.m_m2 + delta * delta * n1 * n2 / n;
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+double RunningStats::stddev() const
+{
+    return std::sqrt(variance());
+}
+
+P2Quantile::P2Quantile(double quantile)
+    : m_quantile(std::min(std::max(quantile, 0.0), 1.0))
+{
+    const double p = m_quantile;
+    m_increment[0] = 0.0;
+    m_increment[1] = p / 2.0;
+    m_increment[2] = p;
+    m_increment[3] = (1.0 + p) / 2.0;
+    m_increment[4] = 1.0;
+}
+
+void P2Quantile::add(double x)
+{
+    if (m_count < 5)
+    {
+        // Warm-up: keep the first samples sorted in the marker heights
+        int i = static_cast<int>(m_count);
+        while (i > 0 && m_height[i - 1] > x)
+        {
+            m_height[i] = m_height[i - 1];
+            --i;
+        }
+        m_height[i] = x;
+        if (++m_count == 5)
+        {
+            for (int k = 0; k < 5; ++k)
+            {
+                m_position[k] = k;
+                m_desired[k] = 4.0 * m_increment[k];
+            }
+        }
+        return;
+    }
+    ++m_count;
+
+    int cell;
+    if (x < m_height[0])
+    {
+        m_height[0] = x;
+        cell = 0;
+    }
+    else if (x >= m_height[4])
+    {
+        m_height[4] = x;
+        cell = 3;
+    }
+    else
+    {
+        cell = 0;
+        while (cell < 3 && x >= m_height[cell + 1])
+            ++cell;
+    }
+
+    for (int k = cell + 1; k < 5; ++k)
+        m_position[k] += 1.0;
+    for (int k = 0; k < 5; ++k)
+        m_desired[k] += m_increment[k];
+
+    for (int i = 1; i < 4; ++i)
+    {
+        const double d = m_desired[i] - m_position[i];
+        if ((d >= 1.0 && m_position[i + 1] - m_position[i] > 1.0)
+            || (d <= -1.0 && m_position[i - 1] - m_position[i] < -1.0))
+        {
+            const int step = d > 0.0 ? 1 : -1;
+            const double candidate = parabolic(i, step);
+            if (m_height[i - 1] < candidate && candidate < m_height[i + 1])
+                m_height[i] = candidate;
+            else
+                m_height[i] = linear(i, step);
+            m_position[i] += step;
+        }
+    }
+}
+
+double P2Quantile::parabolic(int i, double d) const
+{
+    const double *q = m_height;
+    const double *n = m_position;
+    return q[i] + d / (n[i + 1] - n[i - 1])
+        * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+           + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const
+{
+    return m_height[i] + d * (m_height[i + d] - m_height[i]) / (m_position[i + d] - m_position[i]);
+}
+
+double P2Quantile::value() const
+{
+    if (m_count == 0)
+        return 0.0;
+    if (m_count < 5)
+    {
+        // Exact, nearest rank over the sorted warm-up samples
+        const double rank = m_quantile * static_cast<double>(m_count - 1);
+        return m_height[static_cast<int>(std::lround(rank))];
+    }
+    return m_height[2];
+}
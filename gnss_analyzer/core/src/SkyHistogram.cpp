@@ -0,0 +1,119 @@
+#include "SkyHistogram.hpp"
+#include "EpochColumns.hpp"
+#include "Parallel.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+SkyHistogram::SkyHistogram(double elevationStepDeg, double azimuthStepDeg)
+    : m_elevationStep(elevationStepDeg), m_azimuthStep(azimuthStepDeg)
+{
+    if (!(elevationStepDeg > 0.0 && elevationStepDeg <= 90.0 && azimuthStepDeg > 0.0 && azimuthStepDeg <= 360.0))
+    {
+        throw std::invalid_argument("SkyHistogram: bin sizes must be in (0, 90] and (0, 360] degrees");
+    }
+    m_elevationBins = static_cast<int>(std::ceil(90.0 / elevationStepDeg - 1e-9));
+    m_azimuthBins = static_cast<int>(std::ceil(360.0 / azimuthStepDeg - 1e-9));
+    m_elevationScale = 1.0 / elevationStepDeg;
+    m_azimuthScale = 1.0 / azimuthStepDeg;
+
+    const size_t bins = static_cast<size_t>(m_elevationBins) * m_azimuthBins;
+    m_count.assign(bins, 0);
+    m_tracked.assign(bins, 0);
+    m_snrSum.assign(bins, 0.0);
+}
+
+void SkyHistogram::add(const QMap<int, SATInfo> &satMap)
+{
+    for (auto it = satMap.constBegin(); it != satMap.constEnd(); ++it)
+        add(it.value().elevation, it.value().azimuth, it.value().snr);
+}
+
+void SkyHistogram::add(const EpochColumns &columns, size_t firstRow, size_t lastRow)
+{
+    const float *elevation = columns.elevation.data();
+    const float *azimuth = columns.azimuth.data();
+    const float *snr = columns.snr.data();
+    for (size_t s = firstRow; s < lastRow; ++s)
+        add(elevation[s], azimuth[s], snr[s]);
+}
+
+void SkyHistogram::merge(const SkyHistogram &other)
+{
+    if (other.m_elevationBins != m_elevationBins || other.m_azimuthBins != m_azimuthBins)
+    {
+        throw std::invalid_argument("SkyHistogram: cannot merge histograms with different binning");
+    }
+    for (size_t i = 0; i < m_count.size(); ++i)
+    {
+        m_count[i] += other.m_count[i];
+        m_tracked[i] += other.m_tracked[i];
+        m_snrSum[i] += other.m_snrSum[i];
+    }
+}
+
+void SkyHistogram::clear()
+{
+    std::fill(m_count.begin(), m_count.end(), 0);
+    std::fill(m_tracked.begin(), m_tracked.end(), 0);
+    std::fill(m_snrSum.begin(), m_snrSum.end(), 0.0);
+}
+
+SkyHistogram SkyHistogram::build(const EpochColumns &columns, double elevationStepDeg,
+                                 double azimuthStepDeg, unsigned threads)
+{
+    SkyHistogram result(elevationStepDeg, azimuthStepDeg);
+    const size_t rows = columns.satelliteCount();
+
+    const unsigned workers = Parallel::workerCount(rows, threads);
+    if (workers <= 1)
+    {
+        result.add(columns, 0, rows);
+        return result;
+    }
+
+    std::vector<SkyHistogram> partial(workers - 1, result);
+    Parallel::forEachChunk(rows, workers, [&](unsigned t, size_t first, size_t last) {
+        (t == 0 ? result : partial[t - 1]).add(columns, first, last);
+    });
+    for (const SkyHistogram &h : partial)
+        result.merge(h);
+    return result;
+}
+
+double SkyHistogram::meanSnr(int elevationBin, int azimuthBin) const
+{
+    const size_t i = flat(elevationBin, azimuthBin);
+    return m_tracked[i] > 0 ? m_snrSum[i] / static_cast<double>(m_tracked[i])
+                            : std::numeric_limits<double>::quiet_NaN();
+}
+
+uint64_t SkyHistogram::totalCount() const
+{
+    uint64_t total = 0;
+    for (uint64_t c : m_count)
+        total += c;
+    return total;
+}
+
+std::vector<double> SkyHistogram::obstructionMask(double minSnr, uint64_t minSamples, double minTrackedRatio) const
+{
+    std::vector<double> mask(m_azimuthBins, 0.0);
+    for (int a = 0; a < m_azimuthBins; ++a)
+    {
+        for (int e = m_elevationBins - 1; e >= 0; --e)
+        {
+            const size_t i = flat(e, a);
+            if (m_count[i] < minSamples)
+                continue;
+            const bool lost = static_cast<double>(m_tracked[i]) < minTrackedRatio * static_cast<double>(m_count[i]);
+            const bool weak = m_tracked[i] > 0 && m_snrSum[i] < minSnr * static_cast<double>(m_tracked[i]);
+            if (lost || weak)
+            {
+                mask[a] = std::min(90.0, (e + 1) * m_elevationStep);
+                break;
+            }
+        }
+    }
+    return mask;
+}
@@ -0,0 +1,346 @@
+#include "SpatialIndex.hpp"
+#include "EpochColumns.hpp"
+#include "GNSSDataModel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr double kEarthRadius = 6371008.8;     // m, mean radius
+    constexpr double kDegToRad = M_PI / 180.0;
+    constexpr double kRadToDeg = 180.0 / M_PI;
+    constexpr double kFirstNearestRadius = 250.0;  // m
+    constexpr int kMaxCellsPerAxis = 5;
+
+    uint64_t spreadBits(uint64_t x)
+    {
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+    }
+
+    uint64_t quantize(double value, double low, double span)
+    {
+        const double q = (value - low) / span * 4294967296.0;
+        if (!(q > 0.0))
+            return 0;
+        return q >= 4294967295.0 ? 4294967295ULL : static_cast<uint64_t>(q);
+    }
+
+    double greatCircle(double lat1, double lon1, double lat2, double lon2)
+    {
+        const double sinDLat = std::sin(0.5 * (lat2 - lat1) * kDegToRad);
+        const double sinDLon = std::sin(0.5 * (lon2 - lon1) * kDegToRad);
+        const double a = sinDLat * sinDLat
+                       + std::cos(lat1 * kDegToRad) * std::cos(lat2 * kDegToRad) * sinDLon * sinDLon;
+        return 2.0 * kEarthRadius * std::asin(std::min(1.0, std::sqrt(a)));
+    }
+
+    bool inBox(double lat, double lon, double minLat, double minLon, double maxLat, double maxLon)
+    {
+        return lat >= minLat && lat <= maxLat && lon >= minLon && lon <= maxLon;
+    }
+}
+
+SpatialIndex::SpatialIndex(Mode mode, size_t deltaLimit)
+    : m_mode(mode), m_deltaLimit(std::max<size_t>(deltaLimit, 1))
+{
+}
+
+uint64_t SpatialIndex::key(double latitude, double longitude)
+{
+    return spreadBits(quantize(longitude, -180.0, 360.0)) | (spreadBits(quantize(latitude, -90.0, 180.0)) << 1);
+}
+
+size_t SpatialIndex::size() const
+{
+    return m_keys.size() - m_deadCount + m_delta.size();
+}
+
+void SpatialIndex::clear()
+{
+    *this = SpatialIndex(m_mode, m_deltaLimit);
+}
+
+void SpatialIndex::insert(uint32_t id, double latitude, double longitude, int64_t timeMs)
+{
+    if (!std::isfinite(latitude) || !std::isfinite(longitude))
+        return;
+    if (m_mode == Mode::Latest)
+    {
+        const auto it = m_slots.find(id);
+        if (it != m_slots.end())
+        {
+            const uint64_t slot = it->second;
+            const int64_t storedMs = (slot & kInDelta) ? m_delta[slot & ~kInDelta].timeMs : m_times[slot];
+            if (timeMs < storedMs)
+                return;
+            eraseSlot(slot);
+        }
+    }
+    add(Entry{key(latitude, longitude), id, timeMs, latitude, longitude});
+    if (m_delta.size() >= m_deltaLimit)
+        flush();
+}
+
+void SpatialIndex::insert(uint32_t id, const GNSSData &data)
+{
+    if (fixQualityCode(data.fixType) == 0)
+        return;
+    insert(id, data.latitude, data.longitude, data.timestamp.isValid() ? data.timestamp.toMSecsSinceEpoch() : 0);
+}
+
+void SpatialIndex::insert(uint32_t id, const EpochColumns &columns)
+{
+    if (m_mode == Mode::Latest)
+    {
+        for (size_t i = columns.size(); i-- > 0;)
+        {
+            if (columns.fixQuality[i] > 0 && std::isfinite(columns.latitude[i]) && std::isfinite(columns.longitude[i]))
+            {
+                insert(id, columns.latitude[i], columns.longitude[i], columns.timeMs[i]);
+                return;
+            }
+        }
+        return;
+    }
+
+    // Bulk: everything through the pending buffer, then one sort and merge
+    m_delta.reserve(m_delta.size() + columns.size());
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const double lat = columns.latitude[i];
+        const double lon = columns.longitude[i];
+        if (columns.fixQuality[i] > 0 && std::isfinite(lat) && std::isfinite(lon))
+            m_delta.push_back(Entry{key(lat, lon), id, columns.timeMs[i], lat, lon});
+    }
+    flush();
+}
+
+void SpatialIndex::add(const Entry &entry)
+{
+    m_delta.push_back(entry);
+    if (m_mode == Mode::Latest)
+        m_slots[entry.id] = kInDelta | (m_delta.size() - 1);
+}
+
+void SpatialIndex::eraseSlot(uint64_t slot)
+{
+    if (slot & kInDelta)
+    {
+        const size_t i = static_cast<size_t>(slot & ~kInDelta);
+        if (i + 1 != m_delta.size())
+        {
+            m_delta[i] = m_delta.back();
+            m_slots[m_delta[i].id] = kInDelta | i;
+        }
+        m_delta.pop_back();
+    }
+    else
+    {
+        m_dead[slot] = 1;
+        ++m_deadCount;
+    }
+}
+
+void SpatialIndex::flush()
+{
+    if (m_delta.empty() && m_deadCount == 0)
+        return;
+
+    std::sort(m_delta.begin(), m_delta.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+    const size_t total = m_keys.size() - m_deadCount + m_delta.size();
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> ids;
+    std::vector<int64_t> times;
+    std::vector<double> latitudes, longitudes;
+    keys.reserve(total);
+    ids.reserve(total);
+    times.reserve(total);
+    latitudes.reserve(total);
+    longitudes.reserve(total);
+
+    size_t i = 0, j = 0;
+    while (i < m_keys.size() || j < m_delta.size())
+    {
+        if (j == m_delta.size() || (i < m_keys.size() && m_keys[i] <= m_delta[j].key))
+        {
+            if (!m_dead[i])
+            {
+                keys.push_back(m_keys[i]);
+                ids.push_back(m_ids[i]);
+                times.push_back(m_times[i]);
+                latitudes.push_back(m_latitudes[i]);
+                longitudes.push_back(m_longitudes[i]);
+            }
+            ++i;
+        }
+        else
+        {
+            const Entry &e = m_delta[j++];
+            keys.push_back(e.key);
+            ids.push_back(e.id);
+            times.push_back(e.timeMs);
+            latitudes.push_back(e.latitude);
+            longitudes.push_back(e.longitude);
+        }
+    }
+
+    m_keys.swap(keys);
+    m_ids.swap(ids);
+    m_times.swap(times);
+    m_latitudes.swap(latitudes);
+    m_longitudes.swap(longitudes);
+    m_dead.assign(m_keys.size(), 0);
+    m_deadCount = 0;
+    m_delta.clear();
+    rebuildSlots();
+}
+
+void SpatialIndex::rebuildSlots()
+{
+    if (m_mode != Mode::Latest)
+        return;
+    m_slots.clear();
+    m_slots.reserve(m_ids.size());
+    for (size_t i = 0; i < m_ids.size(); ++i)
+        m_slots[m_ids[i]] = i;
+}
+
+void SpatialIndex::collect(double minLat, double minLon, double maxLat, double maxLon,
+                           std::vector<SpatialHit> &out) const
+{
+    const uint64_t lat0 = quantize(minLat, -90.0, 180.0), lat1 = quantize(maxLat, -90.0, 180.0);
+    const uint64_t lon0 = quantize(minLon, -180.0, 360.0), lon1 = quantize(maxLon, -180.0, 360.0);
+
+    // Finest level at which the box spans at most kMaxCellsPerAxis cells per axis
+    int shift = 0;
+    while (shift < 32 && (((lat1 >> shift) - (lat0 >> shift)) >= kMaxCellsPerAxis
+                          || ((lon1 >> shift) - (lon0 >> shift)) >= kMaxCellsPerAxis))
+    {
+        ++shift;
+    }
+
+    std::pair<uint64_t, uint64_t> ranges[kMaxCellsPerAxis * kMaxCellsPerAxis];
+    int count = 0;
+    const uint64_t cellSpan = shift == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * shift)) - 1;
+    for (uint64_t cy = lat0 >> shift; cy <= (lat1 >> shift); ++cy)
+    {
+        for (uint64_t cx = lon0 >> shift; cx <= (lon1 >> shift); ++cx)
+        {
+            const uint64_t low = shift == 32 ? 0 : (spreadBits(cx) | (spreadBits(cy) << 1)) << (2 * shift);
+            ranges[count++] = {low, low | cellSpan};
+        }
+    }
+    std::sort(ranges, ranges + count);
+
+    // Cells that follow each other in Z-order become one range
+    int merged = 0;
+    for (int r = 1; r < count; ++r)
+    {
+        if (ranges[merged].second != ~uint64_t(0) && ranges[r].first == ranges[merged].second + 1)
+            ranges[merged].second = ranges[r].second;
+        else
+            ranges[++merged] = ranges[r];
+    }
+    count = count ? merged + 1 : 0;
+
+    for (int r = 0; r < count; ++r)
+    {
+        const auto first = std::lower_bound(m_keys.begin(), m_keys.end(), ranges[r].first);
+        const auto last = std::upper_bound(first, m_keys.end(), ranges[r].second);
+        for (size_t i = first - m_keys.begin(), end = last - m_keys.begin(); i < end; ++i)
+        {
+            if (!m_dead[i] && inBox(m_latitudes[i], m_longitudes[i], minLat, minLon, maxLat, maxLon))
+                out.push_back(SpatialHit{m_ids[i], m_times[i], m_latitudes[i], m_longitudes[i], 0.0});
+        }
+    }
+    for (const Entry &e : m_delta)
+    {
+        if (inBox(e.latitude, e.longitude, minLat, minLon, maxLat, maxLon))
+            out.push_back(SpatialHit{e.id, e.timeMs, e.latitude, e.longitude, 0.0});
+    }
+}
+
+size_t SpatialIndex::boundingBox(double minLat, double minLon, double maxLat, double maxLon,
+                                 std::vector<SpatialHit> &out) const
+{
+    out.clear();
+    minLat = std::max(minLat, -90.0);
+    maxLat = std::min(maxLat, 90.0);
+    if (minLat > maxLat)
+        return 0;
+    if (minLon <= maxLon)
+    {
+        collect(minLat, std::max(minLon, -180.0), maxLat, std::min(maxLon, 180.0), out);
+    }
+    else
+    {
+        collect(minLat, minLon, maxLat, 180.0, out);
+        collect(minLat, -180.0, maxLat, maxLon, out);
+    }
+    return out.size();
+}
+
+size_t SpatialIndex::radius(double latitude, double longitude, double radiusM, std::vector<SpatialHit> &out) const
+{
+    out.clear();
+    if (!(radiusM >= 0.0))
+        return 0;
+
+    const double angle = radiusM / kEarthRadius;
+    const double dLat = angle * kRadToDeg;
+    const double cosLat = std::cos(latitude * kDegToRad);
+    if (angle >= M_PI)
+    {
+        boundingBox(-90.0, -180.0, 90.0, 180.0, out);
+    }
+    else if (latitude + dLat >= 90.0 || latitude - dLat <= -90.0 || std::sin(angle) >= cosLat)
+    {
+        // The circle reaches a pole: every longitude
+        boundingBox(latitude - dLat, -180.0, latitude + dLat, 180.0, out);
+    }
+    else
+    {
+        const double dLon = std::asin(std::sin(angle) / cosLat) * kRadToDeg;
+        double minLon = longitude - dLon, maxLon = longitude + dLon;
+        if (minLon < -180.0)
+            minLon += 360.0;
+        if (maxLon > 180.0)
+            maxLon -= 360.0;
+        boundingBox(latitude - dLat, minLon, latitude + dLat, maxLon, out);
+    }
+
+    size_t kept = 0;
+    for (SpatialHit &hit : out)
+    {
+        hit.distance = greatCircle(latitude, longitude, hit.latitude, hit.longitude);
+        if (hit.distance <= radiusM)
+            out[kept++] = hit;
+    }
+    out.resize(kept);
+    std::sort(out.begin(), out.end(), [](const SpatialHit &a, const SpatialHit &b) { return a.distance < b.distance; });
+    return out.size();
+}
+
+size_t SpatialIndex::nearest(double latitude, double longitude, size_t k, std::vector<SpatialHit> &out) const
+{
+    out.clear();
+    if (k == 0 || size() == 0)
+        return 0;
+
+    // Grow the search circle until it holds k points; the closest k of those are the answer
+    for (double r = kFirstNearestRadius;; r *= 4.0)
+    {
+        radius(latitude, longitude, r, out);
+        if (out.size() >= k || r >= M_PI * kEarthRadius)
+            break;
+    }
+    if (out.size() > k)
+        out.resize(k);
+    return out.size();
+}
@@ -0,0 +1,174 @@
+#include <QtTest>
+#include "AccuracyStats.hpp"
+#include "EpochColumns.hpp"
+#include "QtAdapter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+    constexpr double kLat = 45.0;
+    constexpr double kLon = 5.0;
+    constexpr double kAlt = 200.0;
+
+    // Static receiver: ENU noise of @p sigma (m) per horizontal axis, 1.5 sigma vertical, and a bias
+    EpochColumns makeStatic(size_t epochs, double sigma, double biasEast = 0.0)
+    {
+        std::mt19937 rng(41);
+        std::normal_distribution<double> noise(0.0, sigma);
+        const Geodesy::ENUFrame frame = Geodesy::makeENUFrame(kLat, kLon, kAlt);
+
+        std::vector<double> e(epochs), n(epochs), u(epochs);
+        for (size_t i = 0; i < epochs; ++i)
+        {
+            e[i] = biasEast + noise(rng);
+            n[i] = noise(rng);
+            u[i] = 1.5 * noise(rng);
+        }
+
+        EpochColumns columns;
+        columns.timeMs.resize(epochs);
+        columns.latitude.resize(epochs);
+        columns.longitude.resize(epochs);
+        columns.altitude.resize(epochs);
+        columns.hdop.assign(epochs, 1.0);
+        columns.vdop.assign(epochs, 1.5);
+        columns.snrAvg.assign(epochs, 40.0);
+        columns.satellites.assign(epochs, 12);
+        columns.fixQuality.assign(epochs, 1);
+        columns.satOffset.assign(epochs + 1, 0);
+        Geodesy::enuToLla(frame, e.data(), n.data(), u.data(), epochs,
+                          columns.latitude.data(), columns.longitude.data(), columns.altitude.data());
+        for (size_t i = 0; i < epochs; ++i)
+            columns.timeMs[i] = 1700000000000LL + static_cast<int64_t>(i) * 50;
+        return columns;
+    }
+
+    double nearestRank(std::vector<double> v, double q)
+    {
+        std::sort(v.begin(), v.end());
+        const size_t r = static_cast<size_t>(std::ceil(q * v.size()));
+        return v[r == 0 ? 0 : r - 1];
+    }
+}
+
+class TestAccuracyStats : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_percentilesExact()
+    {
+        std::mt19937 rng(5);
+        std::lognormal_distribution<double> dist(0.0, 1.5);
+        std::vector<double> values(300000);
+        for (double &v : values)
+            v = dist(rng);
+        values[17] = 0.0;
+        values[18] = values[19] = 2.0;      // ties
+
+        const std::vector<double> q = {0.0, 0.001, 0.5, 0.95, 0.999, 1.0};
+        for (unsigned threads : {1u, 4u})
+        {
+            const std::vector<double> p = Accuracy::percentiles(values, q, threads);
+            for (size_t k = 0; k < q.size(); ++k)
+                QCOMPARE(p[k], nearestRank(values, q[k]));
+        }
+
+        QVERIFY(std::isnan(Accuracy::percentiles({}, {0.5})[0]));
+        QCOMPARE(Accuracy::percentiles({3.0, 3.0, 3.0}, {0.95})[0], 3.0);
+    }
+
+    void test_percentilesSkipNonFinite()
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double inf = std::numeric_limits<double>::infinity();
+        std::vector<double> values;
+        for (int i = 1; i <= 100; ++i)
+            values.push_back(i);
+        std::vector<double> mixed = values;
+        mixed.insert(mixed.begin() + 10, nan);
+        mixed.insert(mixed.begin() + 50, inf);
+        mixed.push_back(-inf);
+        mixed.push_back(nan);
+
+        const std::vector<double> q = {0.0, 0.5, 0.95, 1.0};
+        QCOMPARE(Accuracy::percentiles(mixed, q), Accuracy::percentiles(values, q));
+        QVERIFY(std::isnan(Accuracy::percentiles({nan, inf}, {0.5})[0]));
+        QCOMPARE(Accuracy::percentiles({nan, 2.0}, {0.5, 1.0}), std::vector<double>({2.0, 2.0}));
+    }
+
+    void test_staticReceiver()
+    {
+        // Circular normal errors: CEP50 = 1.1774 sigma, CEP95 = 2.4477 sigma, 2DRMS = 2.8284 sigma
+        const double sigma = 2.0;
+        const EpochColumns columns = makeStatic(400000, sigma, 1.0);
+
+        const AccuracyReport precision = Accuracy::compute(columns, 0, 4);
+        QCOMPARE(precision.epochs, size_t(400000));
+        QVERIFY(std::fabs(precision.meanEast) < 1e-6);
+        QVERIFY(std::fabs(precision.cep50 / sigma - 1.1774) < 0.01);
+        QVERIFY(std::fabs(precision.cep95 / sigma - 2.4477) < 0.02);
+        QVERIFY(std::fabs(precision.twoDrms / sigma - 2.8284) < 0.01);
+        QVERIFY(std::fabs(precision.vertical95 / (1.5 * sigma) - 1.96) < 0.02);
+
+        // Against the surveyed position the 1 m east bias shows up
+        const AccuracyReport accuracy = Accuracy::compute(columns, Accuracy::Reference{kLat, kLon, kAlt}, 0, 4);
+        QVERIFY(std::fabs(accuracy.meanEast - 1.0) < 0.02);
+        QVERIFY(std::fabs(accuracy.sigmaNorth - sigma) < 0.02);
+        QVERIFY(accuracy.cep50 > precision.cep50);
+        QVERIFY(std::fabs(accuracy.drms * accuracy.drms - (precision.drms * precision.drms
+                                                                    + accuracy.meanEast * accuracy.meanEast + accuracy.meanNorth * accuracy.meanNorth)) < 1e-6);
+
+        // Single-threaded and multi-threaded runs agree
+        const AccuracyReport single = Accuracy::compute(columns, Accuracy::Reference{kLat, kLon, kAlt}, 0, 1);
+        QCOMPARE(single.cep95, accuracy.cep95);
+        QCOMPARE(single.vertical50, accuracy.vertical50);
+        QVERIFY(std::fabs(single.drms - accuracy.drms) < 1e-9);
+    }
+
+    void test_fixFilter()
+    {
+        EpochColumns columns = makeStatic(1000, 1.0);
+        for (size_t i = 0; i < 1000; i += 2)
+            columns.fixQuality[i] = 4;
+        columns.fixQuality[1] = 0;
+        QCOMPARE(Accuracy::compute(columns).epochs, size_t(999));
+        QCOMPARE(Accuracy::compute(columns, 4).epochs, size_t(500));
+        QCOMPARE(Accuracy::compute(columns, 5).epochs, size_t(0));
+    }
+
+    void test_streamMatchesBatch()
+    {
+        const EpochColumns columns = makeStatic(50000, 1.5);
+        const Accuracy::Reference reference{kLat, kLon, kAlt};
+        AccuracyStream stream(reference);
+        GNSSData data;
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            QtAdapter::toGNSSData(columns, i, data);
+            stream.add(data);
+        }
+        const AccuracyReport online = stream.report();
+        const AccuracyReport batch = Accuracy::compute(columns, reference);
+        QCOMPARE(online.epochs, batch.epochs);
+        QVERIFY(std::fabs(online.drms - batch.drms) < 1e-9);
+        QVERIFY(std::fabs(online.sigmaUp - batch.sigmaUp) < 1e-9);
+        QVERIFY(std::fabs(online.cep50 / batch.cep50 - 1.0) < 0.02);
+        QVERIFY(std::fabs(online.cep95 / batch.cep95 - 1.0) < 0.02);
+        QVERIFY(std::fabs(online.vertical95 / batch.vertical95 - 1.0) < 0.02);
+    }
+
+    void bench_dayAt20Hz()
+    {
+        const EpochColumns columns = makeStatic(86400 * 20, 2.0);
+        QBENCHMARK {
+            Accuracy::compute(columns);
+        }
+    }
+};
+
+QTEST_MAIN(TestAccuracyStats)
+#include "test_accuracy_stats.moc"
@@ -0,0 +1,165 @@
+#include <QtTest>
+#include "AllanDeviation.hpp"
+#include "EpochColumns.hpp"
+#include "GNSSDataModel.hpp"
+#include "Geodesy.hpp"
+#include "QtAdapter.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+    // Textbook definitions on explicit window means, O(n m) per factor
+    void bruteForce(const std::vector<double> &y, size_t m, double &adev, double &oadev)
+    {
+        auto mean = [&](size_t i) {
+            double s = 0.0;
+            for (size_t k = i; k < i + m; ++k)
+                s += y[k];
+            return s / m;
+        };
+        double sumO = 0.0, sumN = 0.0;
+        size_t termsO = 0, termsN = 0;
+        for (size_t i = 0; i + 2 * m <= y.size(); ++i)
+        {
+            const double d = mean(i + m) - mean(i);
+            sumO += d * d;
+            ++termsO;
+            if (i % m == 0)
+            {
+                sumN += d * d;
+                ++termsN;
+            }
+        }
+        oadev = std::sqrt(sumO / (2.0 * termsO));
+        adev = std::sqrt(sumN / (2.0 * termsN));
+    }
+}
+
+class TestAllanDeviation : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_octaveFactors()
+    {
+        QCOMPARE(Allan::octaveFactors(64), (std::vector<size_t>{1, 2, 4, 8, 16, 32}));
+        QCOMPARE(Allan::octaveFactors(20, 2), (std::vector<size_t>{1, 2, 3, 4, 6, 8}));
+        QVERIFY(Allan::octaveFactors(1).empty());
+    }
+
+    void test_matchesBruteForce()
+    {
+        std::mt19937 rng(7);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        std::vector<double> y(3000);
+        for (size_t i = 0; i < y.size(); ++i)
+            y[i] = 100.0 + 0.01 * i + noise(rng);
+
+        const std::vector<size_t> factors = {1, 3, 10, 64, 500, 1500};
+        const std::vector<AllanPoint> points = Allan::compute(y, 0.1, factors);
+        QCOMPARE(points.size(), factors.size());
+        for (const AllanPoint &p : points)
+        {
+            double adev, oadev;
+            bruteForce(y, p.factor, adev, oadev);
+            QVERIFY(std::fabs(p.adev - adev) < 1e-9 * adev);
+            QVERIFY(std::fabs(p.oadev - oadev) < 1e-9 * oadev);
+            QVERIFY(std::fabs(p.tau - 0.1 * p.factor) < 1e-12);
+        }
+        QCOMPARE(points.back().terms, size_t(1));
+        QVERIFY(std::isnan(Allan::compute(y, 0.1, {1501})[0].oadev));
+    }
+
+    void test_noiseSlopes()
+    {
+        std::mt19937 rng(11);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        const size_t n = 1 << 20;
+        std::vector<double> white(n), walk(n);
+        double level = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            white[i] = noise(rng);
+            level += 0.01 * noise(rng);
+            walk[i] = level;
+        }
+        const std::vector<size_t> factors = {1, 16, 256};
+
+        // White noise: sigma / sqrt(m)
+        const std::vector<AllanPoint> w = Allan::compute(white, 1.0, factors, {}, 4);
+        for (const AllanPoint &p : w)
+            QVERIFY(std::fabs(p.oadev * std::sqrt(double(p.factor)) - 1.0) < 0.05);
+
+        // Random walk of step q: sqrt(q^2 m / 3) at large m
+        const std::vector<AllanPoint> r = Allan::compute(walk, 1.0, factors, {}, 4);
+        QVERIFY(std::fabs(r[2].oadev / std::sqrt(1e-4 * 256 / 3.0) - 1.0) < 0.15);
+    }
+
+    void test_segmentsSkipGaps()
+    {
+        // A jump between two runs must not leak into the statistics
+        std::vector<double> y(2000, 0.0);
+        for (size_t i = 1000; i < 2000; ++i)
+            y[i] = 50.0;
+        const std::vector<AllanPoint> joined = Allan::compute(y, 1.0, {1, 10});
+        const std::vector<AllanPoint> split = Allan::compute(y, 1.0, {1, 10}, {{0, 1000}, {1000, 2000}});
+        QVERIFY(joined[1].oadev > 1.0);
+        QCOMPARE(split[0].oadev, 0.0);
+        QCOMPARE(split[1].oadev, 0.0);
+        QCOMPARE(split[1].terms, size_t(2 * (1000 - 20 + 1)));
+    }
+
+    void test_positionColumns()
+    {
+        // 10 Hz static receiver, 0.5 m white noise per axis, a 30 s outage and a lost fix
+        const Geodesy::ENUFrame frame = Geodesy::makeENUFrame(45.0, 5.0, 200.0);
+        std::mt19937 rng(13);
+        std::normal_distribution<double> noise(0.0, 0.5);
+
+        EpochColumns columns;
+        GNSSData data;
+        data.fixType = "GPS Fix";
+        data.hdop = 1.0;
+        int64_t t = 1700000000000LL;
+        for (int i = 0; i < 40000; ++i, t += 100)
+        {
+            if (i == 20000)
+                t += 30000;
+            double e = noise(rng), n = noise(rng), u = noise(rng);
+            Geodesy::enuToLla(frame, &e, &n, &u, 1, &data.latitude, &data.longitude, &data.altitude);
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(t, Qt::UTC);
+            data.fixType = (i == 30000) ? "No Fix" : "GPS Fix";
+            QtAdapter::append(columns, data);
+        }
+
+        const Allan::PositionDeviation d = Allan::compute(columns, {}, 0, 2);
+        QCOMPARE(d.tau0, 0.1);
+        QCOMPARE(d.epochs, size_t(39999));
+        QCOMPARE(d.segments, size_t(3));
+        QVERIFY(!d.east.empty());
+        QCOMPARE(d.east.front().tau, 0.1);
+        for (const std::vector<AllanPoint> *axis : {&d.east, &d.north, &d.up})
+        {
+            // The first fix is the ENU origin, which only shifts the series
+            QVERIFY(std::fabs((*axis)[0].oadev / 0.5 - 1.0) < 0.03);
+            QVERIFY(std::fabs((*axis)[4].oadev * 4.0 / 0.5 - 1.0) < 0.1);
+        }
+    }
+
+    void bench_weekAt10Hz()
+    {
+        std::mt19937 rng(17);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        std::vector<double> y(7 * 86400 * 10);
+        for (double &v : y)
+            v = noise(rng);
+        const std::vector<size_t> factors = Allan::octaveFactors(y.size(), 2);
+        QBENCHMARK {
+            Allan::compute(y, 0.1, factors);
+        }
+    }
+};
+
+QTEST_MAIN(TestAllanDeviation)
+#include "test_allan_deviation.moc"
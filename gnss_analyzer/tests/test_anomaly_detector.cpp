@@ -0,0 +1,233 @@
+#include <QtTest>
+#include "AnomalyDetector.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+    constexpr int64_t kStartMs = 1700000000000LL;
+    constexpr double kMetersPerDegree = 111319.49;
+
+    struct Walker {
+        std::mt19937 rng{29};
+        std::normal_distribution<double> noise{0.0, 2.0};
+        double lat = 45.0;
+        double lon = 5.0;
+        double alt = 200.0;
+
+        // One 1 Hz fix moving east at @p speed (m/s) and climbing at @p climb (m/s)
+        bool step(AnomalyDetector &detector, AnomalyReport &report, int i,
+                  double speed = 0.0, double climb = 0.0)
+        {
+            const double east = speed * i + noise(rng);
+            const double north = noise(rng);
+            return detector.updateFix(kStartMs + i * 1000LL,
+                                      lat + north / kMetersPerDegree,
+                                      lon + east / (kMetersPerDegree * std::cos(lat * M_PI / 180.0)),
+                                      alt + climb * i + noise(rng), 1.0, 12, 1,
+                                      std::numeric_limits<double>::quiet_NaN(), report);
+        }
+    };
+}
+
+class TestAnomalyDetector : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_rollingWindow()
+    {
+        RollingWindow<8> w;
+        std::mt19937 rng(3);
+        std::normal_distribution<double> dist(1e6, 3.0);
+        std::vector<double> all;
+        for (int i = 0; i < 1000; ++i)
+        {
+            all.push_back(dist(rng));
+            w.add(all.back());
+        }
+        double mean = 0.0;
+        for (size_t i = all.size() - 8; i < all.size(); ++i)
+            mean += all[i] / 8.0;
+        double var = 0.0;
+        for (size_t i = all.size() - 8; i < all.size(); ++i)
+            var += (all[i] - mean) * (all[i] - mean) / 7.0;
+
+        QVERIFY(w.full());
+        QCOMPARE(w.last(), all.back());
+        QVERIFY(std::fabs(w.mean() - mean) < 1e-9);
+        QVERIFY(std::fabs(w.variance() - var) < 1e-6);
+    }
+
+    void test_cleanTracksNotFlagged()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        Walker walker;
+        for (int i = 0; i < 3600; ++i)
+            QVERIFY(!walker.step(detector, report, i, 25.0, 3.0));
+        for (int t = 0; t < kAnomalyTypes; ++t)
+            QCOMPARE(detector.count(static_cast<AnomalyType>(t)), uint64_t(0));
+    }
+
+    void test_positionJump()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        Walker walker;
+        for (int i = 0; i < 30; ++i)
+            walker.step(detector, report, i);
+
+        // A single 500 m outlier is flagged once, not again on the way back
+        QVERIFY(detector.updateFix(kStartMs + 30000, 45.0, walker.lon + 500.0 / (kMetersPerDegree * std::cos(M_PI / 4)),
+                                   200.0, 1.0, 12, 1, std::numeric_limits<double>::quiet_NaN(), report));
+        QVERIFY(report.has(AnomalyType::PositionJump));
+        QVERIFY(report.jumpMeters > 450.0 && report.allowedJumpMeters < 100.0);
+        QVERIFY(!walker.step(detector, report, 31));
+
+        // A reported speed widens the allowance
+        const double moved = walker.lon + 120.0 / (kMetersPerDegree * std::cos(M_PI / 4));
+        QVERIFY(!detector.updateFix(kStartMs + 32000, 45.0, moved, 200.0, 1.0, 12, 1, 110.0, report));
+
+        // A relocation is accepted after restartAfter rejections
+        AnomalyDetector relocated;
+        for (int i = 0; i < 30; ++i)
+            walker.step(relocated, report, i);
+        for (int i = 0; i < 3; ++i)
+        {
+            QVERIFY(relocated.updateFix(kStartMs + (30 + i) * 1000LL, 46.0, 6.0, 200.0, 1.0, 12, 1,
+                                        std::numeric_limits<double>::quiet_NaN(), report));
+        }
+        QVERIFY(!relocated.updateFix(kStartMs + 33000, 46.0, 6.0, 200.0, 1.0, 12, 1,
+                                     std::numeric_limits<double>::quiet_NaN(), report));
+        QCOMPARE(relocated.count(AnomalyType::PositionJump), uint64_t(3));
+    }
+
+    void test_altitudeSpike()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        Walker walker;
+        for (int i = 0; i < 30; ++i)
+            walker.step(detector, report, i, 0.0, 5.0);
+
+        QVERIFY(detector.updateFix(kStartMs + 30000, walker.lat, walker.lon, 200.0 + 150.0 + 80.0, 1.0, 12, 1,
+                                   std::numeric_limits<double>::quiet_NaN(), report));
+        QVERIFY(report.has(AnomalyType::AltitudeSpike));
+        QVERIFY(!report.has(AnomalyType::PositionJump));
+        QVERIFY(std::fabs(report.altitudeDeviation - 80.0) < 15.0);
+        QVERIFY(!walker.step(detector, report, 31, 0.0, 5.0));
+    }
+
+    void test_timeChecks()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        int64_t t = kStartMs;
+        for (int i = 0; i < 10; ++i, t += 1000)
+            QVERIFY(!detector.updateFix(t, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report));
+
+        QVERIFY(detector.updateFix(t - 1000, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report));
+        QVERIFY(report.has(AnomalyType::TimeDuplicate));
+        QCOMPARE(report.intervalMs, int64_t(0));
+
+        QVERIFY(detector.updateFix(t - 5000, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report));
+        QVERIFY(report.has(AnomalyType::TimeBackwards));
+
+        QVERIFY(!detector.updateFix(t, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report));
+
+        t += 30000;
+        QVERIFY(detector.updateFix(t, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report));
+        QVERIFY(report.has(AnomalyType::TimeGap));
+        QCOMPARE(report.intervalMs, int64_t(30000));
+
+        // parseGGA keeps the current date: 23:59:59 -> 00:00:00 is a rollover, not a reset
+        AnomalyDetector midnight;
+        const int64_t day = 1700006400000LL;
+        for (int s = 10; s >= 1; --s)
+            midnight.updateFix(day - s * 1000LL, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report);
+        QVERIFY(!midnight.updateFix(day - 86400000LL, 45.0, 5.0, 200.0, 1.0, 12, 1, 0.0, report));
+        QCOMPARE(report.intervalMs, int64_t(1000));
+    }
+
+    void test_satelliteCollapseAndSnrDrop()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        GNSSData data;
+        for (int i = 0; i < 20; ++i)
+        {
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs + i * 1000LL, Qt::UTC);
+            data.satellites = 14;
+            data.hdop = 0.8;
+            data.fixType = "GPS Fix";
+            data.latitude = 45.0;
+            data.longitude = 5.0;
+            data.altitude = 200.0;
+            data.satMap.clear();
+            for (int prn = 1; prn <= 8; ++prn)
+                data.satMap[prn] = SATInfo{40.0, prn * 40.0, 44.0 + (i % 3)};
+            QVERIFY(!detector.update(data, report));
+        }
+
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs + 20000, Qt::UTC);
+        data.satellites = 5;
+        data.satMap[3].snr = 28.0;
+        data.satMap[7].snr = -qInf();     // lost: not a measurement
+        QVERIFY(detector.update(data, report));
+        QVERIFY(report.has(AnomalyType::SatelliteCollapse));
+        QVERIFY(report.has(AnomalyType::SnrDrop));
+        QCOMPARE(report.snrDrops.size(), size_t(1));
+        QCOMPARE(report.snrDrops[0], 3);
+        QVERIFY(std::fabs(report.satelliteLevel - 14.0) < 1e-9);
+
+        // A PRN that comes back after a long absence starts a new history
+        for (int i = 0; i < 6; ++i)
+            detector.updateSatellites(QMap<int, SATInfo>{{1, SATInfo{40.0, 40.0, 44.0}}}, report);
+        QMap<int, SATInfo> back{{5, SATInfo{10.0, 200.0, 20.0}}};
+        report.clear();
+        QVERIFY(!detector.updateSatellites(back, report));
+    }
+
+    void test_satMapFedOncePerSequence()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        GNSSData data;
+        data.satellites = 8;
+        data.hdop = 0.8;
+        data.fixType = "GPS Fix";
+        data.latitude = 45.0;
+        data.longitude = 5.0;
+        data.altitude = 200.0;
+        data.satMap[1] = SATInfo{40.0, 40.0, 44.0};
+
+        // The same GSV sequence stays in data over ten GGAs: one SNR sample
+        for (int i = 0; i < 10; ++i)
+        {
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs + i * 1000LL, Qt::UTC);
+            QVERIFY(!detector.update(data, report));
+        }
+
+        // A new sequence with a weak SNR: too little history to flag it
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs + 10000, Qt::UTC);
+        data.satMap[1].snr = 28.0;
+        QVERIFY(!detector.update(data, report));
+        QCOMPARE(detector.count(AnomalyType::SnrDrop), uint64_t(0));
+    }
+
+    void bench_updateFix()
+    {
+        AnomalyDetector detector;
+        AnomalyReport report;
+        int64_t t = kStartMs;
+        QBENCHMARK {
+            for (int i = 0; i < 100000; ++i, t += 1000)
+                detector.updateFix(t, 45.0 + (i & 7) * 1e-6, 5.0, 200.0 + (i & 3), 1.0, 12, 1,
+                                   std::numeric_limits<double>::quiet_NaN(), report);
+        }
+    }
+};
+
+QTEST_MAIN(TestAnomalyDetector)
+#include "test_anomaly_detector.moc"
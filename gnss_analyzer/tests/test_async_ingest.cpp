@@ -0,0 +1,252 @@
+#include <QtTest>
+#include "AsyncIngest.hpp"
+#include "NMEAFramer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    const std::string kEpoch =
+        "$GPGSV,2,1,06,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A\r\n"
+        "$GPGSV,2,2,06,17,10,020,,25,05,330,30*4B\r\n"
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n";
+
+    struct SocketPair {
+        int reader = -1;
+        int writer = -1;
+
+        SocketPair()
+        {
+            int fds[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0)
+            {
+                reader = fds[0];
+                writer = fds[1];
+            }
+        }
+        ~SocketPair()
+        {
+            closeWriter();
+            if (reader >= 0)
+                ::close(reader);
+        }
+        SocketPair(const SocketPair &) = delete;
+        SocketPair &operator=(const SocketPair &) = delete;
+
+        void closeWriter()
+        {
+            if (writer >= 0)
+                ::close(writer);
+            writer = -1;
+        }
+
+        void write(const std::string &data) const
+        {
+            for (size_t done = 0; done < data.size();)
+            {
+                const ssize_t n = ::write(writer, data.data() + done, data.size() - done);
+                if (n <= 0)
+                    return;
+                done += static_cast<size_t>(n);
+            }
+        }
+    };
+
+    Ingest::Task<void> countEpochs(Ingest::NMEASource &source, size_t &epochs, size_t &satellites)
+    {
+        while (const EpochRecord *epoch = co_await source.nextEpoch())
+        {
+            ++epochs;
+            satellites = epoch->satellitesInView.size();
+        }
+    }
+
+    Ingest::Task<int> answer()
+    {
+        co_return 42;
+    }
+
+    Ingest::Task<void> failing(int &value)
+    {
+        value = co_await answer();
+        throw std::runtime_error("source failed");
+    }
+
+    /// Raise the descriptor limit as far as allowed; returns the new soft limit.
+    rlim_t raiseFileLimit()
+    {
+        rlimit limit{};
+        ::getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+        ::getrlimit(RLIMIT_NOFILE, &limit);
+        return limit.rlim_cur;
+    }
+}
+
+class TestAsyncIngest : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_framer()
+    {
+        NMEAFramer framer(32);
+        std::string_view line;
+        framer.feed("$GPGGA,1\r\n$GP", 13);
+        QVERIFY(framer.next(line));
+        QCOMPARE(std::string(line), std::string("$GPGGA,1"));
+        QVERIFY(!framer.next(line));
+
+        // Read in place; the partial line is kept across calls
+        const std::string rest = "GSV,2\n\n";
+        std::memcpy(framer.writeBuffer(64), rest.data(), rest.size());
+        framer.commit(rest.size());
+        QVERIFY(framer.next(line));
+        QCOMPARE(std::string(line), std::string("$GPGSV,2"));
+        QVERIFY(framer.next(line));
+        QVERIFY(line.empty());
+
+        // Overlong lines are dropped up to their newline, in one or several feeds
+        const std::string longLine(40, 'x');
+        framer.feed(longLine.data(), longLine.size());
+        QVERIFY(!framer.next(line));
+        framer.feed(longLine.data(), longLine.size());
+        framer.feed("\n$GPGGA,2", 9);
+        QVERIFY(!framer.next(line));
+        QCOMPARE(framer.overlongLines(), uint64_t(1));
+
+        QVERIFY(framer.flush(line));
+        QCOMPARE(std::string(line), std::string("$GPGGA,2"));
+        QVERIFY(!framer.flush(line));
+    }
+
+    void test_taskResult()
+    {
+        Ingest::EventLoop loop;
+        int value = 0;
+        loop.spawn(failing(value));
+        QVERIFY_EXCEPTION_THROWN(loop.run(), std::runtime_error);
+        QCOMPARE(value, 42);
+        QCOMPARE(loop.activeTasks(), size_t(0));
+    }
+
+    void test_sourceEpochs()
+    {
+        SocketPair pair;
+        QVERIFY(pair.reader >= 0);
+        const std::string log = kEpoch + "$GPGGA,1235,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\n" + kEpoch
+                                + "$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47";     // no final newline
+        pair.write(log);
+        pair.closeWriter();
+
+        Ingest::EventLoop loop;
+        Ingest::NMEASource source(loop, pair.reader, 16);
+        size_t epochs = 0, satellites = 0;
+        loop.spawn(countEpochs(source, epochs, satellites));
+        loop.run();
+        QCOMPARE(epochs, size_t(3));
+        QCOMPARE(satellites, size_t(6));
+        QCOMPARE(source.rejectedLines(), uint64_t(1));
+        QCOMPARE(source.bytesRead(), uint64_t(log.size()));
+    }
+
+    void test_suspendOnReadiness()
+    {
+        // A writer thread trickles partial lines: the sources suspend on
+        // EAGAIN and resume on epoll readiness
+        constexpr size_t kSources = 64;
+        constexpr size_t kEpochs = 20;
+        std::vector<std::unique_ptr<SocketPair>> pairs;
+        for (size_t i = 0; i < kSources; ++i)
+        {
+            pairs.push_back(std::make_unique<SocketPair>());
+            QVERIFY(pairs.back()->reader >= 0);
+        }
+
+        Ingest::EventLoop loop;
+        std::vector<std::unique_ptr<Ingest::NMEASource>> sources;
+        std::vector<size_t> epochs(kSources, 0), satellites(kSources, 0);
+        for (size_t i = 0; i < kSources; ++i)
+        {
+            sources.push_back(std::make_unique<Ingest::NMEASource>(loop, pairs[i]->reader));
+            loop.spawn(countEpochs(*sources[i], epochs[i], satellites[i]));
+        }
+        QCOMPARE(loop.activeTasks(), kSources);
+
+        std::thread writer([&] {
+            const size_t half = kEpoch.size() / 2;
+            for (size_t e = 0; e < kEpochs; ++e)
+            {
+                for (size_t i = 0; i < kSources; ++i)
+                    pairs[i]->write(kEpoch.substr(0, half));
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                for (size_t i = 0; i < kSources; ++i)
+                    pairs[i]->write(kEpoch.substr(half));
+            }
+            for (size_t i = 0; i < kSources; ++i)
+                pairs[i]->closeWriter();
+        });
+        loop.run();
+        writer.join();
+
+        for (size_t i = 0; i < kSources; ++i)
+        {
+            QCOMPARE(epochs[i], kEpochs);
+            QCOMPARE(satellites[i], size_t(6));
+        }
+    }
+
+    void bench_10kSockets()
+    {
+        // 10k receivers on one thread, each fed one epoch per round by a writer thread
+        constexpr size_t kRounds = 10;
+        const rlim_t limit = raiseFileLimit();
+        const size_t sourceCount = std::min<size_t>(10000, (limit - 64) / 2);
+        if (sourceCount < 1000)
+            QSKIP("descriptor limit too low");
+
+        QBENCHMARK_ONCE {
+            std::vector<std::unique_ptr<SocketPair>> pairs;
+            pairs.reserve(sourceCount);
+            for (size_t i = 0; i < sourceCount; ++i)
+                pairs.push_back(std::make_unique<SocketPair>());
+
+            Ingest::EventLoop loop;
+            std::vector<std::unique_ptr<Ingest::NMEASource>> sources;
+            std::vector<size_t> epochs(sourceCount, 0), satellites(sourceCount, 0);
+            for (size_t i = 0; i < sourceCount; ++i)
+            {
+                sources.push_back(std::make_unique<Ingest::NMEASource>(loop, pairs[i]->reader, 4096));
+                loop.spawn(countEpochs(*sources[i], epochs[i], satellites[i]));
+            }
+
+            std::thread writer([&] {
+                for (size_t r = 0; r < kRounds; ++r)
+                    for (size_t i = 0; i < sourceCount; ++i)
+                        pairs[i]->write(kEpoch);
+                for (size_t i = 0; i < sourceCount; ++i)
+                    pairs[i]->closeWriter();
+            });
+            loop.run();
+            writer.join();
+
+            size_t total = 0;
+            for (size_t e : epochs)
+                total += e;
+            QCOMPARE(total, sourceCount * kRounds);
+        }
+    }
+};
+
+QTEST_MAIN(TestAsyncIngest)
+#include "test_async_ingest.moc"
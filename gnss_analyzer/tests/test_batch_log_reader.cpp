@@ -0,0 +1,206 @@
+#include <QtTest>
+#include "BatchLogReader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    const std::string kEpoch =
+        "$GPGSV,2,1,06,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A\r\n"
+        "$GPGSV,2,2,06,17,10,020,,25,05,330,30*4B\r\n"
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n";
+
+    void writeFile(const std::string &path, const std::string &text)
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        for (size_t done = 0; fd >= 0 && done < text.size();)
+        {
+            const ssize_t n = ::write(fd, text.data() + done, text.size() - done);
+            if (n <= 0)
+                break;
+            done += static_cast<size_t>(n);
+        }
+        ::close(fd);
+    }
+
+    std::string log(size_t epochs)
+    {
+        std::string text;
+        for (size_t i = 0; i < epochs; ++i)
+            text += kEpoch;
+        return text;
+    }
+
+    struct Replay {
+        std::vector<size_t> epochs;
+        std::vector<uint64_t> bytes;
+        uint64_t systemCalls = 0;
+        bool ioUring = false;
+    };
+
+    Replay replay(const std::vector<std::string> &paths, const BatchLogReaderConfig &config)
+    {
+        Replay result;
+        result.epochs.assign(paths.size(), 0);
+        Ingest::BatchLogReader reader([&](Ingest::BatchLogReader::Source &source) {
+            ++result.epochs[source.id];
+        }, config);
+        std::vector<int> fds;
+        for (const std::string &path : paths)
+        {
+            fds.push_back(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+            reader.add(fds.back());
+        }
+        reader.run();
+        for (size_t i = 0; i < paths.size(); ++i)
+            result.bytes.push_back(reader.source(i).bytes);
+        result.systemCalls = reader.systemCalls();
+        result.ioUring = reader.usingIoUring();
+        for (int fd : fds)
+            ::close(fd);
+        return result;
+    }
+}
+
+class TestBatchLogReader : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        for (size_t i = 0; i < 20; ++i)
+        {
+            m_paths.push_back(m_dir.filePath(QString("log%1.nmea").arg(i)).toStdString());
+            writeFile(m_paths.back(), log(100 * i + 1));
+        }
+        // No final newline, a rejected GGA and an empty file
+        writeFile(m_dir.filePath("tail.nmea").toStdString(),
+                  kEpoch + "$GPGGA,1235,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\n"
+                      + "$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47");
+        writeFile(m_dir.filePath("empty.nmea").toStdString(), "");
+    }
+
+    void test_ioUringMatchesPread()
+    {
+        BatchLogReaderConfig config;
+        config.queueDepth = 8;          // fewer buffers than files
+        config.blockSize = 4096;
+        const Replay ring = replay(m_paths, config);
+        config.usePread = true;
+        const Replay pread = replay(m_paths, config);
+        if (!ring.ioUring)
+            qDebug() << "io_uring unavailable, both runs used pread";
+        QVERIFY(!pread.ioUring);
+
+        for (size_t i = 0; i < m_paths.size(); ++i)
+        {
+            QCOMPARE(ring.epochs[i], 100 * i + 1);
+            QCOMPARE(pread.epochs[i], 100 * i + 1);
+            QCOMPARE(ring.bytes[i], uint64_t(kEpoch.size() * (100 * i + 1)));
+        }
+    }
+
+    void test_lastLineAndErrors()
+    {
+        size_t epochs = 0;
+        Ingest::BatchLogReader reader([&](Ingest::BatchLogReader::Source &) { ++epochs; });
+        const int tail = ::open(m_dir.filePath("tail.nmea").toStdString().c_str(), O_RDONLY | O_CLOEXEC);
+        const int empty = ::open(m_dir.filePath("empty.nmea").toStdString().c_str(), O_RDONLY | O_CLOEXEC);
+        const int skipped = ::open(m_paths[1].c_str(), O_RDONLY | O_CLOEXEC);
+        ::lseek(skipped, static_cast<off_t>(100 * kEpoch.size()), SEEK_SET);      // reads start at the current position
+        reader.add(tail);
+        reader.add(empty);
+        reader.add(skipped);
+        reader.run();
+        QCOMPARE(epochs, size_t(3));
+        QCOMPARE(reader.source(0).context.rejectedLines(), uint64_t(1));
+        QCOMPARE(reader.source(0).sentences, uint64_t(5));
+        if (ParseStats::kEnabled)
+        {
+            const ParseCounters counters = reader.parseCounters();
+            QCOMPARE(counters.sentences(), reader.source(0).sentences + reader.source(2).sentences);
+            QCOMPARE(counters[ParseCounter::InvalidDataErrors] + counters[ParseCounter::ParsingErrors], uint64_t(1));
+        }
+        QVERIFY(reader.source(1).finished);
+        QCOMPARE(reader.source(1).bytes, uint64_t(0));
+        QCOMPARE(reader.source(2).bytes, uint64_t(kEpoch.size()));
+        ::close(tail);
+        ::close(empty);
+        ::close(skipped);
+    }
+
+    void test_pipeSource()
+    {
+        // A device-like descriptor that cannot seek, written while it is read
+        int fds[2];
+        QVERIFY(::pipe2(fds, O_CLOEXEC) == 0);
+        std::thread writer([fd = fds[1]] {
+            const std::string text = log(500);
+            for (size_t done = 0; done < text.size(); done += 1000)
+            {
+                const size_t length = std::min<size_t>(1000, text.size() - done);
+                if (::write(fd, text.data() + done, length) < 0)
+                    break;
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            ::close(fd);
+        });
+
+        size_t epochs = 0;
+        Ingest::BatchLogReader reader([&](Ingest::BatchLogReader::Source &) { ++epochs; });
+        reader.add(fds[0]);
+        QVERIFY(!reader.source(0).seekable);
+        reader.run();
+        writer.join();
+        ::close(fds[0]);
+        QCOMPARE(epochs, size_t(500));
+    }
+
+    void bench_replayIoUring()
+    {
+        benchReplay(false);
+    }
+
+    void bench_replayPread()
+    {
+        benchReplay(true);
+    }
+
+private:
+    // 200 logs of 2000 epochs (about 350 kB each)
+    void benchReplay(bool usePread)
+    {
+        if (m_benchPaths.empty())
+        {
+            const std::string text = log(2000);
+            for (size_t i = 0; i < 200; ++i)
+            {
+                m_benchPaths.push_back(m_dir.filePath(QString("bench%1.nmea").arg(i)).toStdString());
+                writeFile(m_benchPaths.back(), text);
+            }
+        }
+
+        BatchLogReaderConfig config;
+        config.usePread = usePread;
+        Replay result;
+        QBENCHMARK_ONCE {
+            result = replay(m_benchPaths, config);
+        }
+        qDebug() << (result.ioUring ? "io_uring:" : "pread:") << result.systemCalls << "system calls";
+        QCOMPARE(result.epochs[199], size_t(2000));
+    }
+
+    QTemporaryDir m_dir;
+    std::vector<std::string> m_paths;
+    std::vector<std::string> m_benchPaths;
+};
+
+QTEST_MAIN(TestBatchLogReader)
+#include "test_batch_log_reader.moc"
@@ -0,0 +1,133 @@
+#include <QtTest>
+#include <zlib.h>
+#include "CompressedLogReader.hpp"
+#include "NMEAParser.hpp"
+
+namespace {
+
+    QByteArray makeLog(int epochs)
+    {
+        QByteArray text;
+        for (int i = 0; i < epochs; ++i)
+        {
+            text += QString("$GPGGA,%1%2%3.00,4807.038,N,01131.000,E,1,08,0.9,%4.0,M,,*47\r\n")
+                        .arg(i / 3600 % 24, 2, 10, QChar('0'))
+                        .arg(i / 60 % 60, 2, 10, QChar('0'))
+                        .arg(i % 60, 2, 10, QChar('0'))
+                        .arg(i % 1000)
+                        .toLatin1();
+            text += "$GPGSV,1,1,02,05,40,100,42,12,30,200,38*00\n";
+        }
+        return text;
+    }
+
+    void writeGzip(const QString &path, const QByteArray &text, int members)
+    {
+        const int step = text.size() / members + 1;
+        for (int m = 0; m < members; ++m)
+        {
+            gzFile out = gzopen(path.toLocal8Bit().constData(), m == 0 ? "wb" : "ab");
+            QVERIFY(out);
+            const QByteArray part = text.mid(m * step, step);
+            gzwrite(out, part.constData(), part.size());
+            gzclose(out);
+        }
+    }
+
+    QList<QByteArray> readAll(CompressedLogReader &reader)
+    {
+        QList<QByteArray> lines;
+        const char *line = nullptr;
+        size_t length = 0;
+        while (reader.nextLine(line, length))
+            lines.append(QByteArray(line, int(length)));
+        return lines;
+    }
+}
+
+class TestCompressedLogReader : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_text = makeLog(5000);
+        m_text += "$GPGGA,235959.00,4807.038,N,01131.000,E,1,08,0.9,1.0,M,,*47";  // no terminator
+
+        QFile plain(m_dir.filePath("log.nmea"));
+        QVERIFY(plain.open(QIODevice::WriteOnly));
+        plain.write(m_text);
+        plain.close();
+
+        writeGzip(m_dir.filePath("log.nmea.gz"), m_text, 3);
+    }
+
+    void test_detect()
+    {
+        using C = CompressedLogReader::Compression;
+        QVERIFY(CompressedLogReader::detect(m_dir.filePath("log.nmea").toStdString()) == C::None);
+        QVERIFY(CompressedLogReader::detect(m_dir.filePath("log.nmea.gz").toStdString()) == C::Gzip);
+    }
+
+    void test_lines_data()
+    {
+        QTest::addColumn<QString>("file");
+        QTest::addColumn<int>("chunkSize");
+
+        // Small chunks split almost every line across buffers
+        QTest::newRow("plain_small_chunks") << "log.nmea" << 61;
+        QTest::newRow("plain") << "log.nmea" << 256 * 1024;
+        QTest::newRow("gzip_small_chunks") << "log.nmea.gz" << 61;
+        QTest::newRow("gzip") << "log.nmea.gz" << 256 * 1024;
+    }
+
+    void test_lines()
+    {
+        QFETCH(QString, file);
+        QFETCH(int, chunkSize);
+
+        CompressedLogReader reader(m_dir.filePath(file).toStdString(),
+                                   CompressedLogReader::Compression::Auto, chunkSize, 3);
+        const QList<QByteArray> lines = readAll(reader);
+
+        QList<QByteArray> expected = m_text.split('\n');
+        for (QByteArray &line : expected)
+        {
+            if (line.endsWith('\r'))
+                line.chop(1);
+        }
+        QCOMPARE(lines, expected);
+    }
+
+    void test_parseCompressedLog()
+    {
+        GNSSData data;
+        int delivered = 0;
+        const size_t epochs = NMEAParser::parseCompressedLog(
+            m_dir.filePath("log.nmea.gz").toStdString(), data,
+            [&](const GNSSData &) { ++delivered; });
+        QCOMPARE(epochs, size_t(5001));
+        QCOMPARE(delivered, 5001);
+        QCOMPARE(data.altitude, 1.0);
+    }
+
+    void test_corruptGzip()
+    {
+        QFile bad(m_dir.filePath("bad.gz"));
+        QVERIFY(bad.open(QIODevice::WriteOnly));
+        bad.write("\x1f\x8b\x08\x00garbagegarbage");
+        bad.close();
+
+        CompressedLogReader reader(bad.fileName().toStdString());
+        QVERIFY_EXCEPTION_THROWN(readAll(reader), ArchiveError);
+    }
+
+private:
+    QTemporaryDir m_dir;
+    QByteArray m_text;
+};
+
+QTEST_MAIN(TestCompressedLogReader)
+#include "test_compressed_log.moc"
@@ -0,0 +1,186 @@
+#include <QtTest>
+#include "DOP.hpp"
+#include "EpochColumns.hpp"
+#include "QtAdapter.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+    QMap<int, SATInfo> randomSky(std::mt19937 &rng, int count)
+    {
+        // Whole degrees, as GSV reports them
+        std::uniform_int_distribution<int> elevation(5, 90);
+        std::uniform_int_distribution<int> azimuth(0, 359);
+        QMap<int, SATInfo> sky;
+        for (int k = 1; k <= count; ++k)
+            sky[k] = SATInfo{double(elevation(rng)), double(azimuth(rng)), 40.0};
+        return sky;
+    }
+
+    // Reference: Gauss-Jordan inverse of the full normal matrix
+    DOPValues referenceDOP(const QMap<int, SATInfo> &sky)
+    {
+        double n[4][8] = {};
+        for (auto it = sky.constBegin(); it != sky.constEnd(); ++it)
+        {
+            const double el = it.value().elevation * M_PI / 180.0;
+            const double az = it.value().azimuth * M_PI / 180.0;
+            const double row[4] = {std::cos(el) * std::sin(az), std::cos(el) * std::cos(az), std::sin(el), 1.0};
+            for (int r = 0; r < 4; ++r)
+                for (int c = 0; c < 4; ++c)
+                    n[r][c] += row[r] * row[c];
+        }
+        for (int r = 0; r < 4; ++r)
+            n[r][4 + r] = 1.0;
+        for (int p = 0; p < 4; ++p)
+        {
+            int best = p;
+            for (int r = p + 1; r < 4; ++r)
+                if (std::fabs(n[r][p]) > std::fabs(n[best][p]))
+                    best = r;
+            std::swap(n[p], n[best]);
+            const double pivot = n[p][p];
+            for (int c = 0; c < 8; ++c)
+                n[p][c] /= pivot;
+            for (int r = 0; r < 4; ++r)
+            {
+                if (r == p)
+                    continue;
+                const double factor = n[r][p];
+                for (int c = 0; c < 8; ++c)
+                    n[r][c] -= factor * n[p][c];
+            }
+        }
+        DOPValues dop;
+        dop.hdop = std::sqrt(n[0][4] + n[1][5]);
+        dop.vdop = std::sqrt(n[2][6]);
+        dop.tdop = std::sqrt(n[3][7]);
+        dop.pdop = std::sqrt(n[0][4] + n[1][5] + n[2][6]);
+        dop.gdop = std::sqrt(n[0][4] + n[1][5] + n[2][6] + n[3][7]);
+        return dop;
+    }
+
+    bool close(double a, double b)
+    {
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+    }
+}
+
+class TestDOP : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_matchesReferenceInverse()
+    {
+        std::mt19937 rng(5);
+        for (int trial = 0; trial < 200; ++trial)
+        {
+            const QMap<int, SATInfo> sky = randomSky(rng, 4 + trial % 12);
+            const DOPValues dop = DOP::compute(sky);
+            const DOPValues ref = referenceDOP(sky);
+            QVERIFY(dop.valid);
+            QCOMPARE(dop.satellites, sky.size());
+            QVERIFY(close(dop.gdop, ref.gdop));
+            QVERIFY(close(dop.pdop, ref.pdop));
+            QVERIFY(close(dop.hdop, ref.hdop));
+            QVERIFY(close(dop.vdop, ref.vdop));
+            QVERIFY(close(dop.tdop, ref.tdop));
+        }
+    }
+
+    void test_degenerateGeometry()
+    {
+        QMap<int, SATInfo> sky;
+        sky[1] = SATInfo{30.0, 0.0, 40.0};
+        sky[2] = SATInfo{30.0, 90.0, 40.0};
+        sky[3] = SATInfo{30.0, 180.0, 40.0};
+        QVERIFY(!DOP::compute(sky).valid);
+
+        // Same elevation everywhere: the up column equals the clock column
+        sky[4] = SATInfo{30.0, 270.0, 40.0};
+        const DOPValues dop = DOP::compute(sky);
+        QVERIFY(!dop.valid);
+        QVERIFY(std::isnan(dop.vdop));
+
+        sky[5] = SATInfo{85.0, 45.0, 40.0};
+        QVERIFY(DOP::compute(sky).valid);
+
+        // Elevation mask and unknown angles drop satellites
+        sky[6] = SATInfo{-qInf(), -qInf(), 30.0};
+        QCOMPARE(DOP::compute(sky).satellites, 5);
+        QCOMPARE(DOP::compute(sky, 40.0).satellites, 1);
+    }
+
+    void test_batchMatchesScalar()
+    {
+        std::mt19937 rng(9);
+        EpochColumns columns;
+        std::vector<QMap<int, SATInfo>> skies;
+        for (int k = 0; k < 500; ++k)
+        {
+            GNSSData data;
+            data.satMap = randomSky(rng, k % 14);
+            if (k % 7 == 0)
+                data.satMap[99] = SATInfo{-qInf(), -qInf(), 0.0};
+            skies.push_back(data.satMap);
+            QtAdapter::append(columns, data);
+        }
+
+        std::vector<DOPValues> batch;
+        DOP::compute(columns, batch, 10.0);
+        QCOMPARE(batch.size(), columns.size());
+        for (size_t k = 0; k < batch.size(); ++k)
+        {
+            const DOPValues scalar = DOP::compute(skies[k], 10.0);
+            QCOMPARE(batch[k].valid, scalar.valid);
+            QCOMPARE(batch[k].satellites, scalar.satellites);
+            if (scalar.valid)
+            {
+                QVERIFY(close(batch[k].gdop, scalar.gdop));
+                QVERIFY(close(batch[k].vdop, scalar.vdop));
+            }
+        }
+
+        DOP::apply(columns, 10.0);
+        for (size_t k = 0; k < batch.size(); ++k)
+            QCOMPARE(columns.vdop[k], batch[k].valid ? batch[k].vdop : 0.0);
+    }
+
+    void test_leaveOneOut()
+    {
+        std::mt19937 rng(3);
+        const QMap<int, SATInfo> sky = randomSky(rng, 8);
+        const auto whatIf = DOP::leaveOneOut(sky);
+        QCOMPARE(whatIf.size(), size_t(8));
+
+        const DOPValues all = DOP::compute(sky);
+        for (const auto &entry : whatIf)
+        {
+            const DOPValues without = DOP::compute(sky, 0.0, {entry.first});
+            QCOMPARE(entry.second.satellites, 7);
+            QVERIFY(close(entry.second.pdop, without.pdop));
+            QVERIFY(entry.second.gdop >= all.gdop);    // removing a satellite never helps
+        }
+    }
+
+    void test_applyAndCrossCheck()
+    {
+        std::mt19937 rng(1);
+        GNSSData data;
+        data.satMap = randomSky(rng, 10);
+        const DOPValues dop = DOP::apply(data);
+        QVERIFY(dop.valid);
+        QCOMPARE(data.vdop, dop.vdop);
+
+        QVERIFY(!DOP::hdopMismatch(dop.hdop, dop));
+        QVERIFY(!DOP::hdopMismatch(dop.hdop * 1.5, dop));
+        QVERIFY(DOP::hdopMismatch(dop.hdop * 0.5, dop));
+        QVERIFY(DOP::hdopMismatch(dop.hdop * 10.0, dop));
+        QVERIFY(!DOP::hdopMismatch(0.0, dop));
+    }
+};
+
+QTEST_MAIN(TestDOP)
+#include "test_dop.moc"
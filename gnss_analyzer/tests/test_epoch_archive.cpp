@@ -0,0 +1,138 @@
+#include <QtTest>
+#include "EpochArchive.hpp"
+#include "GNSSDataModel.hpp"
+
+namespace {
+
+    const int64_t kStartMs = 1700000000000LL;
+
+    GNSSData makeEpoch(int i)
+    {
+        GNSSData data;
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs + i * 100, Qt::UTC);
+        data.latitude = 45.0 + i * 1e-6;
+        data.longitude = 5.5;
+        data.altitude = 200.0 + i % 7;
+        data.hdop = 0.9;
+        data.satellites = i % 12;
+        data.fixType = (i % 3) ? "GPS Fix" : "RTK Fix";
+        for (int s = 0; s < i % 5; ++s)
+        {
+            SATInfo info;
+            info.elevation = 10.0 * s;
+            info.azimuth = 20.0 * s;
+            info.snr = 30.0 + s;
+            data.satMap.insert(3 * s + 1, info);
+        }
+        return data;
+    }
+}
+
+class TestEpochArchive : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_path = m_dir.filePath("day.gea").toStdString();
+
+        EpochArchiveWriter writer(m_path, 1000);
+        for (int i = 0; i < kEpochs; ++i)
+            writer.append(makeEpoch(i));
+        writer.close();
+        QCOMPARE(writer.epochCount(), uint64_t(kEpochs));
+    }
+
+    void test_index()
+    {
+        EpochArchiveReader reader(m_path);
+        QCOMPARE(reader.epochCount(), uint64_t(kEpochs));
+        QCOMPARE(reader.blockCount(), size_t(11));
+
+        QCOMPARE(reader.lowerBound(0), uint64_t(0));
+        QCOMPARE(reader.lowerBound(kStartMs + 5000 * 100), uint64_t(5000));
+        QCOMPARE(reader.lowerBound(kStartMs + 5000 * 100 + 1), uint64_t(5001));
+        QCOMPARE(reader.lowerBound(kStartMs + kEpochs * 100), uint64_t(kEpochs));
+    }
+
+    void test_readColumns()
+    {
+        EpochArchiveReader reader(m_path);
+        EpochColumns columns;
+        reader.read(990, 2010, columns);
+        QCOMPARE(columns.size(), size_t(1020));
+
+        for (size_t k = 0; k < columns.size(); ++k)
+        {
+            const int i = 990 + int(k);
+            QCOMPARE(columns.timeMs[k], kStartMs + i * 100);
+            QCOMPARE(columns.fixQuality[k], uint8_t((i % 3) ? 1 : 4));
+            QCOMPARE(columns.satOffset[k + 1] - columns.satOffset[k], uint64_t(i % 5));
+        }
+    }
+
+    void test_roundTrip()
+    {
+        EpochArchiveReader reader(m_path);
+        const GNSSData expected = makeEpoch(7777);
+        GNSSData data;
+        reader.get(7777, data);
+
+        QCOMPARE(data.timestamp, expected.timestamp);
+        QCOMPARE(data.latitude, expected.latitude);
+        QCOMPARE(data.altitude, expected.altitude);
+        QCOMPARE(data.satellites, expected.satellites);
+        QCOMPARE(data.fixType, expected.fixType);
+        QCOMPARE(data.satMap.size(), expected.satMap.size());
+        QCOMPARE(data.satMap[4].snr, 31.0);
+    }
+
+    void test_rejectsOutOfOrder()
+    {
+        EpochArchiveWriter writer(m_dir.filePath("bad.gea").toStdString());
+        writer.append(makeEpoch(10));
+        QVERIFY_EXCEPTION_THROWN(writer.append(makeEpoch(9)), ArchiveError);
+    }
+
+    void test_rejectsCorruptFile()
+    {
+        const QString path = m_dir.filePath("garbage.gea");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(256, 'x'));
+        file.close();
+        QVERIFY_EXCEPTION_THROWN(EpochArchiveReader reader(path.toStdString()), ArchiveError);
+    }
+
+    void test_rejectsCorruptSatelliteOffsets()
+    {
+        const std::string path = m_dir.filePath("offsets.gea").toStdString();
+        {
+            EpochArchiveWriter writer(path, 10);
+            for (int i = 0; i < 10; ++i)
+                writer.append(makeEpoch(i));
+        }
+
+        // satOffset of the first block follows 7 columns of 10 x 8 bytes and two of 10 x 1 (padded to 16)
+        QFile file(QString::fromStdString(path));
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(sizeof(EpochArchive::FileHeader) + 7 * 80 + 2 * 16 + 3 * sizeof(uint32_t)));
+        const uint32_t corrupt = 1000;
+        file.write(reinterpret_cast<const char *>(&corrupt), sizeof(corrupt));
+        file.close();
+
+        EpochArchiveReader reader(path);
+        EpochColumns columns;
+        QVERIFY_EXCEPTION_THROWN(reader.read(0, 10, columns), ArchiveError);
+    }
+
+private:
+    static constexpr int kEpochs = 10500;
+    QTemporaryDir m_dir;
+    std::string m_path;
+};
+
+QTEST_MAIN(TestEpochArchive)
+#include "test_epoch_archive.moc"
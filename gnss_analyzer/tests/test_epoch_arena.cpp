@@ -0,0 +1,178 @@
+#include <QtTest>
+#include "EpochArena.hpp"
+#include "NMEAEpochContext.hpp"
+#include "NMEAException.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Count every call to malloc in the process (glibc: forward to the real one)
+#ifdef __GLIBC__
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+}
+
+namespace {
+    std::atomic<uint64_t> g_mallocCalls{0};
+}
+
+extern "C" void *malloc(size_t size)
+{
+    g_mallocCalls.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    g_mallocCalls.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    g_mallocCalls.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+namespace {
+
+    const char *const kEpoch[] = {
+        "$GPGSV,3,1,10,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A\r\n",
+        "$GPGSV,3,2,10,17,10,020,,25,05,330,30,04,41,151,39,31,07,100,*4B\r\n",
+        "$GPGSV,3,3,10,05,20,200,25,33,,,*4B\r\n",
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n",
+    };
+
+    uint64_t mallocCalls()
+    {
+#ifdef __GLIBC__
+        return g_mallocCalls.load(std::memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+}
+
+class TestEpochArena : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_arena()
+    {
+        EpochArena arena(256);
+        void *a = arena.allocate(10, 1);
+        void *b = arena.allocate(16, 16);
+        QVERIFY(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+        QVERIFY(static_cast<char *>(b) >= static_cast<char *>(a) + 10);
+        QCOMPARE(arena.blockAllocations(), uint64_t(1));
+
+        // Spill over, then the next epoch fits in one merged block
+        QVERIFY(arena.allocate(1000, 8) != nullptr);
+        QCOMPARE(arena.blockAllocations(), uint64_t(2));
+        const size_t capacity = arena.capacity();
+        arena.reset();
+        QCOMPARE(arena.used(), size_t(0));
+        QCOMPARE(arena.blockAllocations(), uint64_t(3));
+        QCOMPARE(arena.capacity(), capacity);
+        void *c = arena.allocate(1100, 8);
+        arena.reset();
+        QCOMPARE(arena.allocate(1100, 8), c);
+        QCOMPARE(arena.blockAllocations(), uint64_t(3));
+    }
+
+    void test_allocatorAwareRecord()
+    {
+        EpochArena arena;
+        EpochRecord record{EpochRecord::allocator_type(&arena)};
+        record.satellitesInView.push_back(SatelliteRecord{7, 45.0, 90.0, 40.0});
+        QVERIFY(arena.used() > 0);
+        QVERIFY(record.satellitesInView.get_allocator().resource() == &arena);
+
+        // Copies leave the arena unless asked to stay in one
+        const EpochRecord copy(record);
+        QVERIFY(copy.satellitesInView.get_allocator().resource() == std::pmr::get_default_resource());
+        QCOMPARE(copy.satellitesInView[0].id, 7);
+        EpochArena other;
+        const EpochRecord moved(record, EpochRecord::allocator_type(&other));
+        QVERIFY(moved.satellitesInView.get_allocator().resource() == &other);
+        QCOMPARE(moved.satellitesInView[0].snr, 40.0);
+    }
+
+    void test_contextEpochs()
+    {
+        NMEAEpochContext context;
+        int epochs = 0;
+        for (int i = 0; i < 3; ++i)
+            for (const char *line : kEpoch)
+                if (context.parse(line))
+                {
+                    ++epochs;
+                    QCOMPARE(context.epoch().satellitesInView.size(), size_t(9));
+                    QCOMPARE(context.epoch().fixQuality, uint8_t(1));
+                }
+        QCOMPARE(epochs, 3);
+
+        // Satellites carry over to an epoch without GSV
+        QVERIFY(context.parse(kEpoch[3]));
+        QCOMPARE(context.epoch().satellitesInView.size(), size_t(9));
+        QCOMPARE(context.epoch().satellitesInView[8].id, 33);
+
+        QVERIFY(!context.parse("$GPGGA,123519,4807.038,N,01131.000,E,3,08,0.9,545.4,M,,*47"));
+        QCOMPARE(context.rejectedLines(), uint64_t(1));
+    }
+
+    void test_inlineExceptionMessage()
+    {
+        try {
+            throw InvalidDataError("Unknown fix quality code: ", 3);
+        } catch (const NMEAException &e) {
+            QCOMPARE(std::string(e.what()), std::string("InvalidData: Unknown fix quality code: 3"));
+        }
+        const std::string longMessage(500, 'x');
+        const ParsingError truncated(longMessage);
+        QCOMPARE(std::string(truncated.what()).size(), size_t(159));
+    }
+
+    void test_steadyStateWithoutMalloc()
+    {
+#ifndef __GLIBC__
+        QSKIP("malloc counting needs glibc");
+#endif
+        NMEAEpochContext context;
+        for (int i = 0; i < 100; ++i)
+            for (const char *line : kEpoch)
+                context.parse(line);
+
+        const uint64_t before = mallocCalls();
+        int epochs = 0;
+        for (int i = 0; i < 10000; ++i)
+            for (const char *line : kEpoch)
+                epochs += context.parse(line);
+        const uint64_t calls = mallocCalls() - before;
+        QCOMPARE(epochs, 10000);
+        QCOMPARE(calls, uint64_t(0));
+
+        // A rejected line allocates the exception object, not its message
+        const uint64_t beforeReject = mallocCalls();
+        context.parse("$GPGGA,123519,4807.038,N,01131.000,E,3,08,0.9,545.4,M,,*47");
+        QVERIFY(mallocCalls() - beforeReject <= 1);
+    }
+
+    void bench_contextParse()
+    {
+        NMEAEpochContext context;
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i)
+                for (const char *line : kEpoch)
+                    context.parse(line);
+        }
+    }
+};
+
+QTEST_MAIN(TestEpochArena)
+#include "test_epoch_arena.moc"
@@ -0,0 +1,98 @@
+#include <QtTest>
+#include "EpochCodec.hpp"
+#include "ArchiveError.hpp"
+
+namespace {
+
+    // 10 Hz static receiver with small position noise and one time glitch
+    EpochColumns makeSeries(int count)
+    {
+        EpochColumns columns;
+        columns.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            const double noise = ((i * 7919) % 13 - 6) * 1e-7;
+            columns.timeMs.push_back(1700000000000LL + i * 100 + (i == 500 ? 3 : 0));
+            columns.latitude.push_back(45.1234567 + noise);
+            columns.longitude.push_back(5.7654321 - noise);
+            columns.altitude.push_back(212.345 + noise * 1e4);
+            columns.hdop.push_back(0.8 + (i / 50 % 3) * 0.1);
+            columns.vdop.push_back(1.2);
+            columns.snrAvg.push_back(40.0 + (i % 17) * 0.25);
+            columns.satellites.push_back(uint8_t(8 + (i / 200) % 3));
+            columns.fixQuality.push_back(i < 10 ? 1 : 4);
+            columns.satOffset.push_back(0);
+        }
+        return columns;
+    }
+}
+
+class TestEpochCodec : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_roundTrip()
+    {
+        const EpochColumns input = makeSeries(1000);
+        const std::vector<uint8_t> encoded = EpochCodec::encode(input);
+
+        EpochColumns output;
+        EpochCodec::decode(encoded.data(), encoded.size(), output);
+        QCOMPARE(output.size(), input.size());
+        QCOMPARE(output.satOffset.size(), input.size() + 1);
+
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            QCOMPARE(output.timeMs[i], input.timeMs[i]);
+            QVERIFY(qAbs(output.latitude[i] - input.latitude[i]) <= 0.51e-7);
+            QVERIFY(qAbs(output.longitude[i] - input.longitude[i]) <= 0.51e-7);
+            QVERIFY(qAbs(output.altitude[i] - input.altitude[i]) <= 0.51e-3);
+            QVERIFY(qAbs(output.hdop[i] - input.hdop[i]) < 1e-9);
+            QCOMPARE(output.satellites[i], input.satellites[i]);
+            QCOMPARE(output.fixQuality[i], input.fixQuality[i]);
+        }
+    }
+
+    void test_compressionRatio()
+    {
+        const EpochColumns input = makeSeries(10000);
+        const std::vector<uint8_t> encoded = EpochCodec::encode(input);
+
+        // Fixed-width columns: 7 x 8 bytes + 2 x 1 byte per epoch
+        const size_t raw = input.size() * 58;
+        QVERIFY2(encoded.size() * 8 < raw,
+                 qPrintable(QString("encoded %1 bytes for %2 raw").arg(encoded.size()).arg(raw)));
+    }
+
+    void test_extremeDeltas()
+    {
+        EpochColumns input = makeSeries(300);
+        for (size_t i = 0; i < input.size(); ++i)
+            input.timeMs[i] = (i % 2) ? (int64_t(1) << 61) : -(int64_t(1) << 61);
+
+        const std::vector<uint8_t> encoded = EpochCodec::encode(input);
+        EpochColumns output;
+        EpochCodec::decode(encoded.data(), encoded.size(), output);
+        for (size_t i = 0; i < input.size(); ++i)
+            QCOMPARE(output.timeMs[i], input.timeMs[i]);
+    }
+
+    void test_truncatedStream()
+    {
+        const std::vector<uint8_t> encoded = EpochCodec::encode(makeSeries(1000));
+        EpochColumns output;
+        QVERIFY_EXCEPTION_THROWN(EpochCodec::decode(encoded.data(), encoded.size() / 2, output), ArchiveError);
+        QCOMPARE(output.size(), size_t(0));
+    }
+
+    void test_nonFiniteRejected()
+    {
+        EpochColumns input = makeSeries(10);
+        input.latitude[3] = -qInf();
+        QVERIFY_EXCEPTION_THROWN(EpochCodec::encode(input), ArchiveError);
+    }
+};
+
+QTEST_MAIN(TestEpochCodec)
+#include "test_epoch_codec.moc"
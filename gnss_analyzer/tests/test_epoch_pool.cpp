@@ -0,0 +1,199 @@
+#include <QtTest>
+#include "EpochPool.hpp"
+#include "EpochRecord.hpp"
+#include "NMEAStreamParser.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const char *const kEpoch[] = {
+        "$GPGSV,3,1,10,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A\r\n",
+        "$GPGSV,3,2,10,17,10,020,,25,05,330,30,04,41,151,39,31,07,100,*4B\r\n",
+        "$GPGSV,3,3,10,05,20,200,25,33,,,*4B\r\n",
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n",
+    };
+
+    using Pool = EpochPool<EpochRecord>;
+
+    // Bounded hand-off queue between the parser and its consumers
+    class EpochQueue {
+    public:
+        explicit EpochQueue(size_t capacity) : m_capacity(capacity) {}
+
+        void push(Pool::Handle epoch)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this] { return m_items.size() < m_capacity; });
+            m_items.push_back(std::move(epoch));
+            m_notEmpty.notify_one();
+        }
+
+        // Empty handle once closed and drained
+        Pool::Handle pop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this] { return !m_items.empty() || m_closed; });
+            if (m_items.empty())
+                return {};
+            Pool::Handle epoch = std::move(m_items.front());
+            m_items.pop_front();
+            m_notFull.notify_one();
+            return epoch;
+        }
+
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::deque<Pool::Handle> m_items;
+        size_t m_capacity;
+        bool m_closed = false;
+    };
+}
+
+class TestEpochPool : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_recycle()
+    {
+        Pool pool;
+        EpochRecord *first = nullptr;
+        {
+            Pool::Handle epoch = pool.acquire();
+            QVERIFY(epoch);
+            epoch->satellitesInView.resize(12);
+            first = epoch.get();
+        }
+        QCOMPARE(pool.available(), size_t(1));
+
+        // Same epoch back, capacity kept
+        Pool::Handle again = pool.acquire();
+        QCOMPARE(again.get(), first);
+        QVERIFY(again->satellitesInView.capacity() >= 12);
+        QCOMPARE(pool.allocated(), size_t(1));
+        QCOMPARE(pool.reused(), uint64_t(1));
+
+        Pool::Handle moved = std::move(again);
+        QVERIFY(!again);
+        QCOMPARE(moved.get(), first);
+        moved.reset();
+        QVERIFY(!moved);
+        QCOMPARE(pool.available(), size_t(1));
+
+        Pool prefilled(4);
+        QCOMPARE(prefilled.available(), size_t(4));
+        Pool::Handle a = prefilled.acquire();
+        Pool::Handle b = prefilled.acquire();
+        QVERIFY(a.get() != b.get());
+        QCOMPARE(prefilled.allocated(), size_t(4));
+    }
+
+    void test_crossThreadRelease()
+    {
+        constexpr int kConsumers = 4;
+        constexpr int kEpochs = 20000;
+        constexpr size_t kQueueDepth = 8;
+
+        Pool pool;
+        EpochQueue queue(kQueueDepth);
+        std::atomic<int> seen{0};
+        std::atomic<int> wrongSatellites{0};
+        std::vector<std::thread> consumers;
+        for (int i = 0; i < kConsumers; ++i)
+            consumers.emplace_back([&] {
+                while (Pool::Handle epoch = queue.pop())
+                {
+                    if (epoch->satellitesInView.size() != 9)
+                        ++wrongSatellites;
+                    ++seen;
+                }
+            });
+
+        NMEAStreamParser parser;
+        EpochRecord record;
+        for (int n = 0; n < kEpochs; )
+            for (const char *line : kEpoch)
+                if (parser.parse(line, record) == NMEAStreamParser::Update::Fix)
+                {
+                    Pool::Handle epoch = pool.acquire();
+                    *epoch = record;
+                    queue.push(std::move(epoch));
+                    ++n;
+                }
+        queue.close();
+        for (std::thread &consumer : consumers)
+            consumer.join();
+
+        QCOMPARE(seen.load(), kEpochs);
+        QCOMPARE(wrongSatellites.load(), 0);
+
+        // Queue plus one epoch per consumer plus the one being filled
+        QVERIFY(pool.allocated() <= kQueueDepth + kConsumers + 1);
+        QCOMPARE(pool.reused() + pool.allocated(), uint64_t(kEpochs));
+        QCOMPARE(pool.available(), pool.allocated());
+    }
+
+    void test_handlesOutlivePool()
+    {
+        std::vector<Pool::Handle> kept;
+        {
+            Pool pool(2);
+            kept.push_back(pool.acquire());
+            kept.push_back(pool.acquire());
+            kept.push_back(pool.acquire());
+            kept[0].reset();
+            for (Pool::Handle &epoch : kept)
+                if (epoch)
+                    epoch->satellitesInView.resize(12);
+        }
+
+        // The epochs stay valid; the last one dropped frees them (checked by ASan/LSan builds)
+        QVERIFY(!kept[0]);
+        QCOMPARE(kept[1]->satellitesInView.size(), size_t(12));
+        std::thread consumer([epoch = std::move(kept[2])]() mutable { epoch.reset(); });
+        consumer.join();
+        kept.clear();
+    }
+
+    void bench_handOff()
+    {
+        Pool pool;
+        EpochQueue queue(64);
+        std::thread consumer([&] {
+            while (Pool::Handle epoch = queue.pop())
+                ;
+        });
+        NMEAStreamParser parser;
+        EpochRecord record;
+        QBENCHMARK {
+            for (int n = 0; n < 10000; )
+                for (const char *line : kEpoch)
+                    if (parser.parse(line, record) == NMEAStreamParser::Update::Fix)
+                    {
+                        Pool::Handle epoch = pool.acquire();
+                        *epoch = record;
+                        queue.push(std::move(epoch));
+                        ++n;
+                    }
+        }
+        queue.close();
+        consumer.join();
+        qDebug() << "epochs allocated:" << pool.allocated() << "reused:" << pool.reused();
+    }
+};
+
+QTEST_MAIN(TestEpochPool)
+#include "test_epoch_pool.moc"
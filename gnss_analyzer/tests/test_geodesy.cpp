@@ -0,0 +1,252 @@
+#include <QtTest>
+#include "Geodesy.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+    struct LLAColumns {
+        std::vector<double> lat, lon, alt;
+    };
+
+    // Uniform over the globe, by default from below sea level to 20 km, plus poles and the antimeridian
+    LLAColumns makePoints(size_t count, double minAlt = -500.0, double maxAlt = 20000.0)
+    {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> lat(-90.0, 90.0);
+        std::uniform_real_distribution<double> lon(-180.0, 180.0);
+        std::uniform_real_distribution<double> alt(minAlt, maxAlt);
+
+        LLAColumns p;
+        for (size_t i = 0; i < count; ++i)
+        {
+            p.lat.push_back(lat(rng));
+            p.lon.push_back(lon(rng));
+            p.alt.push_back(alt(rng));
+        }
+        p.lat[0] = 90.0;
+        p.lat[1] = -90.0;
+        p.lon[2] = 180.0;
+        p.lon[3] = -180.0;
+        p.lat[4] = 0.0;
+        p.lon[4] = 0.0;
+        p.alt[5] = minAlt;
+        return p;
+    }
+
+    double lonDifference(double a, double b)
+    {
+        const double d = std::fabs(a - b);
+        return std::min(d, 360.0 - d);
+    }
+}
+
+class TestGeodesy : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_sinCosAccuracy()
+    {
+        std::vector<double> radians;
+        for (int i = -200000; i <= 200000; ++i)
+            radians.push_back(i * 1e-4 * M_PI);
+        radians.push_back(1e5);
+        radians.push_back(-1e5);
+
+        std::vector<double> s(radians.size()), c(radians.size());
+        Geodesy::sinCos(radians.data(), radians.size(), s.data(), c.data());
+        for (size_t i = 0; i < radians.size(); ++i)
+        {
+            QVERIFY(std::fabs(s[i] - std::sin(radians[i])) < 1e-15);
+            QVERIFY(std::fabs(c[i] - std::cos(radians[i])) < 1e-15);
+        }
+    }
+
+    void test_batchMatchesScalar()
+    {
+        const LLAColumns p = makePoints(100000);
+        const size_t n = p.lat.size();
+        std::vector<double> x(n), y(n), z(n);
+        Geodesy::llaToEcef(p.lat.data(), p.lon.data(), p.alt.data(), n, x.data(), y.data(), z.data());
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double rx, ry, rz;
+            Geodesy::llaToEcef(p.lat[i], p.lon[i], p.alt[i], rx, ry, rz);
+            QVERIFY(std::fabs(x[i] - rx) < 1e-6);
+            QVERIFY(std::fabs(y[i] - ry) < 1e-6);
+            QVERIFY(std::fabs(z[i] - rz) < 1e-6);
+        }
+
+        std::vector<double> lat(n), lon(n), alt(n);
+        Geodesy::ecefToLla(x.data(), y.data(), z.data(), n, lat.data(), lon.data(), alt.data());
+        for (size_t i = 0; i < n; ++i)
+        {
+            double rlat, rlon, ralt;
+            Geodesy::ecefToLla(x[i], y[i], z[i], rlat, rlon, ralt);
+            QVERIFY(std::fabs(lat[i] - rlat) < 1e-9);
+            QVERIFY(std::fabs(alt[i] - ralt) < 1e-4);
+            if (std::fabs(rlat) < 90.0 - 1e-9)
+                QVERIFY(lonDifference(lon[i], rlon) < 1e-9);
+        }
+    }
+
+    void test_roundTrip()
+    {
+        const LLAColumns p = makePoints(100000);
+        const size_t n = p.lat.size();
+        std::vector<double> x(n), y(n), z(n), lat(n), lon(n), alt(n);
+        Geodesy::llaToEcef(p.lat.data(), p.lon.data(), p.alt.data(), n, x.data(), y.data(), z.data());
+        Geodesy::ecefToLla(x.data(), y.data(), z.data(), n, lat.data(), lon.data(), alt.data());
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            QVERIFY(std::fabs(lat[i] - p.lat[i]) < 1e-9);
+            QVERIFY(std::fabs(alt[i] - p.alt[i]) < 1e-3);
+            if (std::fabs(p.lat[i]) < 90.0 - 1e-9)
+                QVERIFY(lonDifference(lon[i], p.lon[i]) < 1e-9);
+        }
+    }
+
+    // The bound documented in Geodesy.hpp, from -10 km to geostationary altitude
+    void test_highAltitude()
+    {
+        for (double altitude : {-10000.0, 100000.0, 1000000.0, 36000000.0})
+        {
+            const LLAColumns p = makePoints(50000, altitude, altitude);
+            const size_t n = p.lat.size();
+            std::vector<double> x(n), y(n), z(n), lat(n), lon(n), alt(n);
+            Geodesy::llaToEcef(p.lat.data(), p.lon.data(), p.alt.data(), n, x.data(), y.data(), z.data());
+            Geodesy::ecefToLla(x.data(), y.data(), z.data(), n, lat.data(), lon.data(), alt.data());
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                double rlat, rlon, ralt;
+                Geodesy::ecefToLla(x[i], y[i], z[i], rlat, rlon, ralt);
+                QVERIFY(std::fabs(lat[i] - rlat) < 1e-12);
+                QVERIFY(std::fabs(alt[i] - ralt) < 1e-6);
+                QVERIFY(std::fabs(lat[i] - p.lat[i]) < 1e-12);
+                QVERIFY(std::fabs(alt[i] - altitude) < 1e-6);
+            }
+        }
+    }
+
+    void test_enuFrame()
+    {
+        const Geodesy::ENUFrame frame = Geodesy::makeENUFrame(45.0, 5.0, 200.0);
+
+        // 1e-5 deg north at 45 deg is ~1.1114 m (meridian radius of curvature)
+        const double lat[] = {45.0, 45.00001, 45.0, 45.0};
+        const double lon[] = {5.0, 5.0, 5.00001, 5.0};
+        const double alt[] = {200.0, 200.0, 200.0, 210.0};
+        double e[4], n[4], u[4];
+        Geodesy::llaToEnu(frame, lat, lon, alt, 4, e, n, u);
+
+        QVERIFY(std::fabs(e[0]) < 1e-6 && std::fabs(n[0]) < 1e-6 && std::fabs(u[0]) < 1e-6);
+        QVERIFY(std::fabs(e[1]) < 1e-6);
+        QVERIFY(std::fabs(n[1] - 1.1114) < 1e-4);
+        QVERIFY(std::fabs(e[2] - 0.78849) < 1e-4);
+        QVERIFY(std::fabs(n[3]) < 1e-6);
+        QVERIFY(std::fabs(u[3] - 10.0) < 1e-6);
+
+        double rlat[4], rlon[4], ralt[4];
+        Geodesy::enuToLla(frame, e, n, u, 4, rlat, rlon, ralt);
+        for (int i = 0; i < 4; ++i)
+        {
+            QVERIFY(std::fabs(rlat[i] - lat[i]) < 1e-9);
+            QVERIFY(std::fabs(rlon[i] - lon[i]) < 1e-9);
+            QVERIFY(std::fabs(ralt[i] - alt[i]) < 1e-3);
+        }
+    }
+
+    void test_earthCenter()
+    {
+        const double zero[] = {0.0};
+        double lat, lon, alt;
+        Geodesy::ecefToLla(zero, zero, zero, 1, &lat, &lon, &alt);
+        QVERIFY(std::isfinite(lat) && std::isfinite(lon) && std::isfinite(alt));
+    }
+
+    void test_polesAndZeroX()
+    {
+        // Exactly on the axes: x == 0 (lon +-90), the poles (lat +-90), y == 0 with x < 0 (lon 180)
+        const double x[] = {0.0, 0.0, 0.0, 0.0, -6378137.0};
+        const double y[] = {6378137.0, -6378137.0, 0.0, 0.0, 0.0};
+        const double z[] = {0.0, 0.0, 6356752.314245, -6356752.314245, 0.0};
+        double lat[5], lon[5], alt[5];
+        Geodesy::ecefToLla(x, y, z, 5, lat, lon, alt);
+        for (int i = 0; i < 5; ++i)
+        {
+            double rlat, rlon, ralt;
+            Geodesy::ecefToLla(x[i], y[i], z[i], rlat, rlon, ralt);
+            QVERIFY(std::isfinite(lat[i]) && std::isfinite(lon[i]) && std::isfinite(alt[i]));
+            QVERIFY(std::fabs(lat[i] - rlat) < 1e-9);
+            QVERIFY(std::fabs(alt[i] - ralt) < 1e-4);
+            if (std::fabs(rlat) < 90.0 - 1e-9)
+                QVERIFY(lonDifference(lon[i], rlon) < 1e-9);
+        }
+        QCOMPARE(lon[0], 90.0);
+        QCOMPARE(lon[1], -90.0);
+        QCOMPARE(lat[2], 90.0);
+        QCOMPARE(lat[3], -90.0);
+        QCOMPARE(lon[4], 180.0);
+
+        // Due north of the ENU origin at the pole
+        const Geodesy::ENUFrame frame = Geodesy::makeENUFrame(89.9999, 0.0, 0.0);
+        const double e[] = {0.0};
+        const double n[] = {20.0};
+        const double u[] = {0.0};
+        double rlat, rlon, ralt;
+        Geodesy::enuToLla(frame, e, n, u, 1, &rlat, &rlon, &ralt);
+        QVERIFY(std::isfinite(rlat) && std::isfinite(rlon));
+    }
+
+    void bench_llaToEcefScalar()
+    {
+        const LLAColumns p = makePoints(1000000);
+        const size_t n = p.lat.size();
+        std::vector<double> x(n), y(n), z(n);
+        QBENCHMARK {
+            for (size_t i = 0; i < n; ++i)
+                Geodesy::llaToEcef(p.lat[i], p.lon[i], p.alt[i], x[i], y[i], z[i]);
+        }
+    }
+
+    void bench_llaToEcefBatch()
+    {
+        const LLAColumns p = makePoints(1000000);
+        const size_t n = p.lat.size();
+        std::vector<double> x(n), y(n), z(n);
+        QBENCHMARK {
+            Geodesy::llaToEcef(p.lat.data(), p.lon.data(), p.alt.data(), n, x.data(), y.data(), z.data());
+        }
+    }
+
+    void bench_ecefToLlaScalar()
+    {
+        const LLAColumns p = makePoints(1000000);
+        const size_t n = p.lat.size();
+        std::vector<double> x(n), y(n), z(n), lat(n), lon(n), alt(n);
+        Geodesy::llaToEcef(p.lat.data(), p.lon.data(), p.alt.data(), n, x.data(), y.data(), z.data());
+        QBENCHMARK {
+            for (size_t i = 0; i < n; ++i)
+                Geodesy::ecefToLla(x[i], y[i], z[i], lat[i], lon[i], alt[i]);
+        }
+    }
+
+    void bench_ecefToLlaBatch()
+    {
+        const LLAColumns p = makePoints(1000000);
+        const size_t n = p.lat.size();
+        std::vector<double> x(n), y(n), z(n), lat(n), lon(n), alt(n);
+        Geodesy::llaToEcef(p.lat.data(), p.lon.data(), p.alt.data(), n, x.data(), y.data(), z.data());
+        QBENCHMARK {
+            Geodesy::ecefToLla(x.data(), y.data(), z.data(), n, lat.data(), lon.data(), alt.data());
+        }
+    }
+};
+
+QTEST_MAIN(TestGeodesy)
+#include "test_geodesy.moc"
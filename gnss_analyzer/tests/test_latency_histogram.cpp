@@ -0,0 +1,100 @@
+#include <QtTest>
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class TestLatencyHistogram : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_buckets()
+    {
+        // Exact below 128, then contiguous buckets at most 1/64 of their values wide
+        size_t previous = 0;
+        for (uint64_t value = 0; value < (uint64_t(1) << 20); ++value)
+        {
+            const size_t index = LatencyHistogram::bucketIndex(value);
+            QVERIFY(index == previous || index == previous + 1);
+            QVERIFY(LatencyHistogram::bucketUpperBound(index) >= value);
+            if (value < 128)
+                QCOMPARE(index, size_t(value));
+            previous = index;
+        }
+        for (size_t index = 128; index < LatencyHistogram::kBuckets; ++index)
+        {
+            const uint64_t low = LatencyHistogram::bucketUpperBound(index - 1) + 1;
+            const uint64_t high = LatencyHistogram::bucketUpperBound(index);
+            QCOMPARE(LatencyHistogram::bucketIndex(low), index);
+            QCOMPARE(LatencyHistogram::bucketIndex(high), index);
+            QVERIFY((high - low + 1) * 64 <= low);
+        }
+        QCOMPARE(LatencyHistogram::bucketIndex(uint64_t(1) << 50), LatencyHistogram::kBuckets - 1);
+    }
+
+    void test_percentiles()
+    {
+        std::mt19937_64 random(7);
+        std::lognormal_distribution<double> distribution(11.0, 1.0);     // around 60 us, long tail
+        std::vector<uint64_t> values(200000);
+        LatencyHistogram histogram;
+        for (uint64_t &value : values)
+        {
+            value = uint64_t(distribution(random));
+            histogram.record(value);
+        }
+        std::sort(values.begin(), values.end());
+
+        QCOMPARE(histogram.count(), uint64_t(values.size()));
+        QCOMPARE(histogram.min(), values.front());
+        QCOMPARE(histogram.max(), values.back());
+        QCOMPARE(histogram.percentile(100.0), values.back());
+        for (double p : {50.0, 90.0, 99.0, 99.9, 99.99})
+        {
+            const uint64_t exact = values[size_t(std::ceil(p / 100.0 * values.size())) - 1];
+            const uint64_t estimate = histogram.percentile(p);
+            QVERIFY(estimate >= exact);
+            QVERIFY(double(estimate - exact) <= double(exact) / 64.0);
+        }
+    }
+
+    void test_mergeAndReset()
+    {
+        LatencyHistogram a;
+        LatencyHistogram b;
+        QCOMPARE(a.percentile(99.0), uint64_t(0));
+        for (uint64_t i = 1; i <= 99; ++i)
+            a.record(1000);
+        b.record(5000000);
+        b.recordSpan(10, 5);
+        a.merge(b);
+        QCOMPARE(a.count(), uint64_t(101));
+        QCOMPARE(a.min(), uint64_t(0));
+        QCOMPARE(a.max(), uint64_t(5000000));
+        QVERIFY(a.percentile(99.0) >= 1000 && a.percentile(99.0) < 1016);
+        QCOMPARE(a.percentile(99.9), uint64_t(5000000));
+        a.reset();
+        QCOMPARE(a.count(), uint64_t(0));
+        QCOMPARE(a.max(), uint64_t(0));
+    }
+
+    void bench_record()
+    {
+        // Spread over the buckets; the listener adds one clock read per epoch
+        LatencyHistogram histogram;
+        uint64_t state = 1;
+        QBENCHMARK {
+            for (int i = 0; i < 1000000; ++i)
+            {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                histogram.record(state >> 40);
+            }
+        }
+        QVERIFY(histogram.count() >= 1000000);
+    }
+};
+
+QTEST_MAIN(TestLatencyHistogram)
+#include "test_latency_histogram.moc"
@@ -2,21 +2,50 @@
 #include "NMEAParser.hpp"
 #include "NMEAException.hpp"
 
-class TestNMEAParserGGA : public QObject {
+class TestNMEAParserGSV : public QObject {
     Q_OBJECT
 
 private slots:
-    void test_parseGSV_data()
+
+    void test_parseGSV_sequence()
     {
-        
+        GNSSData data;
+        NMEAParser::parseLine("$GPGSV,2,1,06,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A", data);
+
+        // Nothing is published until the last message of the sequence
+        QVERIFY(data.satMap.isEmpty());
+        QCOMPARE(data.snrAvg, 0.0);
+
+        NMEAParser::parseLine("$GPGSV,2,2,06,17,10,020,,25,05,330,30*4B", data);
+        QCOMPARE(data.satMap.size(), 6);
+        QCOMPARE(data.satMap[2].elevation, 65.0);
+        QCOMPARE(data.satMap[2].azimuth, 290.0);
+        QCOMPARE(data.satMap[12].snr, 36.0);      // checksum stripped from the last field
+        QCOMPARE(data.satMap[25].snr, 30.0);
+        QVERIFY(data.satMap[17].snr == -qInf());  // not tracked
+
+        // Untracked satellites do not count towards the average
+        QCOMPARE(data.snrAvg, (42.0 + 38.0 + 44.0 + 36.0 + 30.0) / 5.0);
     }
 
-    void test_parseGSV()
+    void test_parseGSV_replacesPreviousSequence()
     {
-        qWarning() << "TODO";
+        GNSSData data;
+        NMEAParser::parseLine("$GPGSV,1,1,02,02,65,290,42,04,40,150,38*7A", data);
+        QCOMPARE(data.satMap.size(), 2);
+
+        NMEAParser::parseLine("$GPGSV,1,1,01,09,55,050,44*7A", data);
+        QCOMPARE(data.satMap.size(), 1);
+        QVERIFY(data.satMap.contains(9));
+        QCOMPARE(data.snrAvg, 44.0);
     }
 
+    void test_parseGSV_tooShort()
+    {
+        GNSSData data;
+        QVERIFY_EXCEPTION_THROWN(NMEAParser::parseLine("$GPGSV,1,1", data), ParsingError);
+    }
 };
 
-QTEST_MAIN(TestNMEAParserGGA);
-#include "test_nmea_gsv.moc"
\ No newline at end of file
+QTEST_MAIN(TestNMEAParserGSV);
+#include "test_nmea_gsv.moc"
@@ -0,0 +1,315 @@
+#include <QtTest>
+#include "NMEAListener.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    const std::string kEpoch =
+        "$GPGSV,2,1,06,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A\r\n"
+        "$GPGSV,2,2,06,17,10,020,,25,05,330,30*4B\r\n"
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n";
+
+    const char *const kOtherGSV[] = {
+        "$GPGSV,2,1,05,03,65,290,42,05,40,150,38,07,55,050,44,11,32,200,36*7A\r\n",
+        "$GPGSV,2,2,05,19,10,020,41*4B\r\n",
+    };
+
+    int connectedSocket(int type, uint16_t port)
+    {
+        const int fd = ::socket(AF_INET, type | SOCK_CLOEXEC, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void sendAll(int fd, const std::string &data)
+    {
+        for (size_t done = 0; done < data.size();)
+        {
+            const ssize_t n = ::send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+            if (n <= 0)
+                return;
+            done += static_cast<size_t>(n);
+        }
+    }
+
+    /// Poll until @p done or two seconds have passed.
+    template <typename Done>
+    bool pollUntil(Ingest::NMEAListener &listener, Done done)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            listener.poll(50);
+        }
+        return true;
+    }
+}
+
+class TestNMEAListener : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_udpReceivers()
+    {
+        std::map<uint32_t, std::vector<size_t>> satellites;
+        Ingest::NMEAListener listener([&](Ingest::NMEAListener::Receiver &receiver) {
+            satellites[receiver.id].push_back(receiver.context.epoch().satellitesInView.size());
+        });
+        const uint16_t port = listener.listenUdp("127.0.0.1", 0);
+        QVERIFY(port != 0);
+
+        // Two receivers interleave their GSV sequences; each keeps its own
+        const int a = connectedSocket(SOCK_DGRAM, port);
+        const int b = connectedSocket(SOCK_DGRAM, port);
+        QVERIFY(a >= 0 && b >= 0);
+        sendAll(a, kEpoch.substr(0, kEpoch.find("$GPGSV,2,2")));
+        sendAll(b, kOtherGSV[0]);
+        sendAll(a, kEpoch.substr(kEpoch.find("$GPGSV,2,2")));
+        sendAll(b, std::string(kOtherGSV[1]) + "garbage\n$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47");
+
+        QVERIFY(pollUntil(listener, [&] { return satellites.size() == 2 && satellites[1].size() == 1; }));
+        QCOMPARE(listener.receiverCount(), size_t(2));
+        QCOMPARE(satellites[0], std::vector<size_t>{6});
+        QCOMPARE(satellites[1], std::vector<size_t>{5});
+        QCOMPARE(listener.receiver(1).context.rejectedLines(), uint64_t(0));
+        QCOMPARE(listener.receiver(1).sentences, uint64_t(4));
+        QCOMPARE(listener.datagrams(), uint64_t(4));
+        if (ParseStats::kEnabled)
+            QCOMPARE(listener.parseCounters().sentences(), listener.sentences());
+        QVERIFY(!listener.receiver(0).tcp);
+        QVERIFY(listener.receiver(0).peer.rfind("127.0.0.1:", 0) == 0);
+        ::close(a);
+        ::close(b);
+    }
+
+    void test_tcpConnections()
+    {
+        size_t epochs = 0;
+        Ingest::NMEAListener listener([&](Ingest::NMEAListener::Receiver &receiver) {
+            ++epochs;
+            QCOMPARE(receiver.context.epoch().satellitesInView.size(), size_t(6));
+        });
+        const uint16_t port = listener.listenTcp("127.0.0.1", 0);
+
+        // Lines split across writes, an invalid GGA, no final newline
+        const int fd = connectedSocket(SOCK_STREAM, port);
+        QVERIFY(fd >= 0);
+        const std::string log = kEpoch + kEpoch + "$GPGGA,1235,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\n" + kEpoch;
+        sendAll(fd, log.substr(0, 50));
+        QVERIFY(pollUntil(listener, [&] { return listener.receiverCount() == 1; }));
+        sendAll(fd, log.substr(50));
+        sendAll(fd, "$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47");
+        QVERIFY(pollUntil(listener, [&] { return epochs == 3; }));
+        QVERIFY(listener.receiver(0).connected);
+
+        ::close(fd);
+        QVERIFY(pollUntil(listener, [&] { return !listener.receiver(0).connected; }));
+        QCOMPARE(epochs, size_t(4));
+        QCOMPARE(listener.receiver(0).context.rejectedLines(), uint64_t(1));
+        QVERIFY(listener.receiver(0).tcp);
+    }
+
+    void test_publishedEpochs()
+    {
+        std::vector<Ingest::NMEAListener::EpochHandle> published;
+        {
+            Ingest::NMEAListener listener([&](Ingest::NMEAListener::Receiver &receiver) {
+                published.push_back(listener.publish(receiver));
+                if (published.size() > 2)
+                    published.erase(published.begin());        // dropped back into the pool
+            });
+            const uint16_t port = listener.listenUdp("127.0.0.1", 0);
+            const int fd = connectedSocket(SOCK_DGRAM, port);
+            QVERIFY(fd >= 0);
+            for (int i = 0; i < 5; ++i)
+                sendAll(fd, kEpoch);
+            QVERIFY(pollUntil(listener, [&] { return listener.receiverCount() == 1 && listener.receiver(0).sentences == 15; }));
+            QCOMPARE(listener.epochPool().allocated(), size_t(3));
+            QCOMPARE(listener.epochPool().reused(), uint64_t(2));
+            ::close(fd);
+        }
+
+        // The copies do not point into the receiver's arenas and outlive the listener
+        QCOMPARE(published.size(), size_t(2));
+        std::thread consumer([&] {
+            for (const Ingest::NMEAListener::EpochHandle &epoch : published)
+            {
+                QCOMPARE(epoch->satellitesInView.size(), size_t(6));
+                QCOMPARE(epoch->fixQuality, uint8_t(1));
+            }
+            published.clear();
+        });
+        consumer.join();
+    }
+
+    void test_receiverLimit()
+    {
+        NMEAListenerConfig config;
+        config.maxReceivers = 2;
+        Ingest::NMEAListener listener(nullptr, config);
+        const uint16_t udpPort = listener.listenUdp("127.0.0.1", 0);
+        const uint16_t tcpPort = listener.listenTcp("127.0.0.1", 0);
+
+        // A third UDP peer retires the least recently active one
+        int udp[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            udp[i] = connectedSocket(SOCK_DGRAM, udpPort);
+            QVERIFY(udp[i] >= 0);
+            sendAll(udp[i], kEpoch);
+            QVERIFY(pollUntil(listener, [&] { return listener.datagrams() == uint64_t(i + 1); }));
+        }
+        QCOMPARE(listener.receiverCount(), size_t(2));
+        QCOMPARE(listener.retiredReceivers(), uint64_t(1));
+        if (ParseStats::kEnabled)
+            QCOMPARE(listener.parseCounters()[ParseCounter::GGASentences], uint64_t(3));
+        QVERIFY_EXCEPTION_THROWN(listener.receiver(0), std::out_of_range);
+        QCOMPARE(listener.receiver(2).sentences, uint64_t(3));
+
+        // Connected TCP receivers are never retired: past two, peers are refused
+        const int a = connectedSocket(SOCK_STREAM, tcpPort);
+        const int b = connectedSocket(SOCK_STREAM, tcpPort);
+        QVERIFY(a >= 0 && b >= 0);
+        QVERIFY(pollUntil(listener, [&] { return listener.retiredReceivers() == 3; }));
+        QCOMPARE(listener.receiverCount(), size_t(2));
+        sendAll(udp[0], kEpoch);
+        QVERIFY(pollUntil(listener, [&] { return listener.refusedPeers() == 1; }));
+        QCOMPARE(listener.receiverCount(), size_t(2));
+
+        // A closed connection leaves its receiver until retireIdle()
+        ::close(a);
+        QVERIFY(pollUntil(listener, [&] { return !listener.receiver(3).connected; }));
+        QCOMPARE(listener.retireIdle(60000), size_t(1));
+        QCOMPARE(listener.receiverCount(), size_t(1));
+        QVERIFY(listener.receiver(4).connected);
+
+        ::close(b);
+        for (int fd : udp)
+            ::close(fd);
+    }
+
+    void test_epochLatency()
+    {
+        Ingest::NMEAListener listener(nullptr);
+        const uint16_t port = listener.listenTcp("127.0.0.1", 0);
+        const int fd = connectedSocket(SOCK_STREAM, port);
+        QVERIFY(fd >= 0);
+
+        // The epoch's first line arrives in two parts 30 ms apart: timed from the first part
+        sendAll(fd, kEpoch.substr(0, 20));
+        QVERIFY(pollUntil(listener, [&] { return listener.receiverCount() == 1 && listener.receiver(0).bytes == 20; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        sendAll(fd, kEpoch.substr(20));
+        QVERIFY(pollUntil(listener, [&] { return listener.receiver(0).latency.count() == 1; }));
+        const LatencyHistogram &latency = listener.receiver(0).latency;
+        QVERIFY(latency.min() >= 30000000);
+        QVERIFY(latency.percentile(99.9) >= 30000000);
+
+        sendAll(fd, kEpoch);
+        QVERIFY(pollUntil(listener, [&] { return latency.count() == 2; }));
+        QVERIFY(latency.min() < 30000000);
+        ::close(fd);
+    }
+
+    void test_stopFromOtherThread()
+    {
+        Ingest::NMEAListener listener(nullptr);
+        listener.listenUdp("::1", 0);
+        std::thread stopper([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            listener.stop();
+        });
+        listener.run();
+        stopper.join();
+    }
+
+    void test_invalidAddress()
+    {
+        Ingest::NMEAListener listener(nullptr);
+        QVERIFY_EXCEPTION_THROWN(listener.listenUdp("not an address", 0), std::system_error);
+    }
+
+    void bench_udpSentences()
+    {
+        // Loopback UDP at full speed from 4 senders, one epoch per datagram
+        constexpr size_t kSenders = 4;
+        constexpr size_t kDatagrams = 50000;
+        size_t epochs = 0;
+        Ingest::NMEAListener listener([&](Ingest::NMEAListener::Receiver &) { ++epochs; });
+        const uint16_t port = listener.listenUdp("127.0.0.1", 0);
+
+        QBENCHMARK_ONCE {
+            std::atomic<size_t> running{kSenders};
+            std::vector<std::thread> senders;
+            for (size_t s = 0; s < kSenders; ++s)
+                senders.emplace_back([port, &running] {
+                    const int fd = connectedSocket(SOCK_DGRAM, port);
+                    for (size_t i = 0; i < kDatagrams; ++i)
+                        sendAll(fd, kEpoch);
+                    ::close(fd);
+                    --running;
+                });
+
+            // Until the senders are done and the socket is drained; datagrams
+            // the socket buffer could not hold are lost, not waited for
+            const auto start = std::chrono::steady_clock::now();
+            while (running > 0 || listener.poll(10) > 0)
+                listener.poll(10);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            for (std::thread &sender : senders)
+                sender.join();
+            qDebug() << listener.sentences() / seconds << "sentences/s," << listener.datagrams() << "of"
+                     << kSenders * kDatagrams << "datagrams in" << listener.receiveCalls() << "recvmmsg calls";
+        }
+        QVERIFY(epochs > 0);
+    }
+
+    void bench_tcpSentences()
+    {
+        constexpr size_t kEpochs = 200000;
+        Ingest::NMEAListener listener(nullptr);
+        const uint16_t port = listener.listenTcp("127.0.0.1", 0);
+        std::string log;
+        for (size_t i = 0; i < 1000; ++i)
+            log += kEpoch;
+
+        QBENCHMARK_ONCE {
+            std::thread sender([port, &log] {
+                const int fd = connectedSocket(SOCK_STREAM, port);
+                for (size_t i = 0; i < kEpochs / 1000; ++i)
+                    sendAll(fd, log);
+                ::close(fd);
+            });
+            const auto start = std::chrono::steady_clock::now();
+            pollUntil(listener, [&] { return listener.sentences() >= 3 * kEpochs; });
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            sender.join();
+            qDebug() << listener.sentences() / seconds << "sentences/s";
+        }
+        QCOMPARE(listener.sentences(), uint64_t(3 * kEpochs));
+    }
+};
+
+QTEST_MAIN(TestNMEAListener)
+#include "test_nmea_listener.moc"
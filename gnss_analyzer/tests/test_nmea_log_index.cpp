@@ -0,0 +1,111 @@
+#include <QtTest>
+#include "NMEALogIndex.hpp"
+#include "NMEAParser.hpp"
+
+class TestNMEALogIndex : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_log = m_dir.filePath("receiver.nmea").toStdString();
+
+        // Two hours at 1 Hz starting 23:00:00, so the log crosses midnight.
+        // The altitude encodes the epoch number.
+        QFile file(QString::fromStdString(m_log));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QTextStream out(&file);
+        for (int i = 0; i < 7200; ++i)
+        {
+            const int t = (23 * 3600 + i) % 86400;
+            out << "$GPGSV,1,1,02,05,40,100,42,12,30,200,38*00\r\n";
+            out << QString("$GPGGA,%1%2%3.00,4807.038,N,01131.000,E,1,08,0.9,%4.0,M,,*47\r\n")
+                       .arg(t / 3600, 2, 10, QChar('0'))
+                       .arg(t / 60 % 60, 2, 10, QChar('0'))
+                       .arg(t % 60, 2, 10, QChar('0'))
+                       .arg(i % 1000);
+            if (i == 4206)
+                out << "$GPGGA,garbage\r\n";
+        }
+    }
+
+    void test_build()
+    {
+        const NMEALogIndex index = NMEALogIndex::build(m_log, 60000);
+        QCOMPARE(index.entries().size(), size_t(120));
+        QCOMPARE(index.entries().front().timeMs, int64_t(23 * 3600 * 1000));
+        // Day rollover keeps the index monotonic
+        QCOMPARE(index.entries().back().timeMs, int64_t((24 * 3600 + 59 * 60) * 1000));
+        QCOMPARE(index.seek(0).offset, index.entries().front().offset);
+    }
+
+    void test_sidecar()
+    {
+        const NMEALogIndex built = NMEALogIndex::openOrBuild(m_log, 60000);
+        QVERIFY(QFile::exists(QString::fromStdString(NMEALogIndex::sidecarPath(m_log))));
+
+        const NMEALogIndex loaded = NMEALogIndex::load(NMEALogIndex::sidecarPath(m_log));
+        QCOMPARE(loaded.entries().size(), built.entries().size());
+        QCOMPARE(loaded.logSize(), built.logSize());
+        QCOMPARE(loaded.entries()[17].offset, built.entries()[17].offset);
+    }
+
+    void test_parseWindow()
+    {
+        const NMEALogIndex index = NMEALogIndex::build(m_log, 60000);
+        const int64_t from = (24 * 3600 + 10 * 60 + 5) * 1000LL;   // 00:10:05, day 2
+
+        GNSSData data;
+        QVector<int64_t> times;
+        QVector<double> altitudes;
+        const size_t epochs = NMEAParser::parseWindow(m_log, index, from, from + 5000, data,
+            [&](const GNSSData &epoch, int64_t timeMs) {
+                times.append(timeMs);
+                altitudes.append(epoch.altitude);
+            });
+
+        // The malformed GGA after 00:10:06 is skipped
+        QCOMPARE(epochs, size_t(5));
+        QCOMPARE(times.first(), from);
+        QCOMPARE(times.last(), from + 4000);
+        QCOMPARE(altitudes.first(), 205.0);
+    }
+
+    void test_outOfOrderTimestamps()
+    {
+        // 12:00:00 to 12:04:59 with a repeated GGA and one 5 s late
+        const std::string log = m_dir.filePath("jitter.nmea").toStdString();
+        QFile file(QString::fromStdString(log));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QTextStream out(&file);
+        const auto gga = [&out](int t) {
+            out << QString("$GPGGA,%1%2%3.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n")
+                       .arg(t / 3600, 2, 10, QChar('0'))
+                       .arg(t / 60 % 60, 2, 10, QChar('0'))
+                       .arg(t % 60, 2, 10, QChar('0'));
+        };
+        for (int i = 0; i < 300; ++i)
+        {
+            gga(12 * 3600 + i);
+            if (i == 100)
+                gga(12 * 3600 + i);
+            if (i == 150)
+                gga(12 * 3600 + i - 5);
+        }
+        out.flush();
+        file.close();
+
+        const NMEALogIndex index = NMEALogIndex::build(log, 60000);
+        QCOMPARE(index.entries().size(), size_t(5));
+        QCOMPARE(index.entries().back().timeMs, int64_t((12 * 3600 + 4 * 60) * 1000));
+    }
+
+private:
+    QTemporaryDir m_dir;
+    std::string m_log;
+};
+
+QTEST_MAIN(TestNMEALogIndex)
+#include "test_nmea_log_index.moc"
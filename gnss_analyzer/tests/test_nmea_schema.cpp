@@ -0,0 +1,160 @@
+#include <QtTest>
+#include "NMEASchema.hpp"
+#include "NMEASentences.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // A sentence declared only here: the schema is all a new sentence needs
+    struct VTG {
+        double course = 0.0;
+        double speedKmh = 0.0;
+        char mode = 0;
+    };
+
+    // Mode letter minus 64, so that 'A'..'Z' fit the 64-bit oneOf mask
+    bool toMode(std::string_view s, std::string_view, int &value)
+    {
+        if (s.empty())
+            return false;
+        value = s.front() - 64;
+        return true;
+    }
+
+    constexpr auto kVTG = NMEASchema::sentence(9, "VTG frame too short",
+        NMEASchema::field(1, &VTG::course, NMEASchema::toDouble)
+            .orFallback(-1.0),
+        NMEASchema::field(7, &VTG::speedKmh, NMEASchema::toDouble)
+            .range(0.0, 2000.0, "Speed out of range"),
+        NMEASchema::field(9, &VTG::mode, toMode)
+            .oneOf((uint64_t(1) << ('A' - 64)) | (uint64_t(1) << ('D' - 64)), "Unknown mode: ")
+            .orFallback('N' - 64));
+
+    // The declarations are constants the compiler sees through
+    static_assert(std::get<1>(kVTG.fields).max == 2000.0, "schema is constexpr");
+    static_assert(std::get<3>(NMEASentences::kGGA.fields).index == 6, "GGA fix quality is field 6");
+
+    std::vector<std::string_view> split(std::string_view line)
+    {
+        std::vector<std::string_view> tokens;
+        for (size_t start = 0;;)
+        {
+            const size_t comma = line.find(',', start);
+            tokens.push_back(line.substr(start, comma == std::string_view::npos ? comma : comma - start));
+            if (comma == std::string_view::npos)
+                return tokens;
+            start = comma + 1;
+        }
+    }
+}
+
+class TestNMEASchema : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_converters()
+    {
+        int i = 0;
+        double d = 0.0;
+        QVERIFY(NMEASchema::toInt(" 08", {}, i) && i == 8);
+        QVERIFY(!NMEASchema::toInt("8x", {}, i));
+        QVERIFY(!NMEASchema::toInt("", {}, i));
+        QVERIFY(NMEASchema::toDouble("545.4\r\n", {}, d) && d == 545.4);
+        QVERIFY(NMEASchema::toDoubleBeforeChecksum("36*7A", {}, d) && d == 36.0);
+        QVERIFY(!NMEASchema::toDoubleBeforeChecksum("*7A", {}, d));
+        QVERIFY(NMEASchema::toDegrees("4807.038", "N", d) && std::fabs(d - 48.1173) < 1e-12);
+        QVERIFY(NMEASchema::toDegrees("01131.000", "W", d) && std::fabs(d + 11.516666666666667) < 1e-12);
+        QVERIFY_EXCEPTION_THROWN(NMEASchema::toDegrees("4807.038", "", d), InvalidDataError);
+
+        int64_t ms = 0;
+        QVERIFY(NMEASchema::toTimeOfDay("235959.999", {}, ms) && ms == 86399999);
+        QVERIFY(NMEASchema::toTimeOfDay("000000", {}, ms) && ms == 0);
+        QVERIFY(!NMEASchema::toTimeOfDay("246000", {}, ms));
+        QVERIFY_EXCEPTION_THROWN(NMEASchema::toTimeOfDay("12351", {}, ms), InvalidDataError);
+    }
+
+    void test_declaredSentence()
+    {
+        VTG vtg;
+        std::vector<std::string_view> t = split("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,A*48");
+        QVERIFY(NMEASchema::parse<kVTG>(t.data(), t.size(), vtg));
+        QCOMPARE(vtg.course, 54.7);
+        QCOMPARE(vtg.speedKmh, 10.2);
+        QCOMPARE(int(vtg.mode), 'A' - 64);
+
+        // Field 9 is past minFields: read with a bounds check, absent here
+        t = split("$GPVTG,,T,,M,005.5,N,010.2,K");
+        QVERIFY(NMEASchema::parse<kVTG>(t.data(), t.size(), vtg));
+        QCOMPARE(vtg.course, -1.0);
+        QCOMPARE(int(vtg.mode), 'N' - 64);
+
+        t = split("$GPVTG,054.7,T,034.4,M,005.5,N,2010.2,K,A");
+        QVERIFY_EXCEPTION_THROWN(NMEASchema::parse<kVTG>(t.data(), t.size(), vtg), InvalidDataError);
+        t = split("$GPVTG,054.7,T,034.4");
+        QVERIFY_EXCEPTION_THROWN(NMEASchema::parse<kVTG>(t.data(), t.size(), vtg), ParsingError);
+    }
+
+    void test_oneOfMessage()
+    {
+        VTG vtg;
+        std::vector<std::string_view> t = split("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,D");
+        QVERIFY(NMEASchema::parse<kVTG>(t.data(), t.size(), vtg));
+        QCOMPARE(int(vtg.mode), 'D' - 64);
+        t = split("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,E");
+        try {
+            NMEASchema::parse<kVTG>(t.data(), t.size(), vtg);
+            QFAIL("no exception");
+        } catch (const InvalidDataError &e) {
+            QCOMPARE(std::string(e.what()), std::string("InvalidData: Unknown mode: 5"));
+        }
+    }
+
+    void test_gsvSatelliteBlock()
+    {
+        SatelliteRecord satellite;
+        std::vector<std::string_view> t = split("17,10,020,");
+        QVERIFY(NMEASchema::parse<NMEASentences::kGSVSatellite>(t.data(), t.size(), satellite));
+        QCOMPARE(satellite.id, 17);
+        QCOMPARE(satellite.azimuth, 20.0);
+        QVERIFY(std::isinf(satellite.snr));
+
+        // Invalid PRN: the block is skipped, not an error
+        t = split("00,10,020,30");
+        QVERIFY(!NMEASchema::parse<NMEASentences::kGSVSatellite>(t.data(), t.size(), satellite));
+        t = split(",10,020,30");
+        QVERIFY(!NMEASchema::parse<NMEASentences::kGSVSatellite>(t.data(), t.size(), satellite));
+    }
+
+    void test_ggaSchema()
+    {
+        NMEASentences::GGA gga;
+        std::vector<std::string_view> t = split("$GPGGA,123519.5,4807.038,N,01131.000,E,4,12,0.9,545.4,M,,*47");
+        QVERIFY(NMEASchema::parse<NMEASentences::kGGA>(t.data(), t.size(), gga));
+        QCOMPARE(gga.timeOfDayMs, int64_t((12 * 3600 + 35 * 60 + 19) * 1000 + 500));
+        QCOMPARE(int(gga.fixQuality), 4);
+        QCOMPARE(int(gga.satellites), 12);
+
+        t = split("$GPGGA,999999,4807.038,N,01131.000,E,2,12,0.9,545.4,M,,*47");
+        QVERIFY(NMEASchema::parse<NMEASentences::kGGA>(t.data(), t.size(), gga));
+        QCOMPARE(gga.timeOfDayMs, int64_t(-1));
+        t = split("$GPGGA,123519,4807.038,N,01131.000,E,,51,0.9,545.4,M,,*47");
+        QVERIFY_EXCEPTION_THROWN(NMEASchema::parse<NMEASentences::kGGA>(t.data(), t.size(), gga), InvalidDataError);
+        QCOMPARE(int(gga.fixQuality), 0);       // empty field reads as 0, like QString::toInt
+    }
+
+    void bench_ggaSchema()
+    {
+        const std::vector<std::string_view> t = split("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47");
+        NMEASentences::GGA gga;
+        QBENCHMARK {
+            for (int i = 0; i < 100000; ++i)
+                NMEASchema::parse<NMEASentences::kGGA>(t.data(), t.size(), gga);
+        }
+    }
+};
+
+QTEST_MAIN(TestNMEASchema)
+#include "test_nmea_schema.moc"
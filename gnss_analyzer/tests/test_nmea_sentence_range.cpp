@@ -0,0 +1,161 @@
+#include <QtTest>
+#include "NMEASentenceRange.hpp"
+#include "NMEAStreamParser.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+static_assert(std::ranges::input_range<NMEASentenceRange>);
+static_assert(std::ranges::view<NMEASentenceRange>);
+#endif
+
+namespace {
+
+    const std::string kLog =
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n"
+        "$GPGSA,A,3,04,05,09,12,,,,,,,,,1.8,1.0,1.4*30\r\n"
+        "garbage line\n"
+        "$GPRMC,130559.00,A,4517.27361,N,00552.34637,E,0.018,,220623,,,A*6C\n"
+        "\n"
+        "$GNGSV,2,1,06,02,65,290,42,00,40,150,38,09,55,050,44,12,32,200,36*7A\n"
+        "$GPGGA,123520,4807.038,N,01131.000,E,7,08,0.9,545.4,M,,*47\n"
+        "$GLGSV,2,2,06,17,10,020,,25,05,330,30*4B";      // no final newline
+
+    std::string bigLog(size_t epochs)
+    {
+        std::string log;
+        for (size_t i = 0; i < epochs; ++i)
+        {
+            log += "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47\r\n";
+            log += "$GPGSA,A,3,04,05,09,12,24,25,29,31,,,,,1.8,1.0,1.4*30\r\n";
+            log += "$GPGSV,2,1,08,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A\r\n";
+            log += "$GPGSV,2,2,08,17,10,020,,25,05,330,30,24,41,151,39,31,07,100,*4B\r\n";
+        }
+        return log;
+    }
+}
+
+class TestNMEASentenceRange : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_iteration()
+    {
+        std::vector<NMEAItem> items;
+        for (const NMEAItem &item : NMEASentenceRange(kLog))
+            items.push_back(item);
+        QCOMPARE(items.size(), size_t(5));
+
+        const auto &gga = std::get<NMEASentences::GGA>(items[0].sentence);
+        QVERIFY(std::fabs(gga.latitude - 48.1173) < 1e-9);
+        QCOMPARE(items[0].offset, uint64_t(0));
+        QCOMPARE(std::string(items[0].line.substr(items[0].line.size() - 3)), std::string("*47"));   // CR/LF stripped
+
+        const auto &gsa = std::get<NMEASentences::GSA>(items[1].sentence);
+        QCOMPARE(gsa.fixType, 3);
+        QCOMPARE(int(gsa.prnCount), 4);
+        QCOMPARE(gsa.prns[3], 12);
+        QCOMPARE(gsa.vdop, 1.4);
+
+        const auto &gsv = std::get<GSVMessage>(items[2].sentence);
+        QCOMPARE(std::string(items[2].talker()), std::string("GN"));
+        QCOMPARE(gsv.header.messageNumber, 1);
+        QCOMPARE(int(gsv.count), 3);                // PRN 00 skipped
+        QCOMPARE(gsv.satellites[2].id, 12);
+        QCOMPARE(gsv.satellites[2].snr, 36.0);
+        QCOMPARE(items[2].offset, uint64_t(kLog.find("$GNGSV")));
+
+        // A bad line is an item, not an exception that ends the loop
+        QCOMPARE(std::get<NMEARejected>(items[3].sentence).message,
+                 std::string("InvalidData: Unknown fix quality code: 7"));
+
+        const auto &last = std::get<GSVMessage>(items[4].sentence);
+        QCOMPARE(int(last.count), 2);
+        QVERIFY(std::isinf(last.satellites[0].snr));
+    }
+
+    void test_emptyAndPartial()
+    {
+        NMEASentenceRange empty;
+        QVERIFY(empty.begin() == empty.end());
+        QVERIFY(NMEASentenceRange("no sentence\n\n").begin() == NMEASentenceRange().end());
+
+        const std::string log = kLog.substr(0, kLog.find("$GPGSA") + 10);     // cut mid-line
+        size_t count = 0;
+        for (const NMEAItem &item : NMEASentenceRange(log.data(), log.size()))
+        {
+            ++count;
+            QVERIFY(!std::holds_alternative<std::monostate>(item.sentence));
+        }
+        QCOMPARE(count, size_t(2));
+        QVERIFY(std::holds_alternative<NMEARejected>(parseSentence("$GPGSA,A,3,04")));
+        QVERIFY(std::holds_alternative<std::monostate>(parseSentence("$GPXYZ,1,2")));
+    }
+
+    void test_matchesStreamParser()
+    {
+        const std::string log = bigLog(50);
+        NMEAStreamParser parser;
+        EpochRecord record;
+        size_t fixes = 0;
+        size_t lines = 0;
+        for (const NMEAItem &item : NMEASentenceRange(log))
+        {
+            ++lines;
+            parser.parse(item.line, record);
+            if (const auto *gga = std::get_if<NMEASentences::GGA>(&item.sentence))
+            {
+                ++fixes;
+                QCOMPARE(gga->latitude, record.latitude);
+                QCOMPARE(gga->hdop, record.hdop);
+            }
+        }
+        QCOMPARE(lines, size_t(200));
+        QCOMPARE(fixes, size_t(50));
+        QCOMPARE(record.satellitesInView.size(), size_t(8));
+    }
+
+    void test_viewsComposition()
+    {
+#if __cplusplus >= 202002L
+        auto hdops = NMEASentenceRange(kLog)
+                   | std::views::filter([](const NMEAItem &item) {
+                         return std::holds_alternative<NMEASentences::GGA>(item.sentence);
+                     })
+                   | std::views::transform([](const NMEAItem &item) {
+                         return std::get<NMEASentences::GGA>(item.sentence).hdop;
+                     });
+        std::vector<double> values;
+        for (double hdop : hdops)
+            values.push_back(hdop);
+        QCOMPARE(values, (std::vector<double>{0.9}));
+
+        size_t gsv = 0;
+        for (const NMEAItem &item : NMEASentenceRange(kLog) | std::views::take(3))
+            gsv += std::holds_alternative<GSVMessage>(item.sentence);
+        QCOMPARE(gsv, size_t(1));
+#else
+        QSKIP("std::views needs C++20");
+#endif
+    }
+
+    void bench_range()
+    {
+        const std::string log = bigLog(100000);
+        QBENCHMARK {
+            size_t satellites = 0;
+            for (const NMEAItem &item : NMEASentenceRange(log))
+            {
+                if (const auto *gsv = std::get_if<GSVMessage>(&item.sentence))
+                    satellites += gsv->count;
+            }
+            QCOMPARE(satellites, size_t(800000));
+        }
+    }
+};
+
+QTEST_MAIN(TestNMEASentenceRange)
+#include "test_nmea_sentence_range.moc"
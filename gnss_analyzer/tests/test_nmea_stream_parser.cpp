@@ -0,0 +1,210 @@
+#include <QtTest>
+#include "NMEAStreamParser.hpp"
+#include "NMEAParser.hpp"
+#include "NMEAException.hpp"
+#include "EpochColumns.hpp"
+#include "QtAdapter.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr int64_t kDayMs = 86400000;
+    const EpochTime kDay{std::chrono::milliseconds(19675 * kDayMs)};      // 2023-11-14
+
+    const char *const kSentences[] = {
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47",
+        "$GPGSV,3,1,10,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A",
+        "$GPGSV,3,2,10,17,10,020,,25,05,330,30,04,41,151,39,31,07,100,*4B",
+        "$GPRMC,130559.00,A,4517.27361,N,00552.34637,E,0.018,,220623,,,A*6C",
+        "$GPGSV,3,3,10,05,20,200,25,33,,,*4B\r\n",
+        "$GPGGA,123520.50,3345.500,S,07030.250,W,4,12,0.6,-12.5,M,,*47\r\n",
+        "$GPGGA,123521,5123.456,N,00012.345,E,2,10,1.2,120.0,M,,*5C",
+    };
+}
+
+class TestNMEAStreamParser : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_parseGGA()
+    {
+        NMEAStreamParser parser;
+        parser.setDate(kDay + std::chrono::hours(7));
+        EpochRecord record;
+        QVERIFY(parser.parse("$GPGGA,123519.25,4807.038,N,11131.000,W,1,08,0.9,545.4,M,,*47", record)
+                == NMEAStreamParser::Update::Fix);
+        QVERIFY(record.hasTime);
+        QCOMPARE(record.timeMs(), kDay.time_since_epoch().count() + (12 * 3600 + 35 * 60 + 19) * 1000LL + 250);
+        QVERIFY(std::fabs(record.latitude - 48.1173) < 1e-9);
+        QVERIFY(std::fabs(record.longitude + 111.516666667) < 1e-8);
+        QCOMPARE(int(record.fixQuality), 1);
+        QCOMPARE(int(record.satellites), 8);
+        QCOMPARE(record.hdop, 0.9);
+        QCOMPARE(record.altitude, 545.4);
+        QCOMPARE(std::string(fixQualityName(record.fixQuality)), std::string("GPS Fix"));
+
+        // Midnight: the time of day steps back, the date moves on
+        parser.parse("$GPGGA,235959,4807.038,N,11131.000,W,1,08,0.9,545.4,M,,*47", record);
+        parser.parse("$GPGGA,000000,4807.038,N,11131.000,W,1,08,0.9,545.4,M,,*47", record);
+        QCOMPARE(record.timeMs(), kDay.time_since_epoch().count() + kDayMs);
+
+        QVERIFY(parser.parse("$GPRMC,130559.00,A,4517.27361,N,00552.34637,E,0.018,,220623,,,A*6C", record)
+                == NMEAStreamParser::Update::None);
+        QVERIFY(parser.parse("", record) == NMEAStreamParser::Update::None);
+    }
+
+    void test_parseGGA_errors()
+    {
+        NMEAStreamParser parser;
+        EpochRecord record;
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,123519,4807.038,N", record), ParsingError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,1235,4807.038,N,11131.000,E,1,08,0.9,545.4,M,,*47", record),
+                                 InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,094500,,,,,0,00,99.9,,,,,,*48", record), InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,123519,4807.038,N,11131.000,E,5,08,0.9,545.4,M,,*47", record),
+                                 InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,123519,4807.038,N,11131.000,E,1,51,0.9,545.4,M,,*47", record),
+                                 InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,123519,4807.038,N,11131.000,E,1,08,0.0,545.4,M,,*47", record),
+                                 InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,123519,4807.038,N,11131.000,E,1,08,0.9,10545.4,M,,*47", record),
+                                 InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGGA,123519,48x7.038,N,11131.000,E,1,08,0.9,545.4,M,,*47", record),
+                                 InvalidDataError);
+        QVERIFY_EXCEPTION_THROWN(parser.parse("$GPGSV,1,1", record), ParsingError);
+
+        try {
+            parser.parse("$GPGGA,123519,4807.038,N,11131.000,E,3,08,0.9,545.4,M,,*47", record);
+            QFAIL("no exception");
+        } catch (const InvalidDataError &e) {
+            QCOMPARE(std::string(e.what()), std::string("InvalidData: Unknown fix quality code: 3"));
+        }
+    }
+
+    void test_parseGSV_sequence()
+    {
+        NMEAStreamParser parser, other;
+        EpochRecord record, otherRecord;
+        QVERIFY(parser.parse(kSentences[1], record) == NMEAStreamParser::Update::None);
+        QVERIFY(record.satellitesInView.empty());
+
+        // A second receiver does not disturb the sequence in progress
+        QVERIFY(other.parse("$GPGSV,1,1,01,07,55,050,44*7A", otherRecord) == NMEAStreamParser::Update::Satellites);
+        QCOMPARE(otherRecord.satellitesInView.size(), size_t(1));
+
+        QVERIFY(parser.parse(kSentences[2], record) == NMEAStreamParser::Update::None);
+        QVERIFY(parser.parse(kSentences[4], record) == NMEAStreamParser::Update::Satellites);
+        std::vector<int32_t> ids;
+        for (const SatelliteRecord &s : record.satellitesInView)
+            ids.push_back(s.id);
+        QCOMPARE(ids, (std::vector<int32_t>{2, 4, 5, 9, 12, 17, 25, 31, 33}));
+        QCOMPARE(record.satellitesInView[1].snr, 39.0);      // repeated ID: the last one wins
+        QCOMPARE(record.satellitesInView[4].snr, 36.0);
+        QVERIFY(std::isinf(record.satellitesInView[5].snr));
+        QVERIFY(std::isinf(record.satellitesInView[8].elevation));
+        QCOMPARE(record.snrAvg, (42.0 + 39.0 + 25.0 + 44.0 + 36.0 + 30.0) / 6.0);
+
+        // An interrupted sequence is dropped by reset()
+        parser.parse(kSentences[1], record);
+        parser.reset();
+        QVERIFY(parser.parse(kSentences[4], record) == NMEAStreamParser::Update::None);
+    }
+
+    void test_parityWithQtParser()
+    {
+        NMEAStreamParser parser;
+        EpochRecord record;
+        GNSSData expected;
+        for (const char *sentence : kSentences)
+        {
+            NMEAParser::parseLine(QString::fromLatin1(sentence), expected);
+            parser.parse(sentence, record);
+
+            GNSSData data;
+            QtAdapter::toGNSSData(record, data);
+            QCOMPARE(data.latitude, expected.latitude);
+            QCOMPARE(data.longitude, expected.longitude);
+            QCOMPARE(data.altitude, expected.altitude);
+            QCOMPARE(data.hdop, expected.hdop);
+            QCOMPARE(data.satellites, expected.satellites);
+            QCOMPARE(data.fixType, expected.fixType);
+            QCOMPARE(data.snrAvg, expected.snrAvg);
+            QCOMPARE(data.satMap.size(), expected.satMap.size());
+            for (auto it = expected.satMap.constBegin(); it != expected.satMap.constEnd(); ++it)
+            {
+                QVERIFY(data.satMap.contains(it.key()));
+                QCOMPARE(data.satMap[it.key()].elevation, it.value().elevation);
+                QCOMPARE(data.satMap[it.key()].snr, it.value().snr);
+            }
+            // The Qt parser drops the fraction of a second
+            QCOMPARE(record.timeMs() % kDayMs / 1000, expected.timestamp.time().msecsSinceStartOfDay() / 1000);
+        }
+    }
+
+    void test_adapterAndColumns()
+    {
+        NMEAStreamParser parser;
+        EpochRecord record;
+        for (const char *sentence : kSentences)
+            parser.parse(sentence, record);
+        record.vdop = 1.4;
+
+        GNSSData data;
+        QtAdapter::toGNSSData(record, data);
+        EpochRecord back;
+        QtAdapter::toEpochRecord(data, back);
+        QCOMPARE(back.timeMs(), record.timeMs());
+        QCOMPARE(int(back.fixQuality), 2);
+        QCOMPARE(back.vdop, 1.4);
+        QCOMPARE(back.satellitesInView.size(), record.satellitesInView.size());
+
+        // Both data models land in the same columns
+        EpochColumns columns;
+        columns.append(record);
+        QtAdapter::append(columns, data);
+        QCOMPARE(columns.timeMs[0], columns.timeMs[1]);
+        QCOMPARE(columns.fixQuality[0], columns.fixQuality[1]);
+        QCOMPARE(columns.satOffset[1], columns.satOffset[2] - columns.satOffset[1]);
+        for (size_t s = 0; s < columns.satOffset[1]; ++s)
+        {
+            QCOMPARE(columns.satId[s], columns.satId[columns.satOffset[1] + s]);
+            QCOMPARE(columns.azimuth[s], columns.azimuth[columns.satOffset[1] + s]);
+        }
+
+        EpochRecord row;
+        columns.get(0, row);
+        QCOMPARE(row.timeMs(), record.timeMs());
+        QCOMPARE(row.satellitesInView[0].snr, 42.0);
+    }
+
+    void bench_streamParser()
+    {
+        std::vector<std::string> lines;
+        for (int i = 0; i < 100000; ++i)
+            lines.emplace_back(kSentences[i % 7]);
+        NMEAStreamParser parser;
+        EpochRecord record;
+        QBENCHMARK {
+            for (const std::string &line : lines)
+                parser.parse(line, record);
+        }
+    }
+
+    void bench_qtParser()
+    {
+        QStringList lines;
+        for (int i = 0; i < 100000; ++i)
+            lines.push_back(QString::fromLatin1(kSentences[i % 7]));
+        GNSSData data;
+        QBENCHMARK {
+            for (const QString &line : lines)
+                NMEAParser::parseLine(line, data);
+        }
+    }
+};
+
+QTEST_MAIN(TestNMEAStreamParser)
+#include "test_nmea_stream_parser.moc"
@@ -0,0 +1,118 @@
+#include <QtTest>
+#include "NMEAEpochContext.hpp"
+#include "ParseStats.hpp"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Same epoch as test_epoch_arena, with valid checksums
+    const char *const kEpoch[] = {
+        "$GPGSV,3,1,10,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*70\r\n",
+        "$GPGSV,3,2,10,17,10,020,,25,05,330,30,04,41,151,39,31,07,100,*77\r\n",
+        "$GPGSV,3,3,10,05,20,200,25,33,,,*4A\r\n",
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*1F\r\n",
+    };
+}
+
+class TestParseStats : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_checksum()
+    {
+        QVERIFY(!NMEAStreamParser::checksumMismatch(kEpoch[3]));
+        QVERIFY(!NMEAStreamParser::checksumMismatch("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*1f"));
+        QVERIFY(NMEAStreamParser::checksumMismatch("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*47"));
+        QVERIFY(NMEAStreamParser::checksumMismatch("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,*G1"));
+        QVERIFY(!NMEAStreamParser::checksumMismatch("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,,"));
+    }
+
+    void test_contextCounters()
+    {
+        if (!ParseStats::kEnabled)
+            QSKIP("built without GNSS_PARSE_STATS");
+
+        NMEAEpochContext context;
+        for (const char *line : kEpoch)
+            context.parse(line);
+        context.parse(kEpoch[0]);       // sequence left open
+        context.parse("$GPGSV,3,1,10,02,65,290,42,04,40,150,38,09,55,050,44,12,32,200,36*7A");
+        context.parse("$GPGGA,123519,4807.038,N,01131.000,E,3,08,0.9,545.4,M,,*47");
+        context.parse("$GPGGA,123519");
+        context.parse("$GPRMC,123519,A*00");
+
+        const ParseCounters stats = context.stats().snapshot();
+        QCOMPARE(stats[ParseCounter::GGASentences], uint64_t(3));
+        QCOMPARE(stats[ParseCounter::GSVSentences], uint64_t(5));
+        QCOMPARE(stats[ParseCounter::OtherSentences], uint64_t(1));
+        QCOMPARE(stats.sentences(), uint64_t(9));
+        QCOMPARE(stats[ParseCounter::ChecksumFailures], uint64_t(3));
+        QCOMPARE(stats[ParseCounter::InvalidDataErrors], uint64_t(1));
+        QCOMPARE(stats[ParseCounter::ParsingErrors], uint64_t(1));
+        QCOMPARE(stats[ParseCounter::GSVResets], uint64_t(1));
+        QCOMPARE(context.rejectedLines(), uint64_t(2));
+
+        uint64_t bytes = 0;
+        for (const char *line : kEpoch)
+            bytes += std::strlen(line);
+        QVERIFY(stats[ParseCounter::Bytes] > bytes);
+        QCOMPARE(stats[ParseCounter::TimedSentences], uint64_t(0));     // fewer than kTimingInterval
+    }
+
+    void test_stageTimes()
+    {
+        if (!ParseStats::kEnabled)
+            QSKIP("built without GNSS_PARSE_STATS");
+
+        NMEAEpochContext context;
+        for (int i = 0; i < 1000; ++i)
+            for (const char *line : kEpoch)
+                context.parse(line);
+        const ParseCounters stats = context.stats().snapshot();
+        QCOMPARE(stats[ParseCounter::TimedSentences], uint64_t(4000 / ParseStats::kTimingInterval));
+        QVERIFY(stats[ParseCounter::ParseNs] > 0);
+        QVERIFY(stats.nsPerSentence(ParseCounter::ParseNs) > 0.0);
+    }
+
+    void test_shardsPerThread()
+    {
+        if (!ParseStats::kEnabled)
+            QSKIP("built without GNSS_PARSE_STATS");
+
+        static_assert(alignof(ParseStats::Shard) == 64, "one cache line per thread");
+        constexpr int kThreads = 4;
+        ParseStats stats;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+            threads.emplace_back([&stats] {
+                for (int i = 0; i < 100000; ++i)
+                    stats.add(ParseCounter::Bytes, 2);
+            });
+
+        // Reading while the writers run is allowed
+        while (stats.snapshot()[ParseCounter::Bytes] == 0)
+            std::this_thread::yield();
+        for (std::thread &thread : threads)
+            thread.join();
+
+        QCOMPARE(stats.shards(), size_t(kThreads));
+        QCOMPARE(stats.snapshot()[ParseCounter::Bytes], uint64_t(kThreads * 200000));
+    }
+
+    void bench_contextParse()
+    {
+        NMEAEpochContext context;
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i)
+                for (const char *line : kEpoch)
+                    context.parse(line);
+        }
+    }
+};
+
+QTEST_MAIN(TestParseStats)
+#include "test_parse_stats.moc"
@@ -0,0 +1,137 @@
+#include <QtTest>
+#include "PositionFilter.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+    constexpr int64_t kStartMs = 1700000000000LL;
+    constexpr double kMetersPerDegree = 111320.0;   // close enough for test tolerances near 45 deg N
+
+    double horizontalError(const TrackPoint &p, double lat, double lon)
+    {
+        const double dn = (p.latitude - lat) * kMetersPerDegree;
+        const double de = (p.longitude - lon) * kMetersPerDegree * std::cos(lat * M_PI / 180.0);
+        return std::hypot(de, dn);
+    }
+}
+
+class TestPositionFilter : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_matrixInverse()
+    {
+        Matrix<3, 3> a;
+        a(0, 0) = 4.0; a(0, 1) = 1.0; a(0, 2) = 0.5;
+        a(1, 0) = 1.0; a(1, 1) = 3.0; a(1, 2) = 0.2;
+        a(2, 0) = 0.5; a(2, 1) = 0.2; a(2, 2) = 2.0;
+        Matrix<3, 3> inv;
+        QVERIFY(invertSPD(a, inv));
+        const Matrix<3, 3> i = a * inv;
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                QVERIFY(std::fabs(i(r, c) - (r == c ? 1.0 : 0.0)) < 1e-12);
+
+        a(2, 2) = -1.0;
+        QVERIFY(!invertSPD(a, inv));
+    }
+
+    void test_staticReceiverNoiseReduced()
+    {
+        // 5 m (1 sigma) per axis: hdop 2 times the autonomous UERE
+        std::mt19937 rng(17);
+        std::normal_distribution<double> noise(0.0, 5.0 / kMetersPerDegree);
+        const double lat = 45.0, lon = 5.0;
+
+        PositionFilter filter;
+        TrackPoint p;
+        double rawSum = 0.0, filteredSum = 0.0;
+        int counted = 0;
+        for (int i = 0; i < 600; ++i)
+        {
+            const double mLat = lat + noise(rng);
+            const double mLon = lon + noise(rng) / std::cos(lat * M_PI / 180.0);
+            QVERIFY(filter.update(kStartMs + i * 1000, mLat, mLon, 200.0, 2.0, 0.0, 1, p));
+            if (i >= 100)
+            {
+                rawSum += horizontalError(TrackPoint{0, mLat, mLon}, lat, lon);
+                filteredSum += horizontalError(p, lat, lon);
+                ++counted;
+            }
+        }
+        QVERIFY(filteredSum / counted < 0.7 * rawSum / counted);
+        QVERIFY(std::fabs(p.velocityEast) < 2.0 && std::fabs(p.velocityNorth) < 2.0);
+        QVERIFY(p.sigmaHorizontal > 0.0 && p.sigmaHorizontal < 5.0);
+    }
+
+    void test_tracksConstantVelocity()
+    {
+        // 10 m/s due east, RTK fixes at 5 Hz
+        const double lat = 45.0, lon0 = 5.0;
+        const double metersPerDegLon = kMetersPerDegree * std::cos(lat * M_PI / 180.0);
+        PositionFilter filter;
+        TrackPoint p;
+        for (int i = 0; i < 300; ++i)
+        {
+            const double t = i * 0.2;
+            QVERIFY(filter.update(kStartMs + i * 200, lat, lon0 + 10.0 * t / metersPerDegLon, 200.0, 0.8, 1.2, 4, p));
+        }
+        QVERIFY(std::fabs(p.velocityEast - 10.0) < 0.1);
+        QVERIFY(std::fabs(p.velocityNorth) < 0.1);
+        QVERIFY(horizontalError(p, lat, lon0 + 10.0 * 299 * 0.2 / metersPerDegLon) < 0.1);
+    }
+
+    void test_fixTypeAndGaps()
+    {
+        PositionFilter filter;
+        TrackPoint p;
+        QVERIFY(!filter.update(kStartMs, 45.0, 5.0, 200.0, 1.0, 0.0, 0, p));   // no fix
+        QVERIFY(!filter.initialized());
+
+        QVERIFY(filter.update(kStartMs, 45.0, 5.0, 200.0, 1.0, 0.0, 1, p));
+        QVERIFY(filter.update(kStartMs + 1000, 45.0, 5.0, 200.0, 1.0, 0.0, 1, p));
+
+        // An RTK fix far away is trusted much more than the autonomous history
+        const double jumped = 5.0 + 20.0 / (kMetersPerDegree * std::cos(M_PI / 4));
+        QVERIFY(filter.update(kStartMs + 2000, 45.0, jumped, 200.0, 1.0, 0.0, 4, p));
+        QVERIFY(horizontalError(p, 45.0, jumped) < 0.5);
+
+        // A gap restarts the track exactly at the new fix
+        QVERIFY(filter.update(kStartMs + 60000, 46.0, 6.0, 300.0, 1.0, 0.0, 1, p));
+        QVERIFY(horizontalError(p, 46.0, 6.0) < 1e-6);
+        QVERIFY(std::fabs(p.altitude - 300.0) < 1e-6);
+        QCOMPARE(p.velocityEast, 0.0);
+    }
+
+    void test_updateGNSSData()
+    {
+        PositionFilter filter;
+        GNSSData data;
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs, Qt::UTC);
+        data.latitude = 45.0;
+        data.longitude = 5.0;
+        data.altitude = 200.0;
+        data.hdop = 0.9;
+        data.fixType = "DGPS Fix";
+        TrackPoint p;
+        QVERIFY(filter.update(data, p));
+        QCOMPARE(p.timeMs, int64_t(kStartMs));
+        QVERIFY(std::fabs(p.sigmaHorizontal - std::sqrt(2.0) * 0.9 * 0.8) < 1e-9);
+    }
+
+    void bench_update()
+    {
+        PositionFilter filter;
+        TrackPoint p;
+        int64_t t = kStartMs;
+        QBENCHMARK {
+            for (int i = 0; i < 100000; ++i, t += 100)
+                filter.update(t, 45.0 + (i & 7) * 1e-6, 5.0, 200.0, 1.0, 1.5, 1, p);
+        }
+    }
+};
+
+QTEST_MAIN(TestPositionFilter)
+#include "test_position_filter.moc"
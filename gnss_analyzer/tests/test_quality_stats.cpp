@@ -0,0 +1,125 @@
+#include <QtTest>
+#include "QualityStats.hpp"
+#include "RunningStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class TestQualityStats : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_runningStatsMatchesTwoPass()
+    {
+        std::mt19937 rng(7);
+        std::normal_distribution<double> snr(40.0, 4.0);
+        std::vector<double> samples;
+        RunningStats stats;
+        for (int i = 0; i < 10000; ++i)
+        {
+            // Large offset: a naive sum of squares would lose the variance
+            samples.push_back(1e6 + snr(rng));
+            stats.add(samples.back());
+        }
+
+        double mean = 0.0;
+        for (double s : samples)
+            mean += s;
+        mean /= samples.size();
+        double m2 = 0.0;
+        for (double s : samples)
+            m2 += (s - mean) * (s - mean);
+
+        QCOMPARE(stats.count(), uint64_t(samples.size()));
+        QVERIFY(std::fabs(stats.mean() - mean) < 1e-6);
+        QVERIFY(std::fabs(stats.variance() - m2 / (samples.size() - 1)) < 1e-3);
+        QCOMPARE(stats.min(), *std::min_element(samples.begin(), samples.end()));
+        QCOMPARE(stats.max(), *std::max_element(samples.begin(), samples.end()));
+    }
+
+    void test_runningStatsMerge()
+    {
+        RunningStats all, a, b;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const double x = std::sin(i * 0.1) * 10.0 + i * 0.01;
+            all.add(x);
+            (i % 3 == 0 ? a : b).add(x);
+        }
+        a.merge(b);
+        QCOMPARE(a.count(), all.count());
+        QVERIFY(std::fabs(a.mean() - all.mean()) < 1e-12);
+        QVERIFY(std::fabs(a.variance() - all.variance()) < 1e-9);
+        QCOMPARE(a.min(), all.min());
+        QCOMPARE(a.max(), all.max());
+    }
+
+    void test_p2Quantile()
+    {
+        std::mt19937 rng(11);
+        std::gamma_distribution<double> skewed(2.0, 1.5);
+        P2Quantile median(0.5), p95(0.95);
+        std::vector<double> samples;
+        for (int i = 0; i < 50000; ++i)
+        {
+            samples.push_back(skewed(rng));
+            median.add(samples.back());
+            p95.add(samples.back());
+        }
+        std::sort(samples.begin(), samples.end());
+        const double exactMedian = samples[samples.size() / 2];
+        const double exactP95 = samples[samples.size() * 95 / 100];
+        QVERIFY(std::fabs(median.value() - exactMedian) < 0.02 * exactMedian);
+        QVERIFY(std::fabs(p95.value() - exactP95) < 0.02 * exactP95);
+
+        // Exact during warm-up
+        P2Quantile small(0.5);
+        small.add(3.0);
+        small.add(1.0);
+        small.add(2.0);
+        QCOMPARE(small.value(), 2.0);
+    }
+
+    void test_qualityStats()
+    {
+        QualityStats quality;
+        GNSSData data;
+        for (int i = 0; i < 100; ++i)
+        {
+            data.fixType = i < 10 ? "No Fix" : (i < 40 ? "GPS Fix" : "RTK Fix");
+            data.satellites = 8;
+            data.hdop = i < 10 ? 0.0 : 1.0;
+            data.satMap.clear();
+            data.satMap[5] = SATInfo{45.0, 90.0, 40.0};
+            data.satMap[70] = SATInfo{30.0, 180.0, 30.0 + (i % 2) * 2.0};
+            data.satMap[305] = SATInfo{60.0, 270.0, -qInf()};
+            quality.update(data);
+        }
+
+        QCOMPARE(quality.epochCount(), uint64_t(100));
+        QCOMPARE(quality.fixRatio(0), 0.10);
+        QCOMPARE(quality.fixRatio(1), 0.30);
+        QCOMPARE(quality.fixRatio(4), 0.60);
+        QCOMPARE(quality.hdop().count(), uint64_t(90));
+        QCOMPARE(quality.satellites().mean(), 8.0);
+
+        QVERIFY(quality.satellite(5) != nullptr);
+        QCOMPARE(quality.satellite(5)->stats.mean(), 40.0);
+        QCOMPARE(quality.satellite(70)->stats.mean(), 31.0);
+        QVERIFY(quality.satellite(305) == nullptr);
+
+        QCOMPARE(quality.constellation(GNSSSystem::GPS).stats.count(), uint64_t(100));
+        QCOMPARE(quality.constellation(GNSSSystem::GLONASS).stats.max(), 32.0);
+        QCOMPARE(quality.constellation(GNSSSystem::Galileo).stats.count(), uint64_t(0));
+        QCOMPARE(quality.snrAvg().mean(), 35.5);
+
+        quality.reset();
+        QCOMPARE(quality.epochCount(), uint64_t(0));
+        QCOMPARE(quality.fixRatio(1), 0.0);
+    }
+};
+
+QTEST_MAIN(TestQualityStats)
+#include "test_quality_stats.moc"
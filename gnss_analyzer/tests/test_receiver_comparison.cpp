@@ -0,0 +1,154 @@
+#include <QtTest>
+#include "ReceiverComparison.hpp"
+#include "EpochColumns.hpp"
+#include "GNSSDataModel.hpp"
+#include "Geodesy.hpp"
+#include "QtAdapter.hpp"
+#include <cmath>
+
+namespace {
+
+    constexpr int64_t kStartMs = 1700000000000LL;
+
+    /**
+     * 1 Hz receiver on a 2 km circle, offset by (@p east, @p north, @p up)
+     * meters from the reference antenna, with every @p skip-th epoch missing
+     * (0: none) and satellites 1..8 (plus @p extraSat) at 40 dB-Hz + @p snrOffset.
+     */
+    EpochColumns makeReceiver(int epochs, double east, double north, double up, int skip,
+                              double snrOffset, int extraSat = 0, int64_t clockOffsetMs = 0)
+    {
+        EpochColumns columns;
+        GNSSData data;
+        data.hdop = 0.9;
+        for (int i = 0; i < epochs; ++i)
+        {
+            if (skip && i % skip == skip - 1)
+                continue;
+            const double angle = i * 2e-3;
+            const Geodesy::ENUFrame frame = Geodesy::makeENUFrame(45.0, 5.0, 200.0);
+            double e = 2000.0 * std::cos(angle), n = 2000.0 * std::sin(angle), u = 0.0;
+            double lat, lon, alt;
+            Geodesy::enuToLla(frame, &e, &n, &u, 1, &lat, &lon, &alt);
+
+            // Offset in the ENU of the antenna position itself
+            const Geodesy::ENUFrame local = Geodesy::makeENUFrame(lat, lon, alt);
+            Geodesy::enuToLla(local, &east, &north, &up, 1, &data.latitude, &data.longitude, &data.altitude);
+
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(kStartMs + i * 1000LL + clockOffsetMs, Qt::UTC);
+            data.fixType = (i % 50 == 0) ? "DGPS Fix" : "GPS Fix";
+            data.satMap.clear();
+            for (int s = 1; s <= 8; ++s)
+                data.satMap[s] = SATInfo{30.0, s * 45.0, 40.0 + s * 0.1 + snrOffset};
+            if (extraSat)
+                data.satMap[extraSat] = SATInfo{10.0, 0.0, 30.0};
+            data.satMap[2].snr = (i % 2) ? -qInf() : data.satMap[2].snr;
+            QtAdapter::append(columns, data);
+        }
+        return columns;
+    }
+}
+
+class TestReceiverComparison : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_mergeJoin()
+    {
+        EpochColumns a, b;
+        a.timeMs = {0, 1000, 2000, 3000, 5000};
+        b.timeMs = {1000, 2010, 2990, 4000, 5000};
+        std::vector<uint64_t> ra, rb;
+        Comparison::mergeJoin(a, b, 0, ra, rb);
+        QCOMPARE(ra, (std::vector<uint64_t>{1, 4}));
+        QCOMPARE(rb, (std::vector<uint64_t>{0, 4}));
+
+        Comparison::mergeJoin(a, b, 20, ra, rb);
+        QCOMPARE(ra, (std::vector<uint64_t>{1, 2, 3, 4}));
+        QCOMPARE(rb, (std::vector<uint64_t>{0, 1, 2, 4}));
+
+        b.timeMs = {2000, 1000};
+        QVERIFY_EXCEPTION_THROWN(Comparison::mergeJoin(a, b, 0, ra, rb), std::invalid_argument);
+    }
+
+    void test_compareReceivers()
+    {
+        const EpochColumns ref = makeReceiver(3000, 0.0, 0.0, 0.0, 0, 0.0);
+        const EpochColumns near = makeReceiver(3000, 1.0, -0.5, 0.25, 7, 2.0, 12);
+        const EpochColumns late = makeReceiver(3000, 0.0, 3.0, 0.0, 0, -1.0, 0, 40);
+
+        const std::vector<ReceiverComparison> cmp = Comparison::compare({&near, &ref, &late}, 1, 0, 3);
+        QCOMPARE(cmp.size(), size_t(2));
+        QCOMPARE(cmp[0].receiver, size_t(0));
+        QCOMPARE(cmp[1].receiver, size_t(2));
+
+        const ReceiverComparison &a = cmp[0];
+        QCOMPARE(a.summary.matched, near.size());
+        QCOMPARE(a.summary.referenceEpochs, size_t(3000));
+        QVERIFY(std::fabs(a.summary.east.mean() - 1.0) < 1e-6);
+        QVERIFY(std::fabs(a.summary.north.mean() + 0.5) < 1e-6);
+        QVERIFY(std::fabs(a.summary.up.mean() - 0.25) < 1e-6);
+        QVERIFY(a.summary.east.stddev() < 1e-6);
+        QVERIFY(std::fabs(a.summary.horizontal.mean() - std::hypot(1.0, 0.5)) < 1e-6);
+        QCOMPARE(a.summary.fixAgreement(), 1.0);
+        QVERIFY(std::fabs(a.summary.snrDelta.mean() - 2.0) < 1e-4);
+        QVERIFY(a.summary.satelliteSnrDelta.count(12) == 0);   // only one receiver sees it
+        QVERIFY(a.summary.satelliteSnrDelta.at(2).count() < a.summary.satelliteSnrDelta.at(3).count());
+        for (size_t i = 0; i < a.columns.size(); ++i)
+        {
+            QCOMPARE(a.columns.timeMs[i], ref.timeMs[a.columns.referenceRow[i]]);
+            QCOMPARE(int(a.columns.commonSatellites[i]), (a.columns.referenceRow[i] % 2) ? 7 : 8);
+        }
+
+        // 40 ms clock offset: nothing matches exactly, everything within 50 ms
+        QCOMPARE(cmp[1].summary.matched, size_t(0));
+        const std::vector<ReceiverComparison> tolerant = Comparison::compare({&ref, &late}, 0, 50);
+        QCOMPARE(tolerant[0].summary.matched, size_t(3000));
+        QVERIFY(std::fabs(tolerant[0].summary.north.mean() - 3.0) < 1e-6);
+        QVERIFY(std::fabs(tolerant[0].summary.snrDelta.mean() + 1.0) < 1e-4);
+    }
+
+    void test_fixDisagreement()
+    {
+        EpochColumns ref = makeReceiver(100, 0.0, 0.0, 0.0, 0, 0.0);
+        EpochColumns other = makeReceiver(100, 0.0, 0.0, 0.0, 0, 0.0);
+        other.fixQuality[10] = 4;
+        other.fixQuality[11] = 0;
+        const ComparisonSummary s = Comparison::compare({&ref, &other}, 0)[0].summary;
+        QCOMPARE(s.fixAgreements, size_t(98));
+        QCOMPARE(s.east.count(), uint64_t(99));
+        QVERIFY(std::isnan(Comparison::compare({&ref, &other}, 0)[0].columns.east[11]));
+        QVERIFY_EXCEPTION_THROWN(Comparison::compare({&ref}, 1), std::invalid_argument);
+    }
+
+    void test_unsortedReceiver()
+    {
+        const EpochColumns a = makeReceiver(100, 0.0, 0.0, 0.0, 0, 0.0);
+        const EpochColumns b = makeReceiver(100, 1.0, 0.0, 0.0, 0, 0.0);
+        EpochColumns c = makeReceiver(100, 2.0, 0.0, 0.0, 0, 0.0);
+        std::swap(c.timeMs[40], c.timeMs[41]);
+
+        // Rejected on the calling thread, whatever the worker count
+        QVERIFY_EXCEPTION_THROWN(Comparison::compare({&a, &b, &c}, 0, 0, 4), std::invalid_argument);
+        QVERIFY_EXCEPTION_THROWN(Comparison::compare({&c, &a, &b}, 0, 0, 1), std::invalid_argument);
+        QVERIFY_EXCEPTION_THROWN(Comparison::compare({&a, nullptr}, 0, 0, 4), std::invalid_argument);
+    }
+
+    void bench_dozenReceiversDay()
+    {
+        const EpochColumns ref = makeReceiver(86400, 0.0, 0.0, 0.0, 0, 0.0);
+        std::vector<EpochColumns> others;
+        for (int r = 0; r < 12; ++r)
+            others.push_back(makeReceiver(86400, 0.1 * r, 0.0, 0.0, r + 2, 0.5));
+        std::vector<const EpochColumns *> receivers = {&ref};
+        for (const EpochColumns &other : others)
+            receivers.push_back(&other);
+        QBENCHMARK {
+            Comparison::compare(receivers, 0);
+        }
+    }
+};
+
+QTEST_MAIN(TestReceiverComparison)
+#include "test_receiver_comparison.moc"
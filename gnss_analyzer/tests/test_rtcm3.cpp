@@ -0,0 +1,145 @@
+#include <QtTest>
+#include "RTCM3Decoder.hpp"
+#include "NMEAException.hpp"
+
+namespace {
+
+    // MSB-first bit writer used to build reference MSM payloads
+    struct BitWriter {
+        std::vector<uint8_t> bytes;
+        size_t pos = 0;
+
+        void put(uint64_t value, unsigned n)
+        {
+            for (unsigned i = 0; i < n; ++i, ++pos)
+            {
+                if (pos / 8 >= bytes.size())
+                    bytes.push_back(0);
+                if ((value >> (n - 1 - i)) & 1)
+                    bytes[pos / 8] |= 0x80 >> (pos % 8);
+            }
+        }
+    };
+
+    std::vector<uint8_t> frame(const std::vector<uint8_t> &payload)
+    {
+        std::vector<uint8_t> out = {0xD3, uint8_t(payload.size() >> 8), uint8_t(payload.size())};
+        out.insert(out.end(), payload.begin(), payload.end());
+        const uint32_t crc = RTCM3::crc24q(out.data(), out.size());
+        out.push_back(uint8_t(crc >> 16));
+        out.push_back(uint8_t(crc >> 8));
+        out.push_back(uint8_t(crc));
+        return out;
+    }
+
+    // GPS MSM4: satellites 5 and 12, signals 2 and 15; satellite 12 only tracks signal 2
+    std::vector<uint8_t> gpsMSM4()
+    {
+        BitWriter w;
+        w.put(1074, 12);
+        w.put(100, 12);        // station
+        w.put(123456000, 30);  // TOW ms
+        w.put(0, 1);
+        w.put(3, 3);           // IODS
+        w.put(0, 15);
+        const uint64_t satMask = (1ull << (64 - 5)) | (1ull << (64 - 12));
+        w.put(satMask >> 32, 32);
+        w.put(satMask & 0xFFFFFFFF, 32);
+        w.put((1u << (32 - 2)) | (1u << (32 - 15)), 32);
+        w.put(0b1110, 4);      // cell mask
+        w.put(70, 8);  w.put(255, 8);   // rough range, integer ms (sat 12 invalid)
+        w.put(512, 10); w.put(0, 10);   // rough range, mod 1 ms
+        for (int c = 0; c < 3; ++c) w.put(1000 * (c + 1), 15);
+        for (int c = 0; c < 3; ++c) w.put(uint64_t(-2000) & 0x3FFFFF, 22);
+        for (int c = 0; c < 3; ++c) w.put(c + 1, 4);
+        for (int c = 0; c < 3; ++c) w.put(c == 1, 1);
+        for (int c = 0; c < 3; ++c) w.put(40 + c, 6);
+        return w.bytes;
+    }
+}
+
+class TestRTCM3Decoder : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_crc24q()
+    {
+        const char check[] = "123456789";
+        QCOMPARE(RTCM3::crc24q(reinterpret_cast<const uint8_t *>(check), 9), 0xCDE703u);
+    }
+
+    void test_framer_resync()
+    {
+        const std::vector<uint8_t> good = frame(gpsMSM4());
+        std::vector<uint8_t> corrupted = good;
+        corrupted[10] ^= 0x01;
+
+        std::vector<uint8_t> stream = {'$', 'G', 'P'};
+        stream.insert(stream.end(), corrupted.begin(), corrupted.end());
+        stream.insert(stream.end(), good.begin(), good.end());
+
+        RTCM3::Framer framer;
+        RTCM3::Frame f;
+        framer.feed(stream.data(), 10);
+        QVERIFY(!framer.next(f));
+        framer.feed(stream.data() + 10, stream.size() - 10);
+        QVERIFY(framer.next(f));
+        QCOMPARE(f.messageType, uint16_t(1074));
+        QCOMPARE(f.length, good.size() - 6);
+        QCOMPARE(framer.crcErrors(), uint64_t(1));
+        QVERIFY(!framer.next(f));
+    }
+
+    void test_decodeMSM4()
+    {
+        const std::vector<uint8_t> payload = gpsMSM4();
+        RTCM3::MSMEpoch epoch;
+        QVERIFY(RTCM3::decodeMSM(payload.data(), payload.size(), epoch));
+
+        QCOMPARE(epoch.stationId, uint16_t(100));
+        QCOMPARE(epoch.epochTimeMs, 123456000u);
+        QCOMPARE(epoch.iods, uint8_t(3));
+        QVERIFY(epoch.system == GNSSSystem::GPS);
+        QCOMPARE(int(epoch.observations.size()), 3);
+
+        const RTCM3::MSMObservation &first = epoch.observations[0];
+        QCOMPARE(first.satelliteId, 5);
+        QCOMPARE(int(first.signal), 2);
+        const double expectedPr = (70.5 + 1000 * 0x1p-24) * 299792.458;
+        QVERIFY(qAbs(first.pseudorange - expectedPr) < 1e-6);
+        QCOMPARE(first.cnr, 40.0);
+        QVERIFY(qIsNaN(first.phaseRangeRate));
+
+        QCOMPARE(int(epoch.observations[1].signal), 15);
+        QVERIFY(epoch.observations[1].halfCycleAmbiguity);
+
+        // Invalid rough range propagates to every cell of the satellite
+        QCOMPARE(epoch.observations[2].satelliteId, 12);
+        QVERIFY(qIsNaN(epoch.observations[2].pseudorange));
+
+        QMap<int, SATInfo> satMap;
+        RTCM3::applyToSatMap(epoch, satMap);
+        QCOMPARE(satMap.size(), 2);
+        QCOMPARE(satMap[5].snr, 40.0);
+        QVERIFY(qIsInf(satMap[12].elevation));
+    }
+
+    void test_decodeMSM_truncated()
+    {
+        std::vector<uint8_t> payload = gpsMSM4();
+        payload.resize(payload.size() - 4);
+        RTCM3::MSMEpoch epoch;
+        QVERIFY_EXCEPTION_THROWN(RTCM3::decodeMSM(payload.data(), payload.size(), epoch), ParsingError);
+    }
+
+    void test_decodeMSM_otherMessage()
+    {
+        const uint8_t stationArp[] = {0x3E, 0xD0, 0x00, 0x00};  // type 1005
+        RTCM3::MSMEpoch epoch;
+        QVERIFY(!RTCM3::decodeMSM(stationArp, sizeof(stationArp), epoch));
+    }
+};
+
+QTEST_MAIN(TestRTCM3Decoder)
+#include "test_rtcm3.moc"
@@ -0,0 +1,109 @@
+#include <QtTest>
+#include "SkyHistogram.hpp"
+#include "EpochColumns.hpp"
+#include "QtAdapter.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+    // A day of 1 Hz epochs with 12 satellites each. Azimuth 90-180 is
+    // blocked by a building up to 30 deg: weak or lost signals there.
+    EpochColumns makeHistory(int epochs)
+    {
+        std::mt19937 rng(23);
+        std::uniform_real_distribution<double> elevation(0.0, 90.0);
+        std::uniform_real_distribution<double> azimuth(0.0, 360.0);
+        std::normal_distribution<double> snr(45.0, 2.0);
+
+        EpochColumns columns;
+        for (int k = 0; k < epochs; ++k)
+        {
+            GNSSData data;
+            for (int s = 1; s <= 12; ++s)
+            {
+                SATInfo info{elevation(rng), azimuth(rng), snr(rng)};
+                if (info.azimuth >= 90.0 && info.azimuth < 180.0 && info.elevation < 30.0)
+                    info.snr = (s % 2) ? -qInf() : 22.0;
+                data.satMap[s] = info;
+            }
+            data.satMap[13] = SATInfo{-qInf(), -qInf(), 30.0};  // angles unknown
+            QtAdapter::append(columns, data);
+        }
+        return columns;
+    }
+}
+
+class TestSkyHistogram : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_binning()
+    {
+        SkyHistogram h(1.0, 5.0);
+        QCOMPARE(h.elevationBins(), 90);
+        QCOMPARE(h.azimuthBins(), 72);
+
+        h.add(0.0, 0.0, 40.0);
+        h.add(0.5, 4.9, 42.0);
+        h.add(90.0, 360.0, 50.0);          // upper edges fold into the last bins
+        h.add(45.2, 181.0, -qInf());       // in view, not tracked
+        h.add(-qInf(), 10.0, 40.0);        // ignored
+        h.add(10.0, 400.0, 40.0);          // ignored
+
+        QCOMPARE(h.count(0, 0), uint64_t(2));
+        QCOMPARE(h.meanSnr(0, 0), 41.0);
+        QCOMPARE(h.count(89, 71), uint64_t(1));
+        QCOMPARE(h.count(45, 36), uint64_t(1));
+        QCOMPARE(h.tracked(45, 36), uint64_t(0));
+        QVERIFY(std::isnan(h.meanSnr(45, 36)));
+        QCOMPARE(h.totalCount(), uint64_t(4));
+
+        QVERIFY_EXCEPTION_THROWN(SkyHistogram(0.0, 5.0), std::invalid_argument);
+        QVERIFY_EXCEPTION_THROWN(h.merge(SkyHistogram(2.0, 5.0)), std::invalid_argument);
+    }
+
+    void test_parallelMatchesSequential()
+    {
+        const EpochColumns columns = makeHistory(20000);
+        SkyHistogram sequential;
+        sequential.add(columns, 0, columns.satelliteCount());
+        const SkyHistogram parallel = SkyHistogram::build(columns, 1.0, 5.0, 4);
+
+        QCOMPARE(parallel.totalCount(), uint64_t(20000 * 12));
+        for (int e = 0; e < sequential.elevationBins(); ++e)
+            for (int a = 0; a < sequential.azimuthBins(); ++a)
+            {
+                QCOMPARE(parallel.count(e, a), sequential.count(e, a));
+                QCOMPARE(parallel.tracked(e, a), sequential.tracked(e, a));
+                if (sequential.tracked(e, a) > 0)
+                    QVERIFY(std::fabs(parallel.meanSnr(e, a) - sequential.meanSnr(e, a)) < 1e-9);
+            }
+    }
+
+    void test_obstructionMask()
+    {
+        const SkyHistogram h = SkyHistogram::build(makeHistory(86400), 1.0, 5.0);
+        const std::vector<double> mask = h.obstructionMask(30.0, 10);
+        QCOMPARE(mask.size(), size_t(72));
+        for (int a = 0; a < 72; ++a)
+        {
+            if (a >= 18 && a < 36)
+                QCOMPARE(mask[a], 30.0);
+            else
+                QCOMPARE(mask[a], 0.0);
+        }
+    }
+
+    void bench_build()
+    {
+        const EpochColumns columns = makeHistory(86400 * 3);
+        QBENCHMARK {
+            SkyHistogram::build(columns);
+        }
+    }
+};
+
+QTEST_MAIN(TestSkyHistogram)
+#include "test_sky_histogram.moc"
@@ -0,0 +1,192 @@
+#include <QtTest>
+#include "SpatialIndex.hpp"
+#include "EpochColumns.hpp"
+#include "GNSSDataModel.hpp"
+#include "QtAdapter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+    struct Point {
+        uint32_t id;
+        double lat;
+        double lon;
+    };
+
+    // Half the points spread over the globe, half around a depot near the antimeridian
+    std::vector<Point> makePoints(size_t count)
+    {
+        std::mt19937 rng(31);
+        std::uniform_real_distribution<double> lat(-89.0, 89.0), lon(-180.0, 180.0);
+        std::normal_distribution<double> local(0.0, 0.2);
+        std::vector<Point> points(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i % 2)
+            {
+                points[i] = Point{uint32_t(i), lat(rng), lon(rng)};
+            }
+            else
+            {
+                double l = 179.9 + local(rng);
+                if (l > 180.0)
+                    l -= 360.0;
+                points[i] = Point{uint32_t(i), -17.5 + local(rng), l};
+            }
+        }
+        return points;
+    }
+
+    double haversine(double lat1, double lon1, double lat2, double lon2)
+    {
+        const double d2r = M_PI / 180.0;
+        const double a = std::pow(std::sin(0.5 * (lat2 - lat1) * d2r), 2)
+                       + std::cos(lat1 * d2r) * std::cos(lat2 * d2r) * std::pow(std::sin(0.5 * (lon2 - lon1) * d2r), 2);
+        return 2.0 * 6371008.8 * std::asin(std::min(1.0, std::sqrt(a)));
+    }
+
+    std::vector<uint32_t> sortedIds(const std::vector<SpatialHit> &hits)
+    {
+        std::vector<uint32_t> ids;
+        for (const SpatialHit &h : hits)
+            ids.push_back(h.id);
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+}
+
+class TestSpatialIndex : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void test_zOrderKey()
+    {
+        QCOMPARE(SpatialIndex::key(-90.0, -180.0), uint64_t(0));
+        QCOMPARE(SpatialIndex::key(90.0, 180.0), ~uint64_t(0));
+        // Longitude on even bits, latitude on odd bits
+        QCOMPARE(SpatialIndex::key(-90.0, 0.0), uint64_t(1) << 62);
+        QCOMPARE(SpatialIndex::key(0.0, -180.0), uint64_t(1) << 63);
+    }
+
+    void test_queriesMatchBruteForce()
+    {
+        const std::vector<Point> points = makePoints(20000);
+        SpatialIndex index(SpatialIndex::Mode::History, 1000);
+        for (const Point &p : points)
+            index.insert(p.id, p.lat, p.lon, 0);     // leaves part of them in the pending buffer
+        QCOMPARE(index.size(), points.size());
+
+        std::vector<SpatialHit> hits;
+        struct Box { double minLat, minLon, maxLat, maxLon; };
+        for (const Box &b : {Box{-18.0, 179.5, -17.0, -179.7}, Box{10.0, 20.0, 30.0, 60.0},
+                             Box{-90.0, -180.0, 90.0, 180.0}, Box{-17.6, 179.8, -17.5, 179.9}})
+        {
+            std::vector<uint32_t> expected;
+            for (const Point &p : points)
+            {
+                const bool lonIn = b.minLon <= b.maxLon ? (p.lon >= b.minLon && p.lon <= b.maxLon)
+                                                        : (p.lon >= b.minLon || p.lon <= b.maxLon);
+                if (p.lat >= b.minLat && p.lat <= b.maxLat && lonIn)
+                    expected.push_back(p.id);
+            }
+            index.boundingBox(b.minLat, b.minLon, b.maxLat, b.maxLon, hits);
+            QCOMPARE(sortedIds(hits), expected);
+        }
+
+        for (double r : {500.0, 20000.0, 3.0e6})
+        {
+            std::vector<uint32_t> expected;
+            for (const Point &p : points)
+                if (haversine(-17.5, 179.95, p.lat, p.lon) <= r)
+                    expected.push_back(p.id);
+            index.radius(-17.5, 179.95, r, hits);
+            QCOMPARE(sortedIds(hits), expected);
+            QVERIFY(std::is_sorted(hits.begin(), hits.end(),
+                                   [](const SpatialHit &a, const SpatialHit &b) { return a.distance < b.distance; }));
+        }
+
+        // Near the pole the search covers every longitude
+        index.radius(88.5, 0.0, 400000.0, hits);
+        size_t polar = 0;
+        for (const Point &p : points)
+            polar += haversine(88.5, 0.0, p.lat, p.lon) <= 400000.0;
+        QCOMPARE(hits.size(), polar);
+
+        for (size_t k : {1, 10, 500})
+        {
+            std::vector<double> distances;
+            for (const Point &p : points)
+                distances.push_back(haversine(40.0, -100.0, p.lat, p.lon));
+            std::sort(distances.begin(), distances.end());
+            QCOMPARE(index.nearest(40.0, -100.0, k, hits), k);
+            for (size_t i = 0; i < k; ++i)
+                QVERIFY(std::fabs(hits[i].distance - distances[i]) < 1e-6);
+        }
+    }
+
+    void test_latestMode()
+    {
+        SpatialIndex index(SpatialIndex::Mode::Latest, 4);
+        std::vector<SpatialHit> hits;
+        for (uint32_t id = 0; id < 10; ++id)
+            index.insert(id, 45.0, 5.0 + id * 0.01, 1000);
+        QCOMPARE(index.size(), size_t(10));
+
+        index.insert(3, 46.0, 6.0, 2000);       // moves
+        index.insert(4, 46.0, 6.0, 500);        // stale, ignored
+        index.insert(9, 46.0, 6.001, 3000);     // still pending
+        QCOMPARE(index.size(), size_t(10));
+        QCOMPARE(index.radius(46.0, 6.0, 1000.0, hits), size_t(2));
+        QCOMPARE(sortedIds(hits), (std::vector<uint32_t>{3, 9}));
+        QCOMPARE(hits[0].timeMs, int64_t(2000));
+
+        index.flush();
+        QCOMPARE(index.size(), size_t(10));
+        QCOMPARE(index.boundingBox(44.9, 4.9, 45.1, 5.2, hits), size_t(8));
+    }
+
+    void test_bulkLoadColumns()
+    {
+        EpochColumns columns;
+        GNSSData data;
+        for (int i = 0; i < 100; ++i)
+        {
+            data.latitude = 45.0 + i * 1e-4;
+            data.longitude = 5.0;
+            data.fixType = (i == 99) ? "No Fix" : "GPS Fix";
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(1000LL * i, Qt::UTC);
+            QtAdapter::append(columns, data);
+        }
+
+        SpatialIndex history;
+        history.insert(7, columns);
+        QCOMPARE(history.size(), size_t(99));
+
+        SpatialIndex latest(SpatialIndex::Mode::Latest);
+        latest.insert(7, columns);
+        latest.insert(8, columns);
+        std::vector<SpatialHit> hits;
+        QCOMPARE(latest.nearest(45.0, 5.0, 5, hits), size_t(2));
+        QCOMPARE(hits[0].timeMs, int64_t(98000));
+    }
+
+    void bench_radiusQuery()
+    {
+        const std::vector<Point> points = makePoints(2000000);
+        SpatialIndex index(SpatialIndex::Mode::History, points.size());
+        for (const Point &p : points)
+            index.insert(p.id, p.lat, p.lon, 0);
+        index.flush();
+        std::vector<SpatialHit> hits;
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i)
+                index.radius(-17.5, 179.9 - (i % 100) * 1e-3, 200.0, hits);
+        }
+    }
+};
+
+QTEST_MAIN(TestSpatialIndex)
+#include "test_spatial_index.moc"